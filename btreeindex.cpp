@@ -0,0 +1,415 @@
+#include <string>
+#include <cstring>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include "swatdb_types.h"
+#include "btreeindex.h"
+#include "recordlayout.h"
+#include "record.h"
+#include "data.h"
+#include "heapfile.h"
+#include "heapfilescanner.h"
+
+/*
+ * Header at the start of every node page. Leaves then hold leaf_cap keys
+ * followed by leaf_cap RecordIds; internal nodes hold inner_cap keys
+ * followed by inner_cap + 1 child page numbers. Key i of an internal node
+ * is the smallest key under child i + 1.
+ */
+struct BTreeNodeHeader {
+  std::uint32_t is_leaf;
+  std::uint32_t num_keys;
+  std::uint32_t next;
+};
+
+static const std::uint32_t HEADER_SIZE = sizeof(BTreeNodeHeader);
+
+/*
+ * Number of node frames an index on disk reads its nodes into: enough for
+ * a descent from the root and the leaves a scan walks, which are replaced
+ * in turn.
+ */
+static const std::uint32_t NODE_FRAMES = 16;
+
+/**
+ * @brief Constructor for an empty BTreeIndex. Works out how many entries
+ *    fit in a leaf page and how many keys fit in an internal page.
+ *
+ * @param schema. Schema * of the relation.
+ * @param fid. FieldId of the field the index is on.
+ */
+BTreeIndex::BTreeIndex(Schema *schema, FieldId fid) {
+  this->schema = schema;
+  RecordLayout layout(schema);
+  this->field = layout.getField(fid);
+  this->leaf_cap = ( PAGE_SIZE - HEADER_SIZE ) / 
+    ( this->field.size + sizeof(RecordId) );
+  this->inner_cap = ( PAGE_SIZE - HEADER_SIZE - sizeof(std::uint32_t) ) / 
+    ( this->field.size + sizeof(std::uint32_t) );
+  this->root = BTREE_NO_PAGE;
+  this->first_leaf = BTREE_NO_PAGE;
+  this->height = 0;
+  this->num_recs = 0;
+  this->node_offset = 0;
+  this->next_frame = 0;
+}
+
+/**
+ * @brief Destructor for BTreeIndex.
+ */
+BTreeIndex::~BTreeIndex() {
+}
+
+/**
+ * @brief Bulk builds the index from scratch with a scan of the relation.
+ *    The entries are sorted by key (ties in RecordId order) and packed into
+ *    full leaves, then each level of internal nodes is built over the one
+ *    below until a single root is left.
+ *
+ * @param file. HeapFile * of the relation.
+ */
+void BTreeIndex::build(HeapFile *file) {
+
+  // entry offsets are computed in std::size_t so large relations do not
+  // overflow 32 bits
+  std::size_t ksize = this->field.size;
+  std::vector<char> keys;
+  std::vector<RecordId> rids;
+
+  // collect every (key, rid) entry of the relation
+  HeapFileScanner* scanner = new HeapFileScanner(file);
+  Record *record = new Record(this->schema);
+  const char *bytes = RecordLayout::getBytes(record);
+  while( true ){
+    RecordId rid = scanner->getNext(record);
+    if( rid == INVALID_RECORD_ID ) break;
+    keys.insert(keys.end(), bytes + this->field.offset,
+        bytes + this->field.offset + ksize);
+    rids.push_back(rid);
+  }
+  delete record->getRecordData();
+  delete record;
+  delete scanner;
+
+  std::vector<std::size_t> perm(rids.size());
+  for( std::size_t i = 0; i < perm.size(); i++ ) perm[i] = i;
+  const FieldLayout &field = this->field;
+  std::stable_sort(perm.begin(), perm.end(),
+      [&](std::size_t a, std::size_t b){
+        return RecordLayout::compareFieldValues(field, &keys[a * ksize],
+            &keys[b * ksize]) < 0;
+      });
+
+  this->node_file.close();
+  this->pages.clear();
+  this->num_recs = rids.size();
+  this->height = 1;
+
+  // pack the leaves, remembering each node's smallest entry
+  std::vector<std::uint32_t> level;
+  std::vector<std::size_t> level_min;
+  std::uint32_t prev = BTREE_NO_PAGE;
+  std::size_t e = 0;
+  do {
+    std::uint32_t page = this->_newNode(true);
+    std::uint32_t n = std::min<std::size_t>(this->leaf_cap, 
+        perm.size() - e);
+    char *node = this->_page(page);
+    char *node_keys = node + HEADER_SIZE;
+    char *node_rids = node_keys + this->leaf_cap * ksize;
+    for( std::uint32_t i = 0; i < n; i++ ){
+      memcpy(node_keys + i * ksize, &keys[perm[e + i] * ksize], ksize);
+      memcpy(node_rids + i * sizeof(RecordId), &rids[perm[e + i]],
+          sizeof(RecordId));
+    }
+    ((BTreeNodeHeader *)node)->num_keys = n;
+    if( prev != BTREE_NO_PAGE ){
+      ((BTreeNodeHeader *)this->_page(prev))->next = page;
+    }
+    level.push_back(page);
+    level_min.push_back(n > 0 ? perm[e] : 0);
+    prev = page;
+    e += n;
+  } while( e < perm.size() );
+  this->first_leaf = level[0];
+
+  // build internal levels until one node is left
+  while( level.size() > 1 ){
+    std::vector<std::uint32_t> up;
+    std::vector<std::size_t> up_min;
+    for( std::uint32_t j = 0; j < level.size(); j += this->inner_cap + 1 ){
+      std::uint32_t page = this->_newNode(false);
+      std::uint32_t n = std::min<std::uint32_t>(this->inner_cap + 1,
+          level.size() - j);
+      char *node = this->_page(page);
+      char *node_keys = node + HEADER_SIZE;
+      char *node_children = node_keys + this->inner_cap * ksize;
+      for( std::uint32_t i = 0; i < n; i++ ){
+        memcpy(node_children + i * sizeof(std::uint32_t), &level[j + i],
+            sizeof(std::uint32_t));
+        if( i > 0 ){
+          memcpy(node_keys + ( i - 1 ) * ksize, 
+              &keys[level_min[j + i] * ksize], ksize);
+        }
+      }
+      ((BTreeNodeHeader *)node)->num_keys = n - 1;
+      up.push_back(page);
+      up_min.push_back(level_min[j]);
+    }
+    level.swap(up);
+    level_min.swap(up_min);
+    this->height++;
+  }
+  this->root = level[0];
+}
+
+/**
+ * @brief Returns the FieldId the index is on.
+ */
+FieldId BTreeIndex::getFieldId() {
+  return this->field.fid;
+}
+
+/**
+ * @brief Returns the layout of the field the index is on.
+ */
+const FieldLayout &BTreeIndex::getField() {
+  return this->field;
+}
+
+/**
+ * @brief Returns the number of entries in the index.
+ */
+std::uint64_t BTreeIndex::getNumRecs() {
+  return this->num_recs;
+}
+
+/**
+ * @brief Returns the number of levels in the tree, 1 for a single leaf.
+ */
+std::uint32_t BTreeIndex::getHeight() {
+  return this->height;
+}
+
+/**
+ * @brief Returns the position of the first entry of the index.
+ */
+BTreePos BTreeIndex::begin() {
+  BTreePos pos = {this->first_leaf, 0};
+  this->_skipEmpty(pos);
+  return pos;
+}
+
+/**
+ * @brief Returns the position of the first entry whose key is greater than
+ *    or equal to key (inclusive) or greater than key (not inclusive). Each
+ *    internal node is descended into the child after the last separator
+ *    below the bound; since equal keys can end the child before it, the
+ *    entry found may be the first of the next leaf.
+ *
+ * @param key. Pointer to the key value.
+ * @param inclusive. True to include entries equal to key.
+ */
+BTreePos BTreeIndex::seek(const char *key, bool inclusive) {
+  BTreePos pos = {BTREE_NO_PAGE, 0};
+  if( this->root == BTREE_NO_PAGE ) return pos;
+
+  std::uint32_t page = this->root;
+  while( !((BTreeNodeHeader *)this->_page(page))->is_leaf ){
+    std::uint32_t c = this->_searchNode(page, key, inclusive);
+    const char *children = this->_page(page) + HEADER_SIZE + 
+      this->inner_cap * this->field.size;
+    memcpy(&page, children + c * sizeof(std::uint32_t), sizeof(page));
+  }
+  pos.page = page;
+  pos.slot = this->_searchNode(page, key, inclusive);
+  this->_skipEmpty(pos);
+  return pos;
+}
+
+/**
+ * @brief Returns true if pos is past the last entry.
+ */
+bool BTreeIndex::isEnd(const BTreePos &pos) {
+  return pos.page == BTREE_NO_PAGE;
+}
+
+/**
+ * @brief Returns a pointer to the key of the entry at pos. It is valid
+ *    until the index moves to another node.
+ *
+ * @pre pos is not past the last entry.
+ */
+const char *BTreeIndex::getKey(const BTreePos &pos) {
+  return this->_page(pos.page) + HEADER_SIZE + pos.slot * this->field.size;
+}
+
+/**
+ * @brief Returns the RecordId of the entry at pos.
+ *
+ * @pre pos is not past the last entry.
+ */
+RecordId BTreeIndex::getRecordId(const BTreePos &pos) {
+  RecordId rid;
+  const char *node_rids = this->_page(pos.page) + HEADER_SIZE + 
+    this->leaf_cap * this->field.size;
+  memcpy(&rid, node_rids + pos.slot * sizeof(RecordId), sizeof(RecordId));
+  return rid;
+}
+
+/**
+ * @brief Moves pos to the next entry, following the leaf links.
+ *
+ * @param pos. BTreePos to move.
+ */
+void BTreeIndex::next(BTreePos &pos) {
+  pos.slot++;
+  this->_skipEmpty(pos);
+}
+
+/**
+ * @brief Writes the index to a file: the field id, key size, entry count,
+ *    root, first leaf, height and page count, then every page. The
+ *    in-memory nodes are then dropped, and the index reads them back from
+ *    the file on demand.
+ *
+ * @param path. Path of the index file.
+ */
+void BTreeIndex::save(std::string path) {
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  std::uint32_t num_pages = this->pages.size() / PAGE_SIZE;
+  out.write((const char *)&this->field.fid, sizeof(this->field.fid));
+  out.write((const char *)&this->field.size, sizeof(this->field.size));
+  out.write((const char *)&this->num_recs, sizeof(this->num_recs));
+  out.write((const char *)&this->root, sizeof(this->root));
+  out.write((const char *)&this->first_leaf, sizeof(this->first_leaf));
+  out.write((const char *)&this->height, sizeof(this->height));
+  out.write((const char *)&num_pages, sizeof(num_pages));
+  out.write(this->pages.data(), this->pages.size());
+  out.close();
+  this->load(path);
+}
+
+/**
+ * @brief Opens an index file written by save, replacing the current
+ *    contents. Only the header is read, and the file is kept open for the
+ *    nodes to be read from on demand.
+ *
+ * @param path. Path of the index file.
+ *
+ * @return False if the file does not exist, is short, or was written for
+ *    another field or key size, True if the index was loaded.
+ */
+bool BTreeIndex::load(std::string path) {
+
+  std::ifstream in(path, std::ios::binary);
+  FieldId fid;
+  std::uint32_t ksize, num_pages;
+  if( !in.read((char *)&fid, sizeof(fid)) ) return false;
+  in.read((char *)&ksize, sizeof(ksize));
+  if( fid != this->field.fid || ksize != this->field.size ) return false;
+  in.read((char *)&this->num_recs, sizeof(this->num_recs));
+  in.read((char *)&this->root, sizeof(this->root));
+  in.read((char *)&this->first_leaf, sizeof(this->first_leaf));
+  in.read((char *)&this->height, sizeof(this->height));
+  in.read((char *)&num_pages, sizeof(num_pages));
+  if( !in ) return false;
+  std::uint64_t offset = in.tellg();
+  in.seekg(0, std::ios::end);
+  if( (std::uint64_t)in.tellg() < 
+      offset + (std::uint64_t)num_pages * PAGE_SIZE ){
+    return false;
+  }
+
+  std::vector<char>().swap(this->pages);
+  this->node_file.close();
+  this->node_file.open(path, std::ios::binary);
+  this->node_offset = offset;
+  this->frames.resize((std::size_t)NODE_FRAMES * PAGE_SIZE);
+  this->frame_pages.assign(NODE_FRAMES, BTREE_NO_PAGE);
+  this->next_frame = 0;
+  return this->node_file.is_open();
+}
+
+/**
+ * @brief Returns a pointer to the start of a page of the index. An index
+ *    on disk looks for the page in its node frames and otherwise reads it
+ *    from the index file into the next frame in turn.
+ */
+char *BTreeIndex::_page(std::uint32_t page) {
+
+  if( !this->node_file.is_open() ){
+    return &this->pages[(std::size_t)page * PAGE_SIZE];
+  }
+  for( std::uint32_t f = 0; f < NODE_FRAMES; f++ ){
+    if( this->frame_pages[f] == page ){
+      return &this->frames[(std::size_t)f * PAGE_SIZE];
+    }
+  }
+  std::uint32_t f = this->next_frame;
+  this->next_frame = ( f + 1 ) % NODE_FRAMES;
+  char *frame = &this->frames[(std::size_t)f * PAGE_SIZE];
+  this->node_file.clear();
+  this->node_file.seekg(this->node_offset + (std::uint64_t)page * PAGE_SIZE);
+  this->node_file.read(frame, PAGE_SIZE);
+  this->frame_pages[f] = page;
+  return frame;
+}
+
+/**
+ * @brief Appends an empty node page and returns its page number. Pointers
+ *    to pages are invalidated.
+ *
+ * @param is_leaf. True for a leaf node.
+ */
+std::uint32_t BTreeIndex::_newNode(bool is_leaf) {
+  std::uint32_t page = this->pages.size() / PAGE_SIZE;
+  this->pages.resize(this->pages.size() + PAGE_SIZE, 0);
+  BTreeNodeHeader *header = (BTreeNodeHeader *)this->_page(page);
+  header->is_leaf = is_leaf;
+  header->num_keys = 0;
+  header->next = BTREE_NO_PAGE;
+  return page;
+}
+
+/**
+ * @brief Binary searches the keys of a node. For an internal node the
+ *    result is also the child to descend into.
+ *
+ * @return The position of the first key greater than or equal to key
+ *    (inclusive), or greater than key (not inclusive).
+ */
+std::uint32_t BTreeIndex::_searchNode(std::uint32_t page, const char *key,
+    bool inclusive) {
+
+  const char *node = this->_page(page);
+  const char *node_keys = node + HEADER_SIZE;
+  std::uint32_t lo = 0;
+  std::uint32_t hi = ((const BTreeNodeHeader *)node)->num_keys;
+  while( lo < hi ){
+    std::uint32_t mid = lo + ( hi - lo ) / 2;
+    int cmp = RecordLayout::compareFieldValues(this->field,
+        node_keys + mid * this->field.size, key);
+    if( cmp < 0 || ( !inclusive && cmp == 0 ) ){
+      lo = mid + 1;
+    }
+    else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/**
+ * @brief Moves pos to the first entry of the next non-empty leaf if it is
+ *    past the end of its leaf.
+ */
+void BTreeIndex::_skipEmpty(BTreePos &pos) {
+  while( pos.page != BTREE_NO_PAGE && 
+      pos.slot >= ((BTreeNodeHeader *)this->_page(pos.page))->num_keys ){
+    pos.page = ((BTreeNodeHeader *)this->_page(pos.page))->next;
+    pos.slot = 0;
+  }
+}
@@ -0,0 +1,248 @@
+#ifndef _SWATDB_BTREEINDEX_H_
+#define _SWATDB_BTREEINDEX_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include "swatdb_types.h"
+#include "recordlayout.h"
+
+class Schema;
+class HeapFile;
+
+/**
+ * Struct for a position in the leaf level of a BTreeIndex: the node's
+ * page number in the index and the entry within it.
+ */
+struct BTreePos {
+  /**
+   * Page number of the leaf node, BTREE_NO_PAGE past the last entry
+   */
+  std::uint32_t page;
+  /**
+   * Position of the entry in the leaf
+   */
+  std::uint32_t slot;
+};
+
+/**
+ * Page number used for "no page": the next pointer of the last leaf and
+ * the position past the last entry.
+ */
+static const std::uint32_t BTREE_NO_PAGE = 0xffffffff;
+
+/**
+ * BTreeIndex is an ordered B+-tree index on one field of a relation. Every
+ * node is a PAGE_SIZE page: leaves hold sorted (key, RecordId) entries and
+ * are linked left to right, and internal nodes hold the first key of each
+ * child after the first. The tree is bulk built bottom up from a scan of
+ * the relation with every node packed full, and saved as a file of its
+ * pages next to the relation. A range select seeks to its lower bound and
+ * walks the leaves until its upper bound.
+ *
+ * A built index keeps its nodes in memory until it is saved. A saved or
+ * loaded index reads its nodes from the file on demand into a few node
+ * frames of its own, so only the nodes a scan is on are in memory. The
+ * nodes are not pages of the BufferManager, whose API has no way to map
+ * a side file. The index is not updated in place; RelOpsManager drops it
+ * when the relation is modified, and it is rebuilt with buildOrderedIndex.
+ */
+class BTreeIndex {
+
+  public:
+
+    /**
+     * @brief Constructor for an empty BTreeIndex.
+     *
+     * @param schema. Schema * of the relation.
+     * @param fid. FieldId of the field the index is on.
+     */
+    BTreeIndex(Schema *schema, FieldId fid);
+
+    /**
+     * @brief Destructor for BTreeIndex.
+     */
+    ~BTreeIndex();
+
+    /**
+     * @brief Bulk builds the index from scratch with a scan of the
+     *    relation. The entries are sorted by key and packed into full
+     *    leaves, then each level of internal nodes is built over the one
+     *    below until a single root is left.
+     *
+     * @param file. HeapFile * of the relation.
+     */
+    void build(HeapFile *file);
+
+    /**
+     * @brief Returns the FieldId the index is on.
+     */
+    FieldId getFieldId();
+
+    /**
+     * @brief Returns the layout of the field the index is on.
+     */
+    const FieldLayout &getField();
+
+    /**
+     * @brief Returns the number of entries in the index. If it differs from
+     *    the relation's record count the index is stale.
+     */
+    std::uint64_t getNumRecs();
+
+    /**
+     * @brief Returns the number of levels in the tree, 1 for a single leaf.
+     */
+    std::uint32_t getHeight();
+
+    /**
+     * @brief Returns the position of the first entry of the index.
+     */
+    BTreePos begin();
+
+    /**
+     * @brief Returns the position of the first entry whose key is greater
+     *    than or equal to key (inclusive) or greater than key (not
+     *    inclusive).
+     *
+     * @param key. Pointer to the key value.
+     * @param inclusive. True to include entries equal to key.
+     */
+    BTreePos seek(const char *key, bool inclusive);
+
+    /**
+     * @brief Returns true if pos is past the last entry.
+     */
+    bool isEnd(const BTreePos &pos);
+
+    /**
+     * @brief Returns a pointer to the key of the entry at pos. It is valid
+     *    until the index moves to another node.
+     *
+     * @pre pos is not past the last entry.
+     */
+    const char *getKey(const BTreePos &pos);
+
+    /**
+     * @brief Returns the RecordId of the entry at pos.
+     *
+     * @pre pos is not past the last entry.
+     */
+    RecordId getRecordId(const BTreePos &pos);
+
+    /**
+     * @brief Moves pos to the next entry, following the leaf links.
+     *
+     * @param pos. BTreePos to move.
+     */
+    void next(BTreePos &pos);
+
+    /**
+     * @brief Writes the index to a file: a header, then every page. The
+     *    in-memory nodes are then dropped and read from the file on demand.
+     *
+     * @pre The index was built and not saved since.
+     *
+     * @param path. Path of the index file.
+     */
+    void save(std::string path);
+
+    /**
+     * @brief Opens an index file written by save, replacing the current
+     *    contents. Only the header is read; nodes are read on demand.
+     *
+     * @param path. Path of the index file.
+     *
+     * @return False if the file does not exist or was written for another
+     *    field or key size, True if the index was loaded.
+     */
+    bool load(std::string path);
+
+  private:
+
+    /**
+     * @brief Returns a pointer to the start of a page of the index,
+     *    reading it into a node frame if the index is on disk.
+     */
+    char *_page(std::uint32_t page);
+
+    /**
+     * @brief Appends an empty node page and returns its page number.
+     *
+     * @param is_leaf. True for a leaf node.
+     */
+    std::uint32_t _newNode(bool is_leaf);
+
+    /**
+     * @brief Returns the position in a node of the first key greater than
+     *    or equal to key (inclusive), or greater than key (not inclusive).
+     *    For an internal node this is also the child to descend into.
+     */
+    std::uint32_t _searchNode(std::uint32_t page, const char *key,
+        bool inclusive);
+
+    /**
+     * @brief Moves pos to the first entry of the next leaf if it is past
+     *    the end of its leaf.
+     */
+    void _skipEmpty(BTreePos &pos);
+
+    /**
+     * Schema of the relation
+     */
+    Schema *schema;
+
+    /**
+     * Layout of the field the index is on
+     */
+    FieldLayout field;
+
+    /**
+     * Number of entries that fit in a leaf and keys in an internal node
+     */
+    std::uint32_t leaf_cap;
+    std::uint32_t inner_cap;
+
+    /**
+     * The node pages, PAGE_SIZE bytes each, while the index is in memory
+     */
+    std::vector<char> pages;
+
+    /**
+     * Index file nodes are read from once the index is saved or loaded,
+     * and the offset of its first node
+     */
+    std::ifstream node_file;
+    std::uint64_t node_offset;
+
+    /**
+     * Node frames of an index on disk, PAGE_SIZE bytes each, the page
+     * number in each frame, and the next frame to replace
+     */
+    std::vector<char> frames;
+    std::vector<std::uint32_t> frame_pages;
+    std::uint32_t next_frame;
+
+    /**
+     * Page number of the root and of the leftmost leaf
+     */
+    std::uint32_t root;
+    std::uint32_t first_leaf;
+
+    /**
+     * Number of levels in the tree
+     */
+    std::uint32_t height;
+
+    /**
+     * Number of entries in the index
+     */
+    std::uint64_t num_recs;
+
+};
+
+#endif
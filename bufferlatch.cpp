@@ -0,0 +1,4 @@
+#include <mutex>
+#include "bufferlatch.h"
+
+std::mutex buffer_latch;
@@ -0,0 +1,19 @@
+#ifndef _SWATDB_BUFFERLATCH_H_
+#define _SWATDB_BUFFERLATCH_H_
+
+/**
+ * \file
+ */
+
+#include <mutex>
+
+/**
+ * Latch held around every call into the BufferManager, and into the heap
+ * files built on it, made by operators that run on several threads. The
+ * BufferManager keeps no locks of its own, so pinning, releasing and
+ * inserting must not overlap. The bytes of a page that is already pinned
+ * are read without it.
+ */
+extern std::mutex buffer_latch;
+
+#endif
@@ -0,0 +1,288 @@
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include "swatdb_types.h"
+#include "distinctproject.h"
+#include "project.h"
+#include "operation.h"
+#include "catalog.h"
+#include "heapfilescanner.h"
+#include "record.h"
+#include "heapfile.h"
+#include "resultwriter.h"
+#include "recordlayout.h"
+
+/*
+ * Number of partitions a full table spills to, and the number of hash bits
+ * that pick one. The partition is taken from the top bits of the hash and
+ * the slot from the bottom bits, so the tuples of one partition still
+ * spread over the whole table.
+ */
+static const std::uint32_t PARTITION_BITS = 4;
+static const std::uint32_t NUM_PARTITIONS = 1 << PARTITION_BITS;
+
+/*
+ * Deepest level that spills. A partition at this level is deduplicated in
+ * a table that grows past the budget, which only happens if a great many
+ * copies of few tuples end up in one partition.
+ */
+static const std::uint32_t MAX_DEPTH = 6;
+
+/*
+ * Bytes of the table each tuple costs besides its own: two slots.
+ */
+static const std::uint32_t SLOT_OVERHEAD = 2 * sizeof(std::uint32_t);
+
+/**
+ * @brief Constructor for DistinctProject operation. The table's capacity
+ *    is the number of tuples and their slots that fit in buffer_pages
+ *    pages, and all of its space is allocated up front.
+ *
+ * @param rel_id. FileId of the relation file.
+ * @param result_id. FileId of the result file.
+ * @param fields. Vector of field ids for the project operation.
+ * @param buffer_pages. Number of pages of memory the hash table may use.
+ * @param catalog. pointer to the catalog of SwatDB
+ *
+ * @pre rel_id is the name of a valid file.
+ * @post private variables have been set accordingly.
+ */
+DistinctProject::DistinctProject(FileId rel_id, FileId result_id,
+    std::vector<FieldId> fields, std::uint32_t buffer_pages,
+    Catalog *catalog) : Project(rel_id, result_id, fields, catalog) {
+
+  this->tuple_size = this->result_layout->getRecordSize();
+  std::uint64_t budget = (std::uint64_t)buffer_pages * PAGE_SIZE;
+  std::uint64_t cap = budget / (this->tuple_size + SLOT_OVERHEAD);
+  this->budget_capacity = cap > 0 ? cap : 1;
+  this->capacity = this->budget_capacity;
+  this->num_entries = 0;
+  this->num_spilled = 0;
+  this->num_partitions = 0;
+  this->max_depth = 0;
+
+  std::uint32_t num_slots = 2;
+  while( num_slots < 2 * this->capacity ) num_slots <<= 1;
+  this->arena.resize((std::uint64_t)this->capacity * this->tuple_size);
+  this->slots.resize(num_slots, 0);
+  this->tuple.resize(this->tuple_size);
+}
+
+/**
+ * @brief Destructor for the DistinctProject Operation.
+ */
+DistinctProject::~DistinctProject(){
+}
+
+/**
+ * @brief Runs the operation. The projected tuple of each scanned record is
+ *    built in scratch space and added to the table; the partitions spilled
+ *    on the way are deduplicated once the scan is done.
+ *
+ * @pre Valid files and parameters have been passed to the contructor.
+ * @post Result file holds each distinct projected tuple of the relation
+ *    exactly once.
+ */
+void DistinctProject::runOperation() {
+
+  HeapFile* file = (HeapFile *)this->file_state.file;
+  HeapFileScanner* scanner = new HeapFileScanner(file);
+  Record *record = this->file_state.rec;
+  const char *src = RecordLayout::getBytes(record);
+  char *dest = this->tuple.data();
+  std::vector<FILE *> spills;
+
+  while( true ){
+    RecordId rid = scanner->getNext(record);
+    if( rid == INVALID_RECORD_ID ) break;
+    this->_copyFields(dest, src);
+    this->_add(dest, 0, spills);
+  }
+  delete scanner;
+
+  this->_dedupePartitions(spills, 1);
+}
+
+/**
+ * @brief Returns the number of tuples written to partition files, over all
+ *    levels of recursion.
+ */
+std::uint64_t DistinctProject::getNumSpilled() {
+  return this->num_spilled;
+}
+
+/**
+ * @brief Returns the number of partition files created.
+ */
+std::uint32_t DistinctProject::getNumPartitions() {
+  return this->num_partitions;
+}
+
+/**
+ * @brief Returns the deepest level of recursion reached, 0 if nothing was
+ *    spilled.
+ */
+std::uint32_t DistinctProject::getMaxDepth() {
+  return this->max_depth;
+}
+
+/**
+ * @brief Adds one tuple: writes it to the result if it is new and the table
+ *    has room, drops it if it is already in the table, and spills it to a
+ *    partition otherwise. Once the table is full it no longer changes, so a
+ *    spilled tuple is never one that was written to the result, and every
+ *    copy of it lands in the same partition.
+ *
+ * @param tuple. Raw bytes of a tuple with the result's schema.
+ * @param level. Recursion level, used to seed the hash.
+ * @param spills. Partition files of this level, created on the first
+ *    spill.
+ */
+void DistinctProject::_add(const char *tuple, std::uint32_t level,
+    std::vector<FILE *> &spills) {
+
+  std::uint64_t hash = this->_hash(tuple, level);
+  std::uint32_t mask = this->slots.size() - 1;
+  std::uint32_t slot = hash & mask;
+
+  while( this->slots[slot] != 0 ){
+    const char *entry =
+      &this->arena[(std::uint64_t)(this->slots[slot] - 1) * this->tuple_size];
+    if( this->_equal(entry, tuple) ) return;
+    slot = (slot + 1) & mask;
+  }
+
+  if( this->num_entries == this->capacity && level < MAX_DEPTH ){
+    if( spills.empty() ){
+      for( std::uint32_t p = 0; p < NUM_PARTITIONS; p++ ){
+        FILE *part = std::tmpfile();
+        if( part == nullptr ) break;
+        spills.push_back(part);
+      }
+      this->num_partitions += spills.size();
+    }
+    if( spills.size() == NUM_PARTITIONS ){
+      FILE *part = spills[hash >> (64 - PARTITION_BITS)];
+      fwrite(tuple, this->tuple_size, 1, part);
+      this->num_spilled++;
+      return;
+    }
+    // could not open the partition files: keep everything in memory
+  }
+
+  if( this->num_entries == this->capacity ){
+    this->_grow(level);
+    mask = this->slots.size() - 1;
+    slot = hash & mask;
+    while( this->slots[slot] != 0 ) slot = (slot + 1) & mask;
+  }
+  memcpy(&this->arena[(std::uint64_t)this->num_entries * this->tuple_size],
+      tuple, this->tuple_size);
+  this->num_entries++;
+  this->slots[slot] = this->num_entries;
+  this->result_writer->append(tuple);
+}
+
+/**
+ * @brief Deduplicates the tuples of each partition file, recursing on the
+ *    partitions each one spills before moving on to the next, and closes
+ *    the files. Each partition starts with an empty table.
+ *
+ * @param parts. Partition files written at level - 1.
+ * @param level. Recursion level of the partitions.
+ */
+void DistinctProject::_dedupePartitions(std::vector<FILE *> &parts,
+    std::uint32_t level) {
+
+  for( FILE *part : parts ){
+    if( level > this->max_depth ) this->max_depth = level;
+    this->_clearTable();
+    std::vector<FILE *> spills;
+    rewind(part);
+    while( fread(this->tuple.data(), this->tuple_size, 1, part) == 1 ){
+      this->_add(this->tuple.data(), level, spills);
+    }
+    fclose(part);
+    this->_dedupePartitions(spills, level + 1);
+  }
+  parts.clear();
+}
+
+/**
+ * @brief Returns the hash of a tuple's normalized field values, mixed with
+ *    a seed for level so each level splits tuples differently. Values are
+ *    normalized so that tuples _equal finds equal hash the same.
+ */
+std::uint64_t DistinctProject::_hash(const char *tuple, std::uint32_t level) {
+
+  std::uint64_t hash = 0x9e3779b97f4a7c15ULL * (level + 1);
+  for( FieldId i = 0; i < this->result_layout->getNumFields(); i++ ){
+    const FieldLayout &field = this->result_layout->getField(i);
+    RecordLayout::normalizeValue(field, tuple + field.offset, this->norm);
+    hash ^= std::hash<std::string>{}(this->norm) + 0x9e3779b97f4a7c15ULL
+      + (hash << 6) + (hash >> 2);
+  }
+  // finalize so the top bits used for partitions are well mixed
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+/**
+ * @brief Returns true if every field of the two tuples compares equal.
+ */
+bool DistinctProject::_equal(const char *a, const char *b) {
+
+  for( FieldId i = 0; i < this->result_layout->getNumFields(); i++ ){
+    const FieldLayout &field = this->result_layout->getField(i);
+    if( RecordLayout::compareFieldValues(field, a + field.offset,
+          b + field.offset) != 0 ){
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Empties the hash table, shrinking it back to the budget if it was
+ *    grown.
+ */
+void DistinctProject::_clearTable() {
+
+  this->num_entries = 0;
+  if( this->capacity != this->budget_capacity ){
+    std::uint32_t num_slots = 2;
+    while( num_slots < 2 * this->budget_capacity ) num_slots <<= 1;
+    this->capacity = this->budget_capacity;
+    this->arena.resize((std::uint64_t)this->capacity * this->tuple_size);
+    this->arena.shrink_to_fit();
+    this->slots.assign(num_slots, 0);
+    this->slots.shrink_to_fit();
+    return;
+  }
+  std::fill(this->slots.begin(), this->slots.end(), 0);
+}
+
+/**
+ * @brief Doubles the table's capacity and rehashes its tuples. Only used
+ *    past the last level of recursion, where spilling stops.
+ */
+void DistinctProject::_grow(std::uint32_t level) {
+
+  this->capacity *= 2;
+  this->arena.resize((std::uint64_t)this->capacity * this->tuple_size);
+  this->slots.assign(this->slots.size() * 2, 0);
+  std::uint32_t mask = this->slots.size() - 1;
+  for( std::uint32_t e = 0; e < this->num_entries; e++ ){
+    const char *entry = &this->arena[(std::uint64_t)e * this->tuple_size];
+    std::uint32_t slot = this->_hash(entry, level) & mask;
+    while( this->slots[slot] != 0 ) slot = (slot + 1) & mask;
+    this->slots[slot] = e + 1;
+  }
+}
@@ -0,0 +1,169 @@
+#ifndef  _SWATDB_DISTINCTPROJECT_H_
+#define  _SWATDB_DISTINCTPROJECT_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include "swatdb_types.h"
+#include "project.h"
+
+class Catalog;
+
+/**
+ * DistinctProject is a Project that removes duplicate result tuples. Each
+ * projected tuple is looked up in an in-memory hash table sized to a
+ * budget of buffer pages, and written to the result the first time it is
+ * seen. Once the table is full, tuples that are not in it are spilled by
+ * hash to partition files; each partition is then deduplicated on its own
+ * with a fresh table and a new hash seed, recursively spilling again if it
+ * still does not fit.
+ */
+class DistinctProject : public Project {
+
+  public:
+
+    /**
+     * @brief Constructor for DistinctProject operation.
+     *
+     * @param rel_id. FileId of the relation file.
+     * @param result_id. FileId of the result file.
+     * @param fields. Vector of field ids for the project operation.
+     * @param buffer_pages. Number of pages of memory the hash table may
+     *    use.
+     * @param catalog. pointer to the catalog of SwatDB
+     *
+     * @pre rel_id is the name of a valid file.
+     * @post private variables have been set accordingly.
+     */
+    DistinctProject(FileId rel_id, FileId result_id,
+        std::vector<FieldId> fields, std::uint32_t buffer_pages,
+        Catalog *catalog);
+
+    /**
+     * @brief Destructor for the DistinctProject Operation.
+     */
+    ~DistinctProject();
+
+    /**
+     * @brief Runs the operation: deduplicates the projected tuples of the
+     *    relation, then each spilled partition in turn.
+     *
+     * @pre Valid files and parameters have been passed to the contructor.
+     * @post Result file holds each distinct projected tuple of the
+     *    relation exactly once.
+     */
+    void runOperation();
+
+    /**
+     * @brief Returns the number of tuples written to partition files, over
+     *    all levels of recursion.
+     */
+    std::uint64_t getNumSpilled();
+
+    /**
+     * @brief Returns the number of partition files created.
+     */
+    std::uint32_t getNumPartitions();
+
+    /**
+     * @brief Returns the deepest level of recursion reached, 0 if nothing
+     *    was spilled.
+     */
+    std::uint32_t getMaxDepth();
+
+  private:
+
+    /**
+     * @brief Adds one tuple: writes it to the result if it is new and the
+     *    table has room, drops it if it is already in the table, and spills
+     *    it to a partition otherwise.
+     *
+     * @param tuple. Raw bytes of a tuple with the result's schema.
+     * @param level. Recursion level, used to seed the hash.
+     * @param spills. Partition files of this level, created on the first
+     *    spill.
+     */
+    void _add(const char *tuple, std::uint32_t level,
+        std::vector<FILE *> &spills);
+
+    /**
+     * @brief Deduplicates the tuples of each partition file, recursing on
+     *    the partitions each one spills, and closes the files.
+     *
+     * @param parts. Partition files written at level - 1.
+     * @param level. Recursion level of the partitions.
+     */
+    void _dedupePartitions(std::vector<FILE *> &parts, std::uint32_t level);
+
+    /**
+     * @brief Returns the hash of a tuple's normalized field values, mixed
+     *    with a seed for level so each level splits tuples differently.
+     */
+    std::uint64_t _hash(const char *tuple, std::uint32_t level);
+
+    /**
+     * @brief Returns true if every field of the two tuples compares equal.
+     */
+    bool _equal(const char *a, const char *b);
+
+    /**
+     * @brief Empties the hash table, shrinking it back to the budget if it
+     *    was grown.
+     */
+    void _clearTable();
+
+    /**
+     * @brief Doubles the table's capacity and rehashes its tuples. Only
+     *    used past the last level of recursion, where spilling stops.
+     */
+    void _grow(std::uint32_t level);
+
+    /**
+     * Size in bytes of a result tuple
+     */
+    std::uint32_t tuple_size;
+
+    /**
+     * Number of tuples that fit in the budget, and the number the table
+     * currently holds before it spills (larger only once grown)
+     */
+    std::uint32_t budget_capacity;
+    std::uint32_t capacity;
+
+    /**
+     * Number of tuples in the table
+     */
+    std::uint32_t num_entries;
+
+    /**
+     * The tuples in the table, capacity * tuple_size bytes
+     */
+    std::vector<char> arena;
+
+    /**
+     * Open addressing slots, a power of two at least twice capacity. Each
+     * holds 1 + the tuple's position in arena, or 0 if it is empty.
+     */
+    std::vector<std::uint32_t> slots;
+
+    /**
+     * Scratch space for hashing and for tuples read back from partitions
+     */
+    std::string norm;
+    std::vector<char> tuple;
+
+    /**
+     * Spill statistics
+     */
+    std::uint64_t num_spilled;
+    std::uint32_t num_partitions;
+    std::uint32_t max_depth;
+
+};
+
+
+#endif
@@ -0,0 +1,371 @@
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+#include "swatdb_types.h"
+#include "externalsort.h"
+#include "operation.h"
+#include "catalog.h"
+#include "heapfilescanner.h"
+#include "record.h"
+#include "heapfile.h"
+#include "resultwriter.h"
+#include "recordlayout.h"
+#include "swatdb_exceptions.h"
+
+/*
+ * Fewest pages a sort can work in: two runs to merge and one page of
+ * output.
+ */
+static const std::uint32_t MIN_SORT_PAGES = 3;
+
+/**
+ * @brief Constructor for ExternalSort operation. An in-memory run holds as
+ *    many records, with their entries, as fit in buffer_pages pages.
+ *
+ * @param rel_id. FileId of the relation file.
+ * @param result_id. FileId of the result file, with the relation's schema.
+ * @param fields. Vector of field ids to sort on, most significant first.
+ * @param directions. Vector of the SortDirection of each field.
+ * @param buffer_pages. Number of pages of memory the sort may use, at
+ *    least 3.
+ * @param catalog. pointer to the catalog of SwatDB
+ *
+ * @pre rel_id is the name of a valid file, fields are valid field ids of
+ *    it, and directions has one entry per field.
+ * @post private variables have been set accordingly.
+ */
+ExternalSort::ExternalSort(FileId rel_id, FileId result_id,
+    std::vector<FieldId> fields, std::vector<SortDirection> directions,
+    std::uint32_t buffer_pages, Catalog *catalog)
+  : Operation(result_id, catalog) {
+
+  this->_initState(rel_id, fields, &this->file_state);
+  this->fields = fields;
+  this->directions = directions;
+  this->layout = new RecordLayout(this->file_state.schema);
+  this->rec_size = this->layout->getRecordSize();
+  this->buffer_pages = std::max(buffer_pages, MIN_SORT_PAGES);
+  this->num_runs = 0;
+  this->num_passes = 0;
+
+  std::uint64_t budget = (std::uint64_t)this->buffer_pages * PAGE_SIZE;
+  std::uint64_t cap = budget / (this->rec_size + sizeof(SortEntry));
+  this->capacity = cap > 0 ? cap : 1;
+  this->arena.resize((std::uint64_t)this->capacity * this->rec_size);
+  this->entries.reserve(this->capacity);
+}
+
+/**
+ * @brief Destructor for the ExternalSort Operation.
+ */
+ExternalSort::~ExternalSort() {
+  this->_delState(&this->file_state);
+  delete this->layout;
+}
+
+/**
+ * @brief Runs the operation. Run generation fills the record space from a
+ *    scan and writes a sorted run each time it is full; the runs are then
+ *    merged buffer_pages - 1 at a time until one pass can merge them all
+ *    into the result.
+ *
+ * @pre Valid files and parameters have been passed to the contructor.
+ * @post Result file holds the records of the relation in sorted order.
+ *    Records with equal keys keep their order in the relation.
+ *
+ * @throw SwatDBException if a temporary run file could not be created.
+ */
+void ExternalSort::runOperation() {
+
+  HeapFile* file = (HeapFile *)this->file_state.file;
+  HeapFileScanner* scanner = new HeapFileScanner(file);
+  Record *record = this->file_state.rec;
+  const char *src = RecordLayout::getBytes(record);
+  std::vector<FILE *> runs;
+
+  while( true ){
+    RecordId rid = scanner->getNext(record);
+    if( rid == INVALID_RECORD_ID ) break;
+    if( this->entries.size() == this->capacity ){
+      runs.push_back(this->_writeRun());
+    }
+    std::uint32_t pos = this->entries.size();
+    memcpy(&this->arena[(std::uint64_t)pos * this->rec_size], src,
+        this->rec_size);
+    this->entries.push_back({this->_prefix(src), pos});
+  }
+  delete scanner;
+
+  if( runs.empty() ){
+    // the whole relation fit in memory: write the one run as the result
+    this->_sortEntries();
+    for( const SortEntry &entry : this->entries ){
+      this->result_writer->append(
+          &this->arena[(std::uint64_t)entry.pos * this->rec_size]);
+    }
+    return;
+  }
+
+  if( !this->entries.empty() ){
+    runs.push_back(this->_writeRun());
+  }
+  this->entries.shrink_to_fit();
+
+  // intermediate passes merge groups of fan_in runs into longer runs, in
+  // order, so ties still go to the earlier run
+  std::uint32_t fan_in = this->buffer_pages - 1;
+  while( runs.size() > fan_in ){
+    std::vector<FILE *> merged;
+    for( std::uint32_t i = 0; i < runs.size(); i += fan_in ){
+      std::vector<FILE *> group(runs.begin() + i,
+          runs.begin() + std::min<std::size_t>(i + fan_in, runs.size()));
+      if( group.size() == 1 ){
+        merged.push_back(group[0]);
+        continue;
+      }
+      FILE *out = this->_newRunFile();
+      this->_mergeRuns(group, out);
+      merged.push_back(out);
+    }
+    runs = merged;
+    this->num_passes++;
+  }
+
+  this->_mergeRuns(runs, nullptr);
+  this->num_passes++;
+}
+
+/**
+ * @brief Returns the number of sorted runs written by run generation, 0 if
+ *    the relation fit in memory.
+ */
+std::uint32_t ExternalSort::getNumRuns() {
+  return this->num_runs;
+}
+
+/**
+ * @brief Returns the number of merge passes, including the one that writes
+ *    the result.
+ */
+std::uint32_t ExternalSort::getNumMergePasses() {
+  return this->num_passes;
+}
+
+/**
+ * @brief Returns the normalized prefix of a record's first sort field: an
+ *    unsigned integer whose order matches the field's order in its sort
+ *    direction. INT values have their sign bit flipped and FLOAT values
+ *    their bits flipped so they order as unsigned integers; character
+ *    fields use their first 8 bytes, zero filled past the end of the
+ *    string, which orders like strncmp. Equal prefixes only mean the
+ *    records need a full compare.
+ *
+ * @param rec. Raw bytes of the record.
+ */
+std::uint64_t ExternalSort::_prefix(const char *rec) {
+
+  const FieldLayout &field = this->layout->getField(this->fields[0]);
+  const char *val = rec + field.offset;
+  std::uint64_t prefix = 0;
+
+  switch(field.type) {
+    case INT: {
+      std::uint32_t bits;
+      memcpy(&bits, val, sizeof(bits));
+      prefix = (std::uint64_t)(bits ^ 0x80000000u) << 32;
+      break;
+    }
+    case FLOAT: {
+      float x;
+      std::uint32_t bits;
+      memcpy(&x, val, sizeof(x));
+      if( x == 0 ) x = 0;
+      memcpy(&bits, &x, sizeof(bits));
+      bits = (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+      prefix = (std::uint64_t)bits << 32;
+      break;
+    }
+    default:
+      for( std::uint32_t i = 0; i < 8 && i < field.size; i++ ){
+        unsigned char c = val[i];
+        if( c == 0 ) break;
+        prefix |= (std::uint64_t)c << (56 - 8 * i);
+      }
+      break;
+  }
+  return this->directions[0] == DescendingT ? ~prefix : prefix;
+}
+
+/**
+ * @brief Compares two records on every sort field in turn.
+ *
+ * @return negative if a sorts before b, 0 if their keys are equal,
+ *    positive if a sorts after b.
+ */
+int ExternalSort::_compare(const char *a, const char *b) {
+
+  for( std::uint32_t i = 0; i < this->fields.size(); i++ ){
+    const FieldLayout &field = this->layout->getField(this->fields[i]);
+    int cmp = RecordLayout::compareFieldValues(field, a + field.offset,
+        b + field.offset);
+    if( cmp != 0 ) return this->directions[i] == DescendingT ? -cmp : cmp;
+  }
+  return 0;
+}
+
+/**
+ * @brief Sorts the entries of the in-memory run on their prefixes, with a
+ *    full compare only for equal prefixes, and the record's position last
+ *    so equal keys keep their scan order.
+ */
+void ExternalSort::_sortEntries() {
+
+  std::sort(this->entries.begin(), this->entries.end(),
+      [this](const SortEntry &a, const SortEntry &b) {
+        if( a.prefix != b.prefix ) return a.prefix < b.prefix;
+        int cmp = this->_compare(
+            &this->arena[(std::uint64_t)a.pos * this->rec_size],
+            &this->arena[(std::uint64_t)b.pos * this->rec_size]);
+        if( cmp != 0 ) return cmp < 0;
+        return a.pos < b.pos;
+      });
+}
+
+/**
+ * @brief Returns a new, empty temporary file for a run.
+ *
+ * @throw SwatDBException if the file could not be created.
+ */
+FILE *ExternalSort::_newRunFile() {
+
+  FILE *run = std::tmpfile();
+  if( run == nullptr ) throw SwatDBException();
+  return run;
+}
+
+/**
+ * @brief Sorts the records in memory and writes them to a new run file.
+ *    The record space is empty afterwards.
+ *
+ * @return FILE * of the run.
+ *
+ * @throw SwatDBException if the run file could not be created.
+ */
+FILE *ExternalSort::_writeRun() {
+
+  FILE *run = this->_newRunFile();
+  this->_sortEntries();
+  for( const SortEntry &entry : this->entries ){
+    fwrite(&this->arena[(std::uint64_t)entry.pos * this->rec_size],
+        this->rec_size, 1, run);
+  }
+  this->entries.clear();
+  this->num_runs++;
+  return run;
+}
+
+/**
+ * @brief Merges runs into out, or into the result if out is nullptr, and
+ *    closes them. Each run gets a page of the record space as its read
+ *    buffer, and a loser tree picks the next record in log2(runs)
+ *    comparisons.
+ *
+ * @param runs. Files of the runs to merge.
+ * @param out. FILE * to write to, nullptr for the result.
+ */
+void ExternalSort::_mergeRuns(std::vector<FILE *> &runs, FILE *out) {
+
+  std::uint32_t k = runs.size();
+  if( this->arena.size() < (std::uint64_t)k * PAGE_SIZE ){
+    this->arena.resize((std::uint64_t)k * PAGE_SIZE);
+  }
+  this->merge_runs.resize(k);
+  for( std::uint32_t i = 0; i < k; i++ ){
+    SortRun &run = this->merge_runs[i];
+    run.file = runs[i];
+    run.buf = &this->arena[(std::uint64_t)i * PAGE_SIZE];
+    rewind(run.file);
+    this->_fillRun(run);
+  }
+
+  // build the tree bottom up: leaf i is node k + i, and each internal node
+  // keeps the loser of its two children's winners
+  std::vector<std::uint32_t> winners(2 * k);
+  this->tree.assign(std::max<std::uint32_t>(k, 1), 0);
+  for( std::uint32_t i = 0; i < k; i++ ) winners[k + i] = i;
+  for( std::uint32_t t = k - 1; t > 0; t-- ){
+    std::uint32_t a = winners[2 * t];
+    std::uint32_t b = winners[2 * t + 1];
+    if( this->_beats(a, b) ){
+      winners[t] = a;
+      this->tree[t] = b;
+    }
+    else {
+      winners[t] = b;
+      this->tree[t] = a;
+    }
+  }
+  this->tree[0] = k > 1 ? winners[1] : 0;
+
+  while( true ){
+    std::uint32_t s = this->tree[0];
+    SortRun &run = this->merge_runs[s];
+    if( run.num == 0 ) break;
+    const char *rec = run.buf + (std::uint64_t)run.pos * this->rec_size;
+    if( out == nullptr ){
+      this->result_writer->append(rec);
+    }
+    else {
+      fwrite(rec, this->rec_size, 1, out);
+    }
+    run.pos++;
+    if( run.pos == run.num ) this->_fillRun(run);
+    this->_replay(s);
+  }
+
+  for( FILE *run : runs ) fclose(run);
+  runs.clear();
+  this->merge_runs.clear();
+}
+
+/**
+ * @brief Reads the next page of records of a run into its buffer.
+ */
+void ExternalSort::_fillRun(SortRun &run) {
+  run.num = fread(run.buf, this->rec_size, PAGE_SIZE / this->rec_size,
+      run.file);
+  run.pos = 0;
+}
+
+/**
+ * @brief Returns true if run a's current record goes before run b's:
+ *    exhausted runs lose, and ties go to the earlier run, so the merge is
+ *    stable.
+ */
+bool ExternalSort::_beats(std::uint32_t a, std::uint32_t b) {
+
+  const SortRun &ra = this->merge_runs[a];
+  const SortRun &rb = this->merge_runs[b];
+  if( ra.num == 0 ) return false;
+  if( rb.num == 0 ) return true;
+  int cmp = this->_compare(ra.buf + (std::uint64_t)ra.pos * this->rec_size,
+      rb.buf + (std::uint64_t)rb.pos * this->rec_size);
+  if( cmp != 0 ) return cmp < 0;
+  return a < b;
+}
+
+/**
+ * @brief Moves the loser tree's leaf s up to the root after its run moved
+ *    on to its next record. At each node on the way the current winner
+ *    plays the stored loser, and the loser of that match stays behind.
+ */
+void ExternalSort::_replay(std::uint32_t s) {
+
+  std::uint32_t k = this->merge_runs.size();
+  for( std::uint32_t t = (s + k) >> 1; t > 0; t >>= 1 ){
+    if( this->_beats(this->tree[t], s) ) std::swap(this->tree[t], s);
+  }
+  this->tree[0] = s;
+}
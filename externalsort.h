@@ -0,0 +1,246 @@
+#ifndef  _SWATDB_EXTERNALSORT_H_
+#define  _SWATDB_EXTERNALSORT_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include "swatdb_types.h"
+#include "operation.h"
+
+class Catalog;
+class RecordLayout;
+
+/**
+ * Sort order of one sort field
+ */
+enum SortDirection {AscendingT, DescendingT};
+
+/**
+ * Struct for one record of an in-memory run: a prefix of its normalized
+ * sort key and its position in the run's record space.
+ */
+struct SortEntry {
+  /**
+   * First sort field in a form that compares as an unsigned integer
+   */
+  std::uint64_t prefix;
+  /**
+   * Position of the record in the run
+   */
+  std::uint32_t pos;
+};
+
+/**
+ * Struct for a sorted run being read back during a merge.
+ */
+struct SortRun {
+  /**
+   * File holding the run's records
+   */
+  FILE *file;
+  /**
+   * Page sized read buffer of the run
+   */
+  char *buf;
+  /**
+   * Number of records in buf, 0 once the run is exhausted
+   */
+  std::uint32_t num;
+  /**
+   * Position in buf of the run's current record
+   */
+  std::uint32_t pos;
+};
+
+/**
+ * ExternalSort is a derived class of operation that sorts a relation on one
+ * or more fields using a bounded number of pages of memory. Records are
+ * read into memory until the budget is full, sorted on a normalized prefix
+ * of their first sort field (falling back to the full key on ties), and
+ * written out as a sorted run. The runs are then merged with a loser tree,
+ * a page of each at a time, in as many passes as the budget requires; the
+ * last pass writes the result. A relation that fits in memory is written
+ * straight from its single run.
+ */
+class ExternalSort : public Operation {
+
+  public:
+
+    /**
+     * @brief Constructor for ExternalSort operation.
+     *
+     * @param rel_id. FileId of the relation file.
+     * @param result_id. FileId of the result file, with the relation's
+     *    schema.
+     * @param fields. Vector of field ids to sort on, most significant first.
+     * @param directions. Vector of the SortDirection of each field.
+     * @param buffer_pages. Number of pages of memory the sort may use, at
+     *    least 3.
+     * @param catalog. pointer to the catalog of SwatDB
+     *
+     * @pre rel_id is the name of a valid file, fields are valid field ids
+     *    of it, and directions has one entry per field.
+     * @post private variables have been set accordingly.
+     */
+    ExternalSort(FileId rel_id, FileId result_id, std::vector<FieldId> fields,
+        std::vector<SortDirection> directions, std::uint32_t buffer_pages,
+        Catalog *catalog);
+
+    /**
+     * @brief Destructor for the ExternalSort Operation.
+     */
+    ~ExternalSort();
+
+    /**
+     * @brief Runs the operation.
+     *
+     * @pre Valid files and parameters have been passed to the contructor.
+     * @post Result file holds the records of the relation in sorted order.
+     *    Records with equal keys keep their order in the relation.
+     *
+     * @throw SwatDBException if a temporary run file could not be created.
+     */
+    void runOperation();
+
+    /**
+     * @brief Returns the number of sorted runs written by run generation,
+     *    0 if the relation fit in memory.
+     */
+    std::uint32_t getNumRuns();
+
+    /**
+     * @brief Returns the number of merge passes, including the one that
+     *    writes the result.
+     */
+    std::uint32_t getNumMergePasses();
+
+  private:
+
+    /**
+     * @brief Returns the normalized prefix of a record's first sort field:
+     *    an unsigned integer whose order matches the field's order in its
+     *    sort direction.
+     *
+     * @param rec. Raw bytes of the record.
+     */
+    std::uint64_t _prefix(const char *rec);
+
+    /**
+     * @brief Compares two records on every sort field in turn.
+     *
+     * @return negative if a sorts before b, 0 if their keys are equal,
+     *    positive if a sorts after b.
+     */
+    int _compare(const char *a, const char *b);
+
+    /**
+     * @brief Sorts the entries of the in-memory run.
+     */
+    void _sortEntries();
+
+    /**
+     * @brief Returns a new, empty temporary file for a run.
+     *
+     * @throw SwatDBException if the file could not be created.
+     */
+    FILE *_newRunFile();
+
+    /**
+     * @brief Sorts the records in memory and writes them to a new run file.
+     *
+     * @return FILE * of the run.
+     *
+     * @throw SwatDBException if the run file could not be created.
+     */
+    FILE *_writeRun();
+
+    /**
+     * @brief Merges runs into out, or into the result if out is nullptr,
+     *    and closes them.
+     *
+     * @param runs. Files of the runs to merge.
+     * @param out. FILE * to write to, nullptr for the result.
+     */
+    void _mergeRuns(std::vector<FILE *> &runs, FILE *out);
+
+    /**
+     * @brief Reads the next page of records of a run into its buffer.
+     */
+    void _fillRun(SortRun &run);
+
+    /**
+     * @brief Returns true if run a's current record goes before run b's:
+     *    exhausted runs lose, and ties go to the earlier run, so the merge
+     *    is stable.
+     */
+    bool _beats(std::uint32_t a, std::uint32_t b);
+
+    /**
+     * @brief Moves the loser tree's leaf s up to the root after its run
+     *    moved on to its next record.
+     */
+    void _replay(std::uint32_t s);
+
+    /**
+     * Sort fields, most significant first, and their directions
+     */
+    std::vector<FieldId> fields;
+    std::vector<SortDirection> directions;
+
+    /**
+     * fileState struct for the file being sorted
+     */
+    fileState file_state;
+
+    /**
+     * Byte layout of the relation's records
+     */
+    RecordLayout *layout;
+
+    /**
+     * Size in bytes of a record
+     */
+    std::uint32_t rec_size;
+
+    /**
+     * Number of pages of memory the sort may use
+     */
+    std::uint32_t buffer_pages;
+
+    /**
+     * Maximum number of records in an in-memory run
+     */
+    std::uint32_t capacity;
+
+    /**
+     * Record space of the in-memory run, reused for the merge's read
+     * buffers
+     */
+    std::vector<char> arena;
+
+    /**
+     * One entry per record of the in-memory run
+     */
+    std::vector<SortEntry> entries;
+
+    /**
+     * Runs being merged and the loser tree over them: tree[0] is the run
+     * with the next record, and tree[1..] the loser at each internal node
+     */
+    std::vector<SortRun> merge_runs;
+    std::vector<std::uint32_t> tree;
+
+    /**
+     * Sort statistics
+     */
+    std::uint32_t num_runs;
+    std::uint32_t num_passes;
+
+};
+
+
+#endif
@@ -1,5 +1,6 @@
 #include <string>
 #include <vector>
+#include <cstring>
 #include <iostream>
 #include "swatdb_types.h"
 #include "filescan.h"
@@ -10,6 +11,10 @@
 #include "heapfilescanner.h"
 #include "searchkeyformat.h"
 #include "catalog.h"
+#include "resultwriter.h"
+#include "zonemap.h"
+#include "recordlayout.h"
+#include "pinnedpagescan.h"
 
 
     
@@ -27,6 +32,15 @@ FileScan::FileScan(FileId rel_id, FileId result_id,
     std::vector<void *> values, Catalog *catalog) : Select(rel_id, result_id, 
     fields, comps, values, catalog) {
 
+  this->zone_map = nullptr;
+  this->pages_skipped = 0;
+  this->use_zone_map = false;
+  this->use_pinned = false;
+  this->page_scan = nullptr;
+  this->fill_rec = false;
+  this->page_pos = 0;
+  this->pages_listed = false;
+  this->pages_num_recs = 0;
 }
 
 
@@ -36,6 +50,7 @@ FileScan::FileScan(FileId rel_id, FileId result_id,
  * @post File state for the relation and result file are cleaned up
  */
 FileScan::~FileScan(){
+  delete this->page_scan;
 }
 
 /**                                                                         
@@ -46,32 +61,139 @@ FileScan::~FileScan(){
  *    of the operation.                                                     
  */   
 void FileScan::runOperation() {
-  // get heapfile from file state
+  this->_runScan();
+}
+
+/**
+ * @brief Gives the file scan a zone map of the relation.
+ *
+ * @param zone_map. ZoneMap * of the relation, nullptr for none.
+ */
+void FileScan::setZoneMap(ZoneMap *zone_map) {
+  this->zone_map = zone_map;
+}
+
+/**
+ * @brief Returns the number of pages skipped using the zone map in the last
+ *    run of the operation.
+ */
+std::uint32_t FileScan::getNumPagesSkipped() {
+  return this->pages_skipped;
+}
+
+/**
+ * @brief Starts the scan. With a buffer manager the relation's pages are
+ *    listed and pinned one at a time, and records are checked in place.
+ *    The zone map prunes that list only if its record count matches the
+ *    relation's; modifications made through RelOpsManager keep it in step,
+ *    and a mismatch means records were added or removed behind its back.
+ *    Pages the zone map has no synopsis for are always read. The page list
+ *    is kept from one scan to the next, as for a prepared select, and only
+ *    listed again when the relation's record count changes. Without a
+ *    buffer manager the whole heap file is scanned with a HeapFileScanner.
+ */
+void FileScan::_openScan() {
   HeapFile* file = (HeapFile *)this->file_state.file;
-  // initialize scanner
-  HeapFileScanner* scanner = new HeapFileScanner(file);
-  Record *record = this->file_state.rec;
-  
-  // scan through the record and get record id
+  this->pages_skipped = 0;
+  this->page_pos = 0;
+  this->use_pinned = this->buf_mgr != nullptr;
+  this->use_zone_map = false;
+  if( !this->use_pinned ){
+    Select::_openScan();
+    return;
+  }
+
+  this->use_zone_map = this->zone_map != nullptr &&
+    this->zone_map->getNumRecs() == file->getNumRecs();
+  this->fill_rec = false;
+  for( size_t i = 0; i < this->preds.size(); i++ ){
+    if( !this->preds[i].isCompiled() ) this->fill_rec = true;
+  }
+  if( !this->pages_listed || this->pages_num_recs != file->getNumRecs() ){
+    this->scan_pages = PinnedPageScan::listPages(file);
+    this->pages_listed = true;
+    this->pages_num_recs = file->getNumRecs();
+  }
+  if( this->page_scan == nullptr ){
+    this->page_scan = new PinnedPageScan(this->buf_mgr);
+  }
+}
+
+/**
+ * @brief Reads the next candidate record into rec.
+ *
+ * @param rec. Record * the candidate is read into.
+ *
+ * @return RecordId of the candidate, INVALID_RECORD_ID at the end of the
+ *    scan.
+ */
+RecordId FileScan::_fetchNext(Record *rec) {
+  if( !this->use_pinned ) return Select::_fetchNext(rec);
+
+  RecordId rid;
+  const char *bytes = this->_fetchNextBytes(rec, &rid);
+  char *rec_bytes = RecordLayout::getBytes(rec);
+  if( bytes != nullptr && bytes != rec_bytes ){
+    memcpy(rec_bytes, bytes, this->layout->getRecordSize());
+  }
+  return rid;
+}
+
+/**
+ * @brief Returns the bytes of the next candidate record. Over pinned pages
+ *    the next page is pinned once every record of the current one has been
+ *    returned, skipping pages whose zone map synopsis can not satisfy the
+ *    conjuncts. The bytes stay valid until the page is released.
+ *
+ * @param rec. Record * the candidate may be read into.
+ * @param rid. Set to the RecordId of the candidate, INVALID_RECORD_ID at
+ *    the end of the scan.
+ *
+ * @return const char * to the candidate's bytes, nullptr at the end of the
+ *    scan.
+ */
+const char *FileScan::_fetchNextBytes(Record *rec, RecordId *rid) {
+  if( !this->use_pinned ) return Select::_fetchNextBytes(rec, rid);
+
   while( true ){
-    RecordId rid = scanner->getNext(record);
-    if( rid == INVALID_RECORD_ID ) break;
-    bool passes = true;
-    // check if match the select conditions
-    for( size_t i = 0; i < fields.size(); i ++ ){
-      FieldId fieldId = fields[i];
-      Comp comp = comps[i];
-      void* val = values[i];
-      if( !record->compareFieldToValue( fieldId, val, comp ) ){
-        passes = false;
-        break;
+    if( !this->page_scan->isPinned() ){
+      if( this->page_pos == this->scan_pages.size() ){
+        *rid = INVALID_RECORD_ID;
+        return nullptr;
       }
+      PageId page_id = this->scan_pages[this->page_pos++];
+      if( this->use_zone_map ){
+        const ZonePage *page = this->zone_map->findPage(page_id);
+        if( page != nullptr && !this->zone_map->mayMatch(*page,
+              this->preds) ){
+          this->pages_skipped++;
+          continue;
+        }
+      }
+      this->page_scan->pin(page_id);
     }
-    // if passes insert Record
-    if( passes ){
-      ((HeapFile *)this->result_state.file)->insertRecord( *record );
+    SlotId slot_id;
+    const char *bytes = this->page_scan->next(&slot_id);
+    if( bytes != nullptr ){
+      rid->page_id = this->page_scan->getPageId();
+      rid->slot_id = slot_id;
+      if( !this->fill_rec ) return bytes;
+      char *rec_bytes = RecordLayout::getBytes(rec);
+      memcpy(rec_bytes, bytes, this->layout->getRecordSize());
+      return rec_bytes;
     }
+    this->page_scan->release();
   }
+}
 
-  delete scanner;
-}
\ No newline at end of file
+/**
+ * @brief Ends the scan, releasing the pinned page if there is one.
+ */
+void FileScan::_closeScan() {
+  if( this->use_pinned ){
+    this->page_scan->release();
+    this->use_pinned = false;
+    return;
+  }
+  Select::_closeScan();
+}
@@ -21,6 +21,8 @@ class Record;
 class Data;
 class Key;
 class SearchKeyFormat;
+class ZoneMap;
+class PinnedPageScan;
 
 /**
  * Select is an abstract class that lays the foundation for select operations
@@ -58,8 +60,103 @@ class FileScan : public Select {
      */   
     void runOperation(); 
 
+    /**
+     * @brief Gives the file scan a zone map of the relation. If the scan
+     *    reads pinned pages and the zone map's record count matches the
+     *    relation's when the operation runs, pages whose ranges can not
+     *    satisfy the conjuncts are skipped without being read.
+     *
+     * @param zone_map. ZoneMap * of the relation, nullptr for none.
+     */
+    void setZoneMap(ZoneMap *zone_map);
+
+    /**
+     * @brief Returns the number of pages skipped using the zone map in the
+     *    last run of the operation.
+     */
+    std::uint32_t getNumPagesSkipped();
+
+  protected:
+
+    /**
+     * @brief Starts the scan, over pinned heap pages if the scan has a
+     *    buffer manager, pruned with the zone map if it is up to date, and
+     *    with a HeapFileScanner otherwise.
+     */
+    void _openScan();
+
+    /**
+     * @brief Reads the next candidate record into rec.
+     *
+     * @param rec. Record * the candidate is read into.
+     *
+     * @return RecordId of the candidate, INVALID_RECORD_ID at the end of the
+     *    scan.
+     */
+    RecordId _fetchNext(Record *rec);
+
+    /**
+     * @brief Returns the bytes of the next candidate record, skipping the
+     *    pages the zone map rules out. Over pinned pages they are the
+     *    record's bytes on its page, and rec is only filled if a conjunct
+     *    is not compiled.
+     *
+     * @param rec. Record * the candidate may be read into.
+     * @param rid. Set to the RecordId of the candidate, INVALID_RECORD_ID
+     *    at the end of the scan.
+     *
+     * @return const char * to the candidate's bytes, nullptr at the end of
+     *    the scan.
+     */
+    const char *_fetchNextBytes(Record *rec, RecordId *rid);
+
+    /**
+     * @brief Ends the scan.
+     */
+    void _closeScan();
+
   private:
-    
+
+    /**
+     * Zone map of the relation, nullptr if there is none
+     */
+    ZoneMap *zone_map;
+
+    /**
+     * Number of pages skipped in the last run
+     */
+    std::uint32_t pages_skipped;
+
+    /**
+     * True if the current scan prunes pages with the zone map
+     */
+    bool use_zone_map;
+
+    /**
+     * True if the current scan reads records in place on pinned pages, the
+     * pages it reads, and the scan of the current page
+     */
+    bool use_pinned;
+    std::vector<PageId> scan_pages;
+    PinnedPageScan *page_scan;
+
+    /**
+     * True if some conjunct is not compiled, so candidates read in place
+     * are also copied into the scan's Record
+     */
+    bool fill_rec;
+
+    /**
+     * Position in scan_pages of the next page to pin
+     */
+    size_t page_pos;
+
+    /**
+     * True once scan_pages has been listed, and the relation's record count
+     * when it was; the list is reused until the count changes
+     */
+    bool pages_listed;
+    std::uint64_t pages_num_recs;
 
 };
 
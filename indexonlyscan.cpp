@@ -0,0 +1,184 @@
+#include <string>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include "swatdb_exceptions.h"
+#include "swatdb_types.h"
+#include "indexonlyscan.h"
+#include "recordlayout.h"
+#include "predicate.h"
+#include "key.h"
+#include "data.h"
+#include "record.h"
+#include "catalog.h"
+#include "searchkeyformat.h"
+#include "hashindexscanner.h"
+#include "hashindexfile.h"
+#include "resultwriter.h"
+
+/**
+ * @brief Constructor for IndexOnlyScan. Matches each key field to an
+ *    equality conjunct, and compiles the other conjuncts against the
+ *    relation's layout.
+ *
+ * @param rel_id. FileId of the relation file.
+ * @param index_id. FileId of the hash index file.
+ * @param result_id. FileId of the result file, with the schema of the
+ *    projected fields.
+ * @param fields. Vector of field ids for the select operation.
+ * @param comps. Vector of Comps for the select operation.
+ * @param values. Vector of Void * for the select operation.
+ * @param proj_fields. Vector of field ids kept in the result, in order.
+ * @param catalog. Catalog * for SwatDB.
+ *
+ * @throw InvalidFileIdRelOpsManager if the index does not exist or is not
+ *    on rel_id.
+ * @throw MismatchingFieldsRelOpsManager if the index does not cover the
+ *    select and project.
+ */
+IndexOnlyScan::IndexOnlyScan(FileId rel_id, FileId index_id,
+    FileId result_id, std::vector<FieldId> fields, std::vector<Comp> comps,
+    std::vector<void *> values, std::vector<FieldId> proj_fields,
+    Catalog *catalog) : Operation(result_id, catalog) {
+
+  this->index_file = (HashIndexFile *)catalog->getFile(index_id);
+  if( this->index_file == nullptr ){
+    throw InvalidFileIdRelOpsManager();
+  }
+  if( catalog->getRelationFileId(index_id) != rel_id ){
+    throw InvalidFileIdRelOpsManager();
+  }
+  if( !isCovered(this->index_file, fields, comps, proj_fields) ){
+    throw MismatchingFieldsRelOpsManager();
+  }
+
+  this->_initState(rel_id, {}, &this->file_state);
+  this->layout = new RecordLayout(this->file_state.schema);
+  this->result_layout = new RecordLayout(this->result_state.schema);
+  this->proj_fields = proj_fields;
+  this->num_matches = 0;
+
+  std::vector<bool> is_key(fields.size(), false);
+  for( FieldId key_fid : this->index_file->getKeyFormat()->getFieldList() ){
+    size_t i = 0;
+    while( is_key[i] || fields[i] != key_fid || comps[i] != EQUAL ){
+      i++;
+    }
+    is_key[i] = true;
+    this->key_values.push_back(values[i]);
+  }
+  for( size_t i = 0; i < fields.size(); i++ ){
+    if( !is_key[i] ){
+      this->residual.push_back(Predicate(this->layout->getField(fields[i]),
+            comps[i], values[i]));
+    }
+  }
+}
+
+/**
+ * @brief Destructor for IndexOnlyScan.
+ */
+IndexOnlyScan::~IndexOnlyScan() {
+  this->_delState(&this->file_state);
+  delete this->layout;
+  delete this->result_layout;
+}
+
+/**
+ * @brief Runs the operation. The probe values are written into a record
+ *    image at their fields' offsets (character values zero padded, as
+ *    records store them), the residual conjuncts are checked on it once,
+ *    and the projected tuple built from it is written once per index entry
+ *    for the key.
+ *
+ * @pre Valid files and parameters have been passed to the contructor.
+ * @post Result file has been populated with the projected fields of the
+ *    records that meet the criteria of the select.
+ */
+void IndexOnlyScan::runOperation() {
+
+  this->num_matches = 0;
+  Record *rec = this->file_state.rec;
+  char *bytes = RecordLayout::getBytes(rec);
+  memset(bytes, 0, this->layout->getRecordSize());
+  std::vector<FieldId> key_fields = 
+    this->index_file->getKeyFormat()->getFieldList();
+  for( size_t k = 0; k < key_fields.size(); k++ ){
+    const FieldLayout &field = this->layout->getField(key_fields[k]);
+    const char *val = (const char *)this->key_values[k];
+    size_t size = field.size;
+    if( field.type != INT && field.type != FLOAT ){
+      size = strnlen(val, field.size);
+    }
+    memcpy(bytes + field.offset, val, size);
+  }
+  for( const Predicate &pred : this->residual ){
+    if( !pred.matches(rec, bytes) ){
+      return;
+    }
+  }
+
+  Key *key = new Key(MAX_RECORD_SIZE);
+  key->setKeyFormat(this->index_file->getKeyFormat());
+  key->setKeyFromValues(this->key_values);
+  HashIndexScanner *scanner = new HashIndexScanner(this->index_file, key);
+  while( scanner->getNext() != INVALID_RECORD_ID ){
+    char *dest = this->result_writer->reserve();
+    for( FieldId i = 0; i < this->proj_fields.size(); i++ ){
+      const FieldLayout &from = this->layout->getField(this->proj_fields[i]);
+      const FieldLayout &to = this->result_layout->getField(i);
+      memcpy(dest + to.offset, bytes + from.offset, from.size);
+    }
+    this->result_writer->commit();
+    this->num_matches++;
+  }
+  delete scanner;
+  delete key;
+}
+
+/**
+ * @brief Returns the number of tuples written by the last run.
+ */
+std::uint64_t IndexOnlyScan::getNumMatches() {
+  return this->num_matches;
+}
+
+/**
+ * @brief Returns true if a hash index can answer a select and project
+ *    alone: every key field has an equality conjunct, every other conjunct
+ *    is on a key field, and every projected field is a key field.
+ *
+ * @param index_file. HashIndexFile * of the index.
+ * @param fields. Vector of field ids for the select operation.
+ * @param comps. Vector of Comps for the select operation.
+ * @param proj_fields. Vector of field ids kept in the result.
+ */
+bool IndexOnlyScan::isCovered(HashIndexFile *index_file,
+    const std::vector<FieldId> &fields, const std::vector<Comp> &comps,
+    const std::vector<FieldId> &proj_fields) {
+
+  std::vector<FieldId> key_fields = index_file->getKeyFormat()->getFieldList();
+  std::vector<bool> is_key(fields.size(), false);
+  for( FieldId key_fid : key_fields ){
+    size_t i = 0;
+    while( i < fields.size() && 
+        ( is_key[i] || fields[i] != key_fid || comps[i] != EQUAL ) ){
+      i++;
+    }
+    if( i == fields.size() ) return false;
+    is_key[i] = true;
+  }
+  for( FieldId fid : fields ){
+    if( std::find(key_fields.begin(), key_fields.end(), fid) == 
+        key_fields.end() ){
+      return false;
+    }
+  }
+  for( FieldId fid : proj_fields ){
+    if( std::find(key_fields.begin(), key_fields.end(), fid) ==
+        key_fields.end() ){
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,130 @@
+#ifndef _SWATDB_INDEXONLYSCAN_H_
+#define _SWATDB_INDEXONLYSCAN_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include "swatdb_types.h"
+#include "operation.h"
+
+class Catalog;
+class HashIndexFile;
+class RecordLayout;
+class Predicate;
+
+/**
+ * IndexOnlyScan is a select followed by a project that is answered from a
+ * hash index alone. Every field of the index key has an equality conjunct,
+ * so every entry the index returns for the probe key holds exactly those
+ * values. If the other conjuncts are on key fields too and the projected
+ * fields are all key fields, each output tuple is built from the probe
+ * values, one per index entry, and the heap file is never read.
+ */
+class IndexOnlyScan : public Operation {
+
+  public:
+
+    /**
+     * @brief Constructor for IndexOnlyScan.
+     *
+     * @param rel_id. FileId of the relation file.
+     * @param index_id. FileId of the hash index file.
+     * @param result_id. FileId of the result file, with the schema of the
+     *    projected fields.
+     * @param fields. Vector of field ids for the select operation.
+     * @param comps. Vector of Comps for the select operation.
+     * @param values. Vector of Void * for the select operation.
+     * @param proj_fields. Vector of field ids kept in the result, in order.
+     * @param catalog. Catalog * for SwatDB.
+     *
+     * @throw InvalidFileIdRelOpsManager if the index does not exist or is
+     *    not on rel_id.
+     * @throw MismatchingFieldsRelOpsManager if the index does not cover
+     *    the select and project (see isCovered).
+     */
+    IndexOnlyScan(FileId rel_id, FileId index_id, FileId result_id,
+        std::vector<FieldId> fields, std::vector<Comp> comps,
+        std::vector<void *> values, std::vector<FieldId> proj_fields,
+        Catalog *catalog);
+
+    /**
+     * @brief Destructor for IndexOnlyScan.
+     */
+    ~IndexOnlyScan();
+
+    /**
+     * @brief Runs the operation: checks the conjuncts not used to probe
+     *    once against the probe values, then writes one output tuple per
+     *    index entry for the key.
+     *
+     * @pre Valid files and parameters have been passed to the contructor.
+     * @post Result file has been populated with the projected fields of
+     *    the records that meet the criteria of the select.
+     */
+    void runOperation();
+
+    /**
+     * @brief Returns the number of tuples written by the last run.
+     */
+    std::uint64_t getNumMatches();
+
+    /**
+     * @brief Returns true if a hash index can answer a select and project
+     *    alone: every key field has an equality conjunct, every other
+     *    conjunct is on a key field, and every projected field is a key
+     *    field.
+     *
+     * @param index_file. HashIndexFile * of the index.
+     * @param fields. Vector of field ids for the select operation.
+     * @param comps. Vector of Comps for the select operation.
+     * @param proj_fields. Vector of field ids kept in the result.
+     */
+    static bool isCovered(HashIndexFile *index_file,
+        const std::vector<FieldId> &fields, const std::vector<Comp> &comps,
+        const std::vector<FieldId> &proj_fields);
+
+  private:
+
+    /**
+     * Index file probed
+     */
+    HashIndexFile *index_file;
+
+    /**
+     * State of the relation, whose Record holds the probe key's values at
+     * their offsets
+     */
+    fileState file_state;
+
+    /**
+     * Byte layouts of the relation's records and of the result's records
+     */
+    RecordLayout *layout;
+    RecordLayout *result_layout;
+
+    /**
+     * Fields kept in the result, in order
+     */
+    std::vector<FieldId> proj_fields;
+
+    /**
+     * Values of the equality conjuncts on the index key, in key field order
+     */
+    std::vector<void *> key_values;
+
+    /**
+     * Conjuncts not used to probe, all on key fields
+     */
+    std::vector<Predicate> residual;
+
+    /**
+     * Number of tuples written by the last run
+     */
+    std::uint64_t num_matches;
+
+};
+
+#endif
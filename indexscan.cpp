@@ -1,5 +1,8 @@
 #include <string>
 #include <vector>
+#include <new>
+#include <algorithm>
+#include <mutex>
 #include "swatdb_exceptions.h"
 #include "swatdb_types.h"
 #include "indexscan.h"
@@ -12,6 +15,17 @@
 #include "searchkeyformat.h"
 #include "hashindexscanner.h"
 #include "hashindexfile.h"
+#include "resultwriter.h"
+#include "ridbitmap.h"
+#include "pageprefetcher.h"
+#include "bufferlatch.h"
+
+/*
+ * Default number of RecordIds read from the index before they are sorted
+ * and fetched. If the index has more matches than this the scan switches to
+ * a bitmap heap scan.
+ */
+static const std::uint32_t RID_BATCH_SIZE = 512;
 
 /**                                                                         
  * @brief Constructor for IndexScan select operation.                       
@@ -26,8 +40,12 @@
  *
  * @throw InvalidFileIdRelOpsManager if the rel_id does not match the 
  *    relation id for the index_id given. 
- * @throw MismatchingFieldsRelOpsManager if the fields selected on do 
- *    not match the fields the index is on. 
+ * @throw MismatchingFieldsRelOpsManager if some field of the index key has
+ *    no equality conjunct in the select. 
+ *
+ * @post The equality conjuncts on the key fields are used to probe the
+ *    index and the other conjuncts are the residual checked after each
+ *    fetch.
  */                                                                         
 IndexScan::IndexScan(FileId rel_id, FileId index_id, FileId result_id, 
                           std::vector<FieldId> fields, std::vector<Comp> comps,
@@ -51,51 +69,309 @@ IndexScan::IndexScan(FileId rel_id, FileId index_id, FileId result_id,
 
   SearchKeyFormat* format = this->index_file->getKeyFormat();
   std::vector<FieldId> ids_fields = format->getFieldList();
-  // check if fields match
-  if( ids_fields != fields ){
-    throw MismatchingFieldsRelOpsManager();
+  // every key field needs an equality conjunct to probe the index with.
+  // The probe guarantees those conjuncts, so only the remaining (residual)
+  // ones are left in the order checked after each fetch.
+  std::vector<bool> is_key(fields.size(), false);
+  for( FieldId key_fid : ids_fields ){
+    size_t i = 0;
+    while( i < fields.size() && 
+        ( is_key[i] || fields[i] != key_fid || comps[i] != EQUAL ) ){
+      i++;
+    }
+    if( i == fields.size() ){
+      throw MismatchingFieldsRelOpsManager();
+    }
+    is_key[i] = true;
+    this->key_values.push_back(values[i]);
+    this->key_pos.push_back(i);
   }
-  
+  this->order.clear();
+  for( std::uint32_t i = 0; i < fields.size(); i++ ){
+    if( !is_key[i] ) this->order.push_back(i);
+  }
+  this->key_val = new Key(MAX_RECORD_SIZE);
+  this->key_val->setKeyFormat(format);
+  this->index_scanner = nullptr;
+  this->index_scanner_mem = ::operator new(sizeof(HashIndexScanner));
+  this->rid_batch_size = RID_BATCH_SIZE;
+  this->rid_batch.reserve(RID_BATCH_SIZE);
+  this->batch_pos = 0;
+  this->index_done = false;
+  this->bitmap_scan = false;
+  this->run_to_end = false;
+  this->bitmap = new RidBitmap(rel_id);
+  this->prefetcher = nullptr;
+  this->prefetch_depth = 0;
+  this->prefetch_pos = 0;
+  this->holding_page = false;
+  this->prefetch_hits = 0;
+  this->prefetch_misses = 0;
 }
 
 IndexScan::~IndexScan(){
+  if( this->index_scanner != nullptr ){
+    this->index_scanner->~HashIndexScanner();
+  }
+  ::operator delete(this->index_scanner_mem);
+  delete this->key_val;
+  delete this->bitmap;
 }
     
 /**                                                                             
- * @brief Runs the index scan select operation. 
+ * @brief Runs the index scan select operation. The scan runs to completion,
+ *    so it may switch to a bitmap heap scan.
  *                                                                              
  * @pre Valid files and parameters have been passed to the contructor.          
  * @post Result file has been populated with records that meet the criteria     
  *    of the operation.                                                         
  */        
 void IndexScan::runOperation() {
-  // create key
-  Key *key_val = new Key(MAX_RECORD_SIZE);
-  SearchKeyFormat *key_format = index_file->getKeyFormat();
-  key_val->setKeyFormat(key_format);
-  key_val->setKeyFromValues(this->values);
-  // init scanner
-  HashIndexScanner scanner(index_file, key_val);
-
-  Record *rec = file_state.rec;
-  HeapFile* file = (HeapFile *)this->file_state.file;
-  HeapFile* out = (HeapFile *)this->result_state.file;
-
-  RecordId rid;
-  while( ( rid = scanner.getNext() ) != INVALID_RECORD_ID ){
-    // fetch full record from rid
-    file->getRecord(rid, rec);
-    // check conditions
-    bool passes = true;
-    for( size_t i = 0; i < fields.size(); ++i ){
-      if( !rec->compareFieldToValue( fields[i], values[i], comps[i] ) ){
-        passes = false;
-        break;
+  this->run_to_end = true;
+  this->_runScan();
+  this->run_to_end = false;
+}
+
+/**
+ * @brief Starts the scan by probing the index with the select's values.
+ *    The key and the scanner's memory are reused from the last scan. The
+ *    index is read under the buffer latch, since a prefetcher's read-ahead
+ *    thread may be pinning pages at the same time.
+ */
+void IndexScan::_openScan() {
+  this->key_val->setKeyFromValues(this->key_values);
+  std::lock_guard<std::mutex> guard(buffer_latch);
+  this->index_scanner = new (this->index_scanner_mem) HashIndexScanner(
+      this->index_file, this->key_val);
+
+  this->rid_batch.clear();
+  this->batch_pos = 0;
+  this->index_done = false;
+  this->bitmap_scan = false;
+  this->bitmap->clear();
+  this->prefetch_pos = 0;
+  this->holding_page = false;
+  this->prefetch_hits = 0;
+  this->prefetch_misses = 0;
+}
+
+/**
+ * @brief Reads the next record whose key matches in the index. RecordIds
+ *    are fetched in page order from the current batch, which is refilled
+ *    when it runs out. When prefetching, the pages of the RecordIds ahead
+ *    are requested first, and on moving to a new page the scan waits for
+ *    it and lets go of the one before.
+ *
+ * @param rec. Record * the record is read into.
+ *
+ * @return RecordId of the record, INVALID_RECORD_ID when the index has no
+ *    more entries for the key.
+ */
+RecordId IndexScan::_fetchNext(Record *rec) {
+  while( this->batch_pos == this->rid_batch.size() ){
+    if( !this->_fillBatch() ) return INVALID_RECORD_ID;
+  }
+  RecordId rid = this->rid_batch[this->batch_pos];
+  if( this->prefetcher != nullptr ){
+    this->_prefetchAhead();
+    if( this->_firstOnPage(this->batch_pos) ){
+      if( this->holding_page ){
+        this->prefetcher->release(this->held_page);
+      }
+      if( this->prefetcher->wait(rid.page_id) ){
+        this->prefetch_hits++;
+      }
+      else {
+        this->prefetch_misses++;
       }
+      this->held_page = rid.page_id;
+      this->holding_page = true;
     }
-    // insert record
-    if (passes) out->insertRecord(*rec);
   }
-  
-  delete key_val;
+  this->batch_pos++;
+  // fetch full record from rid, under the latch the prefetcher pins under
+  std::lock_guard<std::mutex> guard(buffer_latch);
+  ((HeapFile *)this->file_state.file)->getRecord(rid, rec);
+  return rid;
+}
+
+/**
+ * @brief Replaces the values of the conjuncts, including the values the
+ *    index is probed with.
+ *
+ * @pre The select is not open.
+ *
+ * @param values. Vector of void * lined up with the select's fields.
+ *
+ * @throw MismatchingFieldsRelOpsManager if values is not the size of the
+ *    select's fields.
+ */
+void IndexScan::bindValues(const std::vector<void *> &values) {
+  Select::bindValues(values);
+  for( size_t k = 0; k < this->key_pos.size(); k++ ){
+    this->key_values[k] = this->values[this->key_pos[k]];
+  }
+}
+
+/**
+ * @brief Sets the number of RecordIds read from the index per batch, which
+ *    is also the number of matches above which a bitmap heap scan is used.
+ *
+ * @param size. Number of RecordIds per batch; 0 is taken as 1.
+ */
+void IndexScan::setRidBatchSize(std::uint32_t size) {
+  this->rid_batch_size = size > 0 ? size : 1;
+}
+
+/**
+ * @brief Returns true if the last scan switched to a bitmap heap scan.
+ */
+bool IndexScan::isBitmapScan() {
+  return this->bitmap_scan;
+}
+
+/**
+ * @brief Turns on prefetching of heap pages: the pages of the next depth
+ *    RecordIds to fetch are requested from prefetcher ahead of their fetch.
+ *
+ * @param prefetcher. PagePrefetcher * to use, nullptr to turn it off.
+ * @param depth. Number of RecordIds to look ahead, at least 1.
+ */
+void IndexScan::setPrefetcher(PagePrefetcher *prefetcher,
+    std::uint32_t depth) {
+  this->prefetcher = prefetcher;
+  this->prefetch_depth = depth > 0 ? depth : 1;
+}
+
+/**
+ * @brief Returns the number of heap pages the last scan found already
+ *    prefetched when it got to them.
+ */
+std::uint64_t IndexScan::getNumPrefetchHits() {
+  return this->prefetch_hits;
+}
+
+/**
+ * @brief Returns the number of heap pages the last scan had to wait for or
+ *    read itself.
+ */
+std::uint64_t IndexScan::getNumPrefetchMisses() {
+  return this->prefetch_misses;
+}
+
+/**
+ * @brief Refills rid_batch with the next RecordIds to fetch, sorted by page
+ *    and slot so each heap page is read once for all of its matches in the
+ *    batch.
+ *
+ *    The first batch is read straight from the index. If the index still
+ *    has entries after it, the scan is being run to completion by
+ *    runOperation, and there is no match limit that could end it early,
+ *    the rest of the entries are drained into a bitmap of slots per page,
+ *    and from then on each batch is the matching slots of the next pages
+ *    in the bitmap, up to the batch size. The index is read under the
+ *    buffer latch.
+ *
+ * @return False if there are no more RecordIds to fetch.
+ */
+bool IndexScan::_fillBatch() {
+  this->rid_batch.clear();
+  this->batch_pos = 0;
+  this->prefetch_pos = 0;
+
+  if( this->bitmap_scan ){
+    while( this->rid_batch.size() < this->rid_batch_size &&
+        this->bitmap->nextPage(this->rid_batch) );
+    return !this->rid_batch.empty();
+  }
+
+  if( this->index_done ) return false;
+  std::unique_lock<std::mutex> guard(buffer_latch);
+  RecordId rid = INVALID_RECORD_ID;
+  while( this->rid_batch.size() < this->rid_batch_size && 
+      ( rid = this->index_scanner->getNext() ) != INVALID_RECORD_ID ){
+    this->rid_batch.push_back(rid);
+  }
+  if( rid == INVALID_RECORD_ID ){
+    this->index_done = true;
+  }
+  else if( this->run_to_end && this->match_limit == 0 ){
+    // many matches: build a bitmap of every matching slot and scan it
+    for( RecordId batch_rid : this->rid_batch ){
+      this->bitmap->add(batch_rid);
+    }
+    while( ( rid = this->index_scanner->getNext() ) != INVALID_RECORD_ID ){
+      this->bitmap->add(rid);
+    }
+    guard.unlock();
+    this->index_done = true;
+    this->bitmap_scan = true;
+    this->bitmap->startScan();
+    return this->_fillBatch();
+  }
+
+  std::sort(this->rid_batch.begin(), this->rid_batch.end(),
+      [](const RecordId &a, const RecordId &b){
+        return a.page_id.page_num < b.page_id.page_num ||
+          ( a.page_id.page_num == b.page_id.page_num &&
+            a.slot_id < b.slot_id );
+      });
+  return !this->rid_batch.empty();
+}
+
+/**
+ * @brief Returns true if the RecordId at pos in rid_batch is the first of
+ *    its page in the batch. Batches are in page order, so each page of a
+ *    batch is requested and waited for once.
+ */
+bool IndexScan::_firstOnPage(size_t pos) {
+  return pos == 0 || this->rid_batch[pos - 1].page_id.page_num != 
+    this->rid_batch[pos].page_id.page_num;
+}
+
+/**
+ * @brief Requests the pages of the RecordIds up to prefetch_depth past
+ *    batch_pos that have not been requested yet. The lookahead stops at the
+ *    end of the batch.
+ */
+void IndexScan::_prefetchAhead() {
+  size_t end = std::min(this->rid_batch.size(),
+      this->batch_pos + this->prefetch_depth);
+  for( ; this->prefetch_pos < end; this->prefetch_pos++ ){
+    if( this->_firstOnPage(this->prefetch_pos) ){
+      this->prefetcher->prefetch(
+          this->rid_batch[this->prefetch_pos].page_id);
+    }
+  }
+}
+
+/**
+ * @brief Releases every page requested and not yet read, which is left
+ *    over when a match limit ends the scan early, and the page being read.
+ */
+void IndexScan::_releasePrefetched() {
+  if( this->prefetcher == nullptr ) return;
+  for( size_t pos = this->batch_pos; pos < this->prefetch_pos; pos++ ){
+    if( this->_firstOnPage(pos) ){
+      this->prefetcher->release(this->rid_batch[pos].page_id);
+    }
+  }
+  this->prefetch_pos = this->batch_pos;
+  if( this->holding_page ){
+    this->prefetcher->release(this->held_page);
+    this->holding_page = false;
+  }
+}
+
+/**
+ * @brief Ends the index scan.
+ */
+void IndexScan::_closeScan() {
+  this->_releasePrefetched();
+  if( this->index_scanner != nullptr ){
+    std::lock_guard<std::mutex> guard(buffer_latch);
+    this->index_scanner->~HashIndexScanner();
+  }
+  this->index_scanner = nullptr;
+  this->bitmap->clear();
 }
\ No newline at end of file
@@ -24,6 +24,9 @@ class Data;
 class Key;
 class SearchKeyFormat;
 class HashIndexFile;
+class HashIndexScanner;
+class RidBitmap;
+class PagePrefetcher;
                                                                                 
 /**                                                                             
  * Select is an abstract class that lays the foundation for select operations   
@@ -41,6 +44,10 @@ class IndexScan : public Select {
       * @param comps. Vector of Comps for the select operation.
       * @param values. Vector of Void * for the select operation.
       * @param catalog. Catalog * for SwatDB.      
+      *
+      * @throw MismatchingFieldsRelOpsManager if some field of the index key
+      *    has no equality conjunct in the select. Any other conjuncts are
+      *    checked as residual filters on the fetched records.
       */     
     IndexScan(FileId rel_id, FileId index_id, FileId result_id, 
               std::vector<FieldId> fields, 
@@ -62,13 +69,183 @@ class IndexScan : public Select {
      *    of the operation.                                                     
      */                                                                         
     void runOperation();                                                        
+
+    /**
+     * @brief Replaces the values of the conjuncts, including the values
+     *    the index is probed with. Does not allocate.
+     *
+     * @pre The select is not open.
+     *
+     * @param values. Vector of void * lined up with the select's fields.
+     *
+     * @throw MismatchingFieldsRelOpsManager if values is not the size of
+     *    the select's fields.
+     */
+    void bindValues(const std::vector<void *> &values);
+
+    /**
+     * @brief Sets the number of RecordIds read from the index per batch,
+     *    which is also the number of matches above which a bitmap heap scan
+     *    is used.
+     *
+     * @param size. Number of RecordIds per batch; 0 is taken as 1.
+     */
+    void setRidBatchSize(std::uint32_t size);
+
+    /**
+     * @brief Returns true if the last scan switched to a bitmap heap scan.
+     */
+    bool isBitmapScan();
+
+    /**
+     * @brief Turns on prefetching of heap pages: the pages of the next
+     *    depth RecordIds to fetch are requested from prefetcher ahead of
+     *    their fetch.
+     *
+     * @param prefetcher. PagePrefetcher * to use, nullptr to turn it off.
+     * @param depth. Number of RecordIds to look ahead, at least 1.
+     */
+    void setPrefetcher(PagePrefetcher *prefetcher, std::uint32_t depth);
+
+    /**
+     * @brief Returns the number of heap pages the last scan found already
+     *    prefetched when it got to them.
+     */
+    std::uint64_t getNumPrefetchHits();
+
+    /**
+     * @brief Returns the number of heap pages the last scan had to wait
+     *    for or read itself.
+     */
+    std::uint64_t getNumPrefetchMisses();
+
+  protected:
+
+    /**
+     * @brief Starts the scan by probing the index with the select's values.
+     */
+    void _openScan();
+
+    /**
+     * @brief Reads the next record whose key matches in the index.
+     *
+     * @param rec. Record * the record is read into.
+     *
+     * @return RecordId of the record, INVALID_RECORD_ID when the index has
+     *    no more entries for the key.
+     */
+    RecordId _fetchNext(Record *rec);
+
+    /**
+     * @brief Ends the index scan.
+     */
+    void _closeScan();
                                                                                 
   private:                                                                      
+
+    /**
+     * @brief Refills rid_batch with the next RecordIds to fetch, sorted by
+     *    page so each heap page is read once for all of its matches.
+     *
+     * @return False if there are no more RecordIds to fetch.
+     */
+    bool _fillBatch();
+
+    /**
+     * @brief Returns true if the RecordId at pos in rid_batch is the first
+     *    of its page in the batch.
+     */
+    bool _firstOnPage(size_t pos);
+
+    /**
+     * @brief Requests the pages of the RecordIds up to prefetch_depth past
+     *    batch_pos that have not been requested yet.
+     */
+    void _prefetchAhead();
+
+    /**
+     * @brief Releases every page requested and not yet read, and the page
+     *    being read.
+     */
+    void _releasePrefetched();
                                                                                 
     /**
      * HashIndex * for the index file being selected on. 
      */
     HashIndexFile *index_file;
+
+    /**
+     * Values of the equality conjuncts on the index key, in key field order,
+     * and the positions of those conjuncts in values
+     */
+    std::vector<void *> key_values;
+    std::vector<std::uint32_t> key_pos;
+
+    /**
+     * Key probed for, and scanner over its entries (nullptr when not
+     * scanning). Both are allocated once and reused by every scan: the
+     * scanner is built in index_scanner_mem.
+     */
+    Key *key_val;
+    HashIndexScanner *index_scanner;
+    void *index_scanner_mem;
+
+    /**
+     * RecordIds of the current batch in fetch order, the position of the
+     * next one to fetch, and the maximum batch size
+     */
+    std::vector<RecordId> rid_batch;
+    size_t batch_pos;
+    std::uint32_t rid_batch_size;
+
+    /**
+     * True once every entry for the key has been read from the index
+     */
+    bool index_done;
+
+    /**
+     * True if the scan switched to a bitmap heap scan
+     */
+    bool bitmap_scan;
+
+    /**
+     * True while runOperation runs the scan to completion. Only then may
+     * it switch to a bitmap heap scan; a cursor pulling matches one at a
+     * time keeps reading the index a batch at a time, so its first match
+     * does not wait for every entry of the key.
+     */
+    bool run_to_end;
+
+    /**
+     * Every matching RecordId, for a bitmap heap scan
+     */
+    RidBitmap *bitmap;
+
+    /**
+     * Prefetcher of heap pages, nullptr if not prefetching, and the number
+     * of RecordIds it looks ahead
+     */
+    PagePrefetcher *prefetcher;
+    std::uint32_t prefetch_depth;
+
+    /**
+     * Position in rid_batch of the next RecordId whose page is to be
+     * requested
+     */
+    size_t prefetch_pos;
+
+    /**
+     * Page of the RecordIds being fetched, held from the prefetcher until
+     * the scan moves to the next page
+     */
+    PageId held_page;
+    bool holding_page;
+
+    /**
+     * Prefetch hits and misses of the current scan
+     */
+    std::uint64_t prefetch_hits;
+    std::uint64_t prefetch_misses;
                                                                                 
 };     
 
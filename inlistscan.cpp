@@ -0,0 +1,168 @@
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include "swatdb_exceptions.h"
+#include "swatdb_types.h"
+#include "inlistscan.h"
+#include "recordlayout.h"
+#include "ridbitmap.h"
+#include "key.h"
+#include "record.h"
+#include "heapfile.h"
+#include "catalog.h"
+#include "searchkeyformat.h"
+#include "hashindexscanner.h"
+#include "hashindexfile.h"
+
+/**
+ * @brief Constructor for InListScan select operation. The list is reduced
+ *    to its distinct values, and with an index the Key used for every probe
+ *    is created here.
+ *
+ * @param rel_id. FileId of the relation file.
+ * @param index_id. FileId of a hash index on field, INVALID_FILE_ID to scan
+ *    the relation.
+ * @param result_id. FileId of the result file.
+ * @param field. FieldId of the field compared to the list.
+ * @param in_values. Vector of void * to the values of the list.
+ * @param catalog. Catalog * for SwatDB.
+ *
+ * @throw MismatchingFieldsRelOpsManager if field is not a field of the
+ *    relation, or the index is not on field alone.
+ * @throw InvalidFileIdRelOpsManager if the index does not exist or is not
+ *    on the relation.
+ */
+InListScan::InListScan(FileId rel_id, FileId index_id, FileId result_id,
+    FieldId field, std::vector<void *> in_values, Catalog *catalog) :
+    Select(rel_id, result_id, {}, {}, {}, catalog) {
+
+  if( field >= this->layout->getNumFields() ){
+    throw MismatchingFieldsRelOpsManager();
+  }
+  this->in_field = this->layout->getField(field);
+  this->index_file = nullptr;
+  this->key_val = nullptr;
+  this->bitmap = nullptr;
+  this->batch_pos = 0;
+
+  std::string norm;
+  for( void *val : in_values ){
+    RecordLayout::normalizeValue(this->in_field, (const char *)val, norm);
+    if( this->value_set.insert(norm).second ){
+      this->probe_values.push_back(val);
+    }
+  }
+
+  if( index_id == INVALID_FILE_ID ) return;
+
+  this->index_file = (HashIndexFile *)catalog->getFile(index_id);
+  if( this->index_file == nullptr ){
+    throw InvalidFileIdRelOpsManager();
+  }
+  if( catalog->getRelationFileId(index_id) != rel_id ){
+    throw InvalidFileIdRelOpsManager();
+  }
+  SearchKeyFormat *key_format = this->index_file->getKeyFormat();
+  if( key_format->getFieldList() != std::vector<FieldId>{field} ){
+    throw MismatchingFieldsRelOpsManager();
+  }
+  this->key_val = new Key(MAX_RECORD_SIZE);
+  this->key_val->setKeyFormat(key_format);
+  this->bitmap = new RidBitmap(rel_id);
+}
+
+/**
+ * @brief Destructor for InListScan.
+ */
+InListScan::~InListScan() {
+  delete this->key_val;
+  delete this->bitmap;
+}
+
+/**
+ * @brief Runs the IN-list select operation.
+ *
+ * @pre Valid files and parameters have been passed to the contructor.
+ * @post Result file has been populated with records that meet the criteria
+ *    of the operation.
+ */
+void InListScan::runOperation() {
+  this->_runScan();
+}
+
+/**
+ * @brief Returns the number of distinct values in the list.
+ */
+std::uint32_t InListScan::getNumProbes() {
+  return this->probe_values.size();
+}
+
+/**
+ * @brief Starts the scan. With an index, every distinct value is probed
+ *    with the same Key and the RecordIds of all the probes are added to the
+ *    bitmap, so records matched by several values are fetched once and the
+ *    fetches go in page order. Without an index a heap file scan is
+ *    started.
+ */
+void InListScan::_openScan() {
+  if( this->index_file == nullptr ){
+    Select::_openScan();
+    return;
+  }
+  this->bitmap->clear();
+  std::vector<void *> probe(1);
+  for( void *val : this->probe_values ){
+    probe[0] = val;
+    this->key_val->setKeyFromValues(probe);
+    HashIndexScanner scanner(this->index_file, this->key_val);
+    RecordId rid;
+    while( ( rid = scanner.getNext() ) != INVALID_RECORD_ID ){
+      this->bitmap->add(rid);
+    }
+  }
+  this->bitmap->startScan();
+  this->rid_batch.clear();
+  this->batch_pos = 0;
+}
+
+/**
+ * @brief Reads the next record whose value is in the list: the next
+ *    RecordId of the bitmap with an index, or the next record of the heap
+ *    file scan that is in the hash set without one.
+ *
+ * @param rec. Record * the record is read into.
+ *
+ * @return RecordId of the record, INVALID_RECORD_ID at the end.
+ */
+RecordId InListScan::_fetchNext(Record *rec) {
+  if( this->index_file == nullptr ){
+    const char *val = RecordLayout::getBytes(rec) + this->in_field.offset;
+    RecordId rid;
+    while( ( rid = Select::_fetchNext(rec) ) != INVALID_RECORD_ID ){
+      RecordLayout::normalizeValue(this->in_field, val, this->scratch);
+      if( this->value_set.count(this->scratch) ) break;
+    }
+    return rid;
+  }
+
+  while( this->batch_pos == this->rid_batch.size() ){
+    this->rid_batch.clear();
+    this->batch_pos = 0;
+    if( !this->bitmap->nextPage(this->rid_batch) ) return INVALID_RECORD_ID;
+  }
+  RecordId rid = this->rid_batch[this->batch_pos++];
+  ((HeapFile *)this->file_state.file)->getRecord(rid, rec);
+  return rid;
+}
+
+/**
+ * @brief Ends the scan.
+ */
+void InListScan::_closeScan() {
+  if( this->index_file == nullptr ){
+    Select::_closeScan();
+    return;
+  }
+  this->bitmap->clear();
+}
+
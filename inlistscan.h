@@ -0,0 +1,133 @@
+#ifndef _SWATDB_INLISTSCAN_H_
+#define _SWATDB_INLISTSCAN_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include "swatdb_types.h"
+#include "select.h"
+
+class Catalog;
+class Record;
+class Key;
+class HashIndexFile;
+class RidBitmap;
+
+/**
+ * InListScan selects the records whose value of one field is in a list of
+ * values (field IN (v1, ..., vK)), writing all of them to one result file.
+ * With a hash index on the field, every distinct value is probed in one
+ * pass that reuses a single Key, the RecordIds of all the probes are
+ * collected in a RidBitmap, and the records are then fetched in page
+ * order. Without an index the relation is scanned once and each record's
+ * value is looked up in a hash set of the list.
+ */
+class InListScan : public Select {
+
+  public:
+
+    /**
+     * @brief Constructor for InListScan select operation.
+     *
+     * @param rel_id. FileId of the relation file.
+     * @param index_id. FileId of a hash index on field, INVALID_FILE_ID to
+     *    scan the relation.
+     * @param result_id. FileId of the result file.
+     * @param field. FieldId of the field compared to the list.
+     * @param in_values. Vector of void * to the values of the list.
+     * @param catalog. Catalog * for SwatDB.
+     *
+     * @throw MismatchingFieldsRelOpsManager if field is not a field of the
+     *    relation, or the index is not on field alone.
+     * @throw InvalidFileIdRelOpsManager if the index does not exist or is
+     *    not on the relation.
+     */
+    InListScan(FileId rel_id, FileId index_id, FileId result_id,
+        FieldId field, std::vector<void *> in_values, Catalog *catalog);
+
+    /**
+     * @brief Destructor for InListScan.
+     */
+    ~InListScan();
+
+    /**
+     * @brief Runs the IN-list select operation.
+     *
+     * @pre Valid files and parameters have been passed to the contructor.
+     * @post Result file has been populated with records that meet the
+     *    criteria of the operation.
+     */
+    void runOperation();
+
+    /**
+     * @brief Returns the number of distinct values in the list, which is
+     *    the number of index probes made by a run with an index.
+     */
+    std::uint32_t getNumProbes();
+
+  protected:
+
+    /**
+     * @brief Starts the scan. With an index every distinct value is probed
+     *    here and the matching RecordIds collected.
+     */
+    void _openScan();
+
+    /**
+     * @brief Reads the next record whose value is in the list.
+     *
+     * @param rec. Record * the record is read into.
+     *
+     * @return RecordId of the record, INVALID_RECORD_ID at the end.
+     */
+    RecordId _fetchNext(Record *rec);
+
+    /**
+     * @brief Ends the scan.
+     */
+    void _closeScan();
+
+  private:
+
+    /**
+     * Layout of the field compared to the list
+     */
+    FieldLayout in_field;
+
+    /**
+     * One value of each distinct value in the list, and their forms from
+     * RecordLayout::normalizeValue
+     */
+    std::vector<void *> probe_values;
+    std::unordered_set<std::string> value_set;
+
+    /**
+     * Hash index on the field, nullptr to scan the relation
+     */
+    HashIndexFile *index_file;
+
+    /**
+     * Key reused for every probe
+     */
+    Key *key_val;
+
+    /**
+     * RecordIds matched by the probes, the current page of them and the
+     * position of the next one to fetch
+     */
+    RidBitmap *bitmap;
+    std::vector<RecordId> rid_batch;
+    size_t batch_pos;
+
+    /**
+     * Reused buffer for the normalized value of each scanned record
+     */
+    std::string scratch;
+
+};
+
+#endif
@@ -0,0 +1,182 @@
+#include <string>
+#include <vector>
+#include "swatdb_exceptions.h"
+#include "swatdb_types.h"
+#include "multiindexscan.h"
+#include "ridbitmap.h"
+#include "key.h"
+#include "record.h"
+#include "heapfile.h"
+#include "catalog.h"
+#include "searchkeyformat.h"
+#include "hashindexscanner.h"
+#include "hashindexfile.h"
+
+/**
+ * @brief Constructor for MultiIndexScan select operation. Each index, in
+ *    order, takes the first unused EQUAL conjunct on each of its key fields;
+ *    the probes guarantee those conjuncts, so only the others are left in
+ *    the order checked after each fetch.
+ *
+ * @param rel_id. FileId of the relation file.
+ * @param index_ids. Vector of FileIds of hash indexes on the relation.
+ * @param result_id. FileId of the result file.
+ * @param fields. Vector of field ids for the select operation.
+ * @param comps. Vector of Comps for the select operation.
+ * @param values. Vector of Void * for the select operation.
+ * @param op. RidBitmapOp combining the indexes' RecordIds.
+ * @param catalog. Catalog * for SwatDB.
+ *
+ * @throw InvalidFileIdRelOpsManager if an index does not exist or is not on
+ *    the relation.
+ * @throw MismatchingFieldsRelOpsManager if no index ids are given, or some
+ *    field of an index key has no unused equality conjunct.
+ */
+MultiIndexScan::MultiIndexScan(FileId rel_id, std::vector<FileId> index_ids,
+    FileId result_id, std::vector<FieldId> fields, std::vector<Comp> comps,
+    std::vector<void *> values, RidBitmapOp op, Catalog *catalog) :
+    Select(rel_id, result_id, fields, comps, values, catalog) {
+
+  if( index_ids.empty() ){
+    throw MismatchingFieldsRelOpsManager();
+  }
+  std::vector<bool> is_key(fields.size(), false);
+  for( FileId index_id : index_ids ){
+    HashIndexFile *index_file = (HashIndexFile *)catalog->getFile(index_id);
+    if( index_file == nullptr ){
+      throw InvalidFileIdRelOpsManager();
+    }
+    if( catalog->getRelationFileId(index_id) != rel_id ){
+      throw InvalidFileIdRelOpsManager();
+    }
+    SearchKeyFormat *format = index_file->getKeyFormat();
+    std::vector<void *> index_values;
+    for( FieldId key_fid : format->getFieldList() ){
+      size_t i = 0;
+      while( i < fields.size() && 
+          ( is_key[i] || fields[i] != key_fid || comps[i] != EQUAL ) ){
+        i++;
+      }
+      if( i == fields.size() ){
+        throw MismatchingFieldsRelOpsManager();
+      }
+      is_key[i] = true;
+      index_values.push_back(values[i]);
+    }
+    this->index_files.push_back(index_file);
+    this->key_values.push_back(index_values);
+  }
+  this->order.clear();
+  for( std::uint32_t i = 0; i < fields.size(); i++ ){
+    if( !is_key[i] ) this->order.push_back(i);
+  }
+
+  for( HashIndexFile *index_file : this->index_files ){
+    Key *key = new Key(MAX_RECORD_SIZE);
+    key->setKeyFormat(index_file->getKeyFormat());
+    this->keys.push_back(key);
+  }
+  this->op = op;
+  this->bitmap = new RidBitmap(rel_id);
+  this->probe_bitmap = new RidBitmap(rel_id);
+  this->batch_pos = 0;
+  this->num_candidates = 0;
+}
+
+/**
+ * @brief Destructor for MultiIndexScan.
+ */
+MultiIndexScan::~MultiIndexScan() {
+  for( Key *key : this->keys ){
+    delete key;
+  }
+  delete this->bitmap;
+  delete this->probe_bitmap;
+}
+
+/**
+ * @brief Runs the multi index select operation.
+ *
+ * @pre Valid files and parameters have been passed to the contructor.
+ * @post Result file has been populated with records that meet the criteria
+ *    of the operation.
+ */
+void MultiIndexScan::runOperation() {
+  this->_runScan();
+}
+
+/**
+ * @brief Returns the number of RecordIds left after combining the bitmaps
+ *    in the last run.
+ */
+std::uint64_t MultiIndexScan::getNumCandidates() {
+  return this->num_candidates;
+}
+
+/**
+ * @brief Starts the scan by probing every index and combining their
+ *    bitmaps. An intersection stops probing once it is empty, since no
+ *    record can survive it.
+ */
+void MultiIndexScan::_openScan() {
+  this->bitmap->clear();
+  this->_probe(0, this->bitmap);
+  for( std::uint32_t i = 1; i < this->index_files.size(); i++ ){
+    if( this->op == RidAndT && this->bitmap->getNumRids() == 0 ) break;
+    this->probe_bitmap->clear();
+    this->_probe(i, this->probe_bitmap);
+    if( this->op == RidAndT ){
+      this->bitmap->intersectWith(*this->probe_bitmap);
+    }
+    else {
+      this->bitmap->unionWith(*this->probe_bitmap);
+    }
+  }
+  this->num_candidates = this->bitmap->getNumRids();
+  this->bitmap->startScan();
+  this->rid_batch.clear();
+  this->batch_pos = 0;
+}
+
+/**
+ * @brief Reads the record of the next surviving RecordId, a page of them at
+ *    a time.
+ *
+ * @param rec. Record * the record is read into.
+ *
+ * @return RecordId of the record, INVALID_RECORD_ID at the end.
+ */
+RecordId MultiIndexScan::_fetchNext(Record *rec) {
+  while( this->batch_pos == this->rid_batch.size() ){
+    this->rid_batch.clear();
+    this->batch_pos = 0;
+    if( !this->bitmap->nextPage(this->rid_batch) ) return INVALID_RECORD_ID;
+  }
+  RecordId rid = this->rid_batch[this->batch_pos++];
+  ((HeapFile *)this->file_state.file)->getRecord(rid, rec);
+  return rid;
+}
+
+/**
+ * @brief Ends the scan.
+ */
+void MultiIndexScan::_closeScan() {
+  this->bitmap->clear();
+  this->probe_bitmap->clear();
+}
+
+/**
+ * @brief Probes one index with its key and adds the RecordIds found to a
+ *    bitmap.
+ *
+ * @param i. Position of the index in index_files.
+ * @param out. RidBitmap the RecordIds are added to.
+ */
+void MultiIndexScan::_probe(std::uint32_t i, RidBitmap *out) {
+  this->keys[i]->setKeyFromValues(this->key_values[i]);
+  HashIndexScanner scanner(this->index_files[i], this->keys[i]);
+  RecordId rid;
+  while( ( rid = scanner.getNext() ) != INVALID_RECORD_ID ){
+    out->add(rid);
+  }
+}
@@ -0,0 +1,142 @@
+#ifndef _SWATDB_MULTIINDEXSCAN_H_
+#define _SWATDB_MULTIINDEXSCAN_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include "swatdb_types.h"
+#include "select.h"
+#include "ridbitmap.h"
+
+class Catalog;
+class Record;
+class Key;
+class HashIndexFile;
+
+/**
+ * MultiIndexScan is a select that uses several hash indexes on the same
+ * relation. Each index is probed with the equality conjuncts on its key and
+ * its RecordIds are collected in a RidBitmap. The bitmaps are intersected
+ * (RidAndT) or united (RidOrT), and only the RecordIds that survive are
+ * fetched, in page order. Conjuncts not used by any index are checked on
+ * the fetched records.
+ */
+class MultiIndexScan : public Select {
+
+  public:
+
+    /**
+     * @brief Constructor for MultiIndexScan select operation. Each index,
+     *    in order, takes the first unused EQUAL conjunct on each of its key
+     *    fields.
+     *
+     *    With RidAndT the select is every conjunct ANDed, as for the other
+     *    selects. With RidOrT the key conjuncts of each index form one
+     *    alternative: the select is (index 1's conjuncts OR index 2's
+     *    conjuncts OR ...) AND the remaining conjuncts.
+     *
+     * @param rel_id. FileId of the relation file.
+     * @param index_ids. Vector of FileIds of hash indexes on the relation.
+     * @param result_id. FileId of the result file.
+     * @param fields. Vector of field ids for the select operation.
+     * @param comps. Vector of Comps for the select operation.
+     * @param values. Vector of Void * for the select operation.
+     * @param op. RidBitmapOp combining the indexes' RecordIds.
+     * @param catalog. Catalog * for SwatDB.
+     *
+     * @throw InvalidFileIdRelOpsManager if an index does not exist or is not
+     *    on the relation.
+     * @throw MismatchingFieldsRelOpsManager if no index ids are given, or
+     *    some field of an index key has no unused equality conjunct.
+     */
+    MultiIndexScan(FileId rel_id, std::vector<FileId> index_ids,
+        FileId result_id, std::vector<FieldId> fields,
+        std::vector<Comp> comps, std::vector<void *> values, RidBitmapOp op,
+        Catalog *catalog);
+
+    /**
+     * @brief Destructor for MultiIndexScan.
+     */
+    ~MultiIndexScan();
+
+    /**
+     * @brief Runs the multi index select operation.
+     *
+     * @pre Valid files and parameters have been passed to the contructor.
+     * @post Result file has been populated with records that meet the
+     *    criteria of the operation.
+     */
+    void runOperation();
+
+    /**
+     * @brief Returns the number of RecordIds left after combining the
+     *    bitmaps in the last run, which is the number of records fetched.
+     */
+    std::uint64_t getNumCandidates();
+
+  protected:
+
+    /**
+     * @brief Starts the scan by probing every index and combining their
+     *    bitmaps.
+     */
+    void _openScan();
+
+    /**
+     * @brief Reads the record of the next surviving RecordId.
+     *
+     * @param rec. Record * the record is read into.
+     *
+     * @return RecordId of the record, INVALID_RECORD_ID at the end.
+     */
+    RecordId _fetchNext(Record *rec);
+
+    /**
+     * @brief Ends the scan.
+     */
+    void _closeScan();
+
+  private:
+
+    /**
+     * @brief Probes one index with its key and adds the RecordIds found to
+     *    a bitmap.
+     */
+    void _probe(std::uint32_t i, RidBitmap *out);
+
+    /**
+     * Hash indexes probed, each one's Key, and the values of the conjuncts
+     * on its key fields in key field order
+     */
+    std::vector<HashIndexFile *> index_files;
+    std::vector<Key *> keys;
+    std::vector<std::vector<void *>> key_values;
+
+    /**
+     * How the bitmaps are combined
+     */
+    RidBitmapOp op;
+
+    /**
+     * Combined RecordIds and the bitmap each probe is read into
+     */
+    RidBitmap *bitmap;
+    RidBitmap *probe_bitmap;
+
+    /**
+     * RecordIds of the current page and the position of the next one
+     */
+    std::vector<RecordId> rid_batch;
+    size_t batch_pos;
+
+    /**
+     * Number of RecordIds left after combining the bitmaps
+     */
+    std::uint64_t num_candidates;
+
+};
+
+#endif
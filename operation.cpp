@@ -10,31 +10,77 @@
 #include "schema.h"
 #include "key.h"
 #include "searchkeyformat.h"
+#include "resultwriter.h"
 
 /**
  * @brief Constructor for the Operation class. Because Operation is an abstract 
  *    class, an object cannot be created, but this constructor is used by 
  *    derived classes. 
  *
- * @pre result_id is the id of a valid newly created result file.
+ * @pre result_id is the id of a valid newly created result file, or
+ *    INVALID_FILE_ID for an operation that produces no result file.
  *
  * @param result_name std::string of a newly created result file
  */
 Operation::Operation(FileId result_id, Catalog *catalog){  
   this->catalog = catalog;
+  this->buf_mgr = nullptr;
+  if( result_id == INVALID_FILE_ID ){
+    this->result_state = {nullptr, INVALID_FILE_ID, nullptr, nullptr,
+      INVALID_RECORD_ID, nullptr};
+    this->result_writer = nullptr;
+    return;
+  }
   this->_initState(result_id, {}, &this->result_state);
+  this->result_writer = new ResultWriter(&this->result_state);
 }
 
 /**
  * @brief Destructor for the Operation class. Cleans up dynamic memory in
- *    result state.
+ *    result state and the result writer.
  */
 Operation::~Operation() {
   
+  delete this->result_writer;
   this->_delState(&result_state);
 }
 
 
+/**
+ * @brief Sets a zone map for the result file that is kept up to date as
+ *    records are written to the result.
+ *
+ * @pre The operation has a result file.
+ *
+ * @param zone_map ZoneMap * for the result file
+ */
+void Operation::setResultZoneMap(ZoneMap *zone_map) {
+  this->result_writer->setZoneMap(zone_map);
+}
+
+/**
+ * @brief Sets a columnar copy of the result file that is kept up to date as
+ *    records are written to the result.
+ *
+ * @pre The operation has a result file.
+ *
+ * @param pax_file PaxFile * for the result file
+ */
+void Operation::setResultPaxFile(PaxFile *pax_file) {
+  this->result_writer->setPaxFile(pax_file);
+}
+
+/**
+ * @brief Gives the operation the buffer manager, so scans can read heap
+ *    pages in place instead of copying each record out.
+ *
+ * @param buf_mgr BufferManager * of SwatDB, nullptr for none
+ */
+void Operation::setBufferManager(BufferManager *buf_mgr) {
+  this->buf_mgr = buf_mgr;
+}
+
+
 /**
  * @brief Performs the file and temporary record setup for relational 
  *    operators.  
@@ -22,6 +22,10 @@ class HeapFileScanner;
 class Record;
 class Data;
 class Key;
+class ResultWriter;
+class ZoneMap;
+class PaxFile;
+class BufferManager;
 
   // NOTE:  Do not modify this struct
 
@@ -73,7 +77,8 @@ class Operation {
      * abstract class, an object cannot be created, but this constructor is
      * used by derived classes. 
      *
-     * @pre result_id is the id of a valid newly created result file.
+     * @pre result_id is the id of a valid newly created result file, or
+     *    INVALID_FILE_ID for an operation that produces no result file.
      *
      * @param result_name std::string of a newly created result file
      */
@@ -81,7 +86,7 @@ class Operation {
 
     /**
      * @brief Destructor for the Operation class. Cleans up dynamic memory in
-     *    result state.
+     *    result state and the result writer.
      */
     virtual ~Operation();
 
@@ -98,6 +103,34 @@ class Operation {
      */
     virtual void runOperation() = 0;
 
+    /**
+     * @brief Sets a zone map for the result file that is kept up to date as
+     *    records are written to the result.
+     *
+     * @pre The operation has a result file.
+     *
+     * @param zone_map ZoneMap * for the result file
+     */
+    void setResultZoneMap(ZoneMap *zone_map);
+
+    /**
+     * @brief Sets a columnar copy of the result file that is kept up to
+     *    date as records are written to the result.
+     *
+     * @pre The operation has a result file.
+     *
+     * @param pax_file PaxFile * for the result file
+     */
+    void setResultPaxFile(PaxFile *pax_file);
+
+    /**
+     * @brief Gives the operation the buffer manager, so scans can read
+     *    heap pages in place instead of copying each record out.
+     *
+     * @param buf_mgr BufferManager * of SwatDB, nullptr for none
+     */
+    void setBufferManager(BufferManager *buf_mgr);
+
 
   protected:
     /**
@@ -133,12 +166,25 @@ class Operation {
      */
     fileState result_state;
 
+    /*
+     * Adds records to the result file. Operators add their output through
+     * this, one record at a time.
+     * nullptr if the operation has no result file.
+     */
+    ResultWriter *result_writer;
+
 
     /*
      * Catalog for SwatDB
      */
     Catalog *catalog;
 
+    /*
+     * Buffer manager for SwatDB, nullptr if the operation was not given
+     * one, in which case it reads records through HeapFileScanner
+     */
+    BufferManager *buf_mgr;
+
 };
 
 #endif
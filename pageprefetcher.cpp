@@ -0,0 +1,216 @@
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "swatdb_exceptions.h"
+#include "swatdb_types.h"
+#include "pageprefetcher.h"
+#include "bufmgr.h"
+#include "bufferlatch.h"
+#include "page.h"
+
+/**
+ * @brief Constructor for PagePrefetcher. Starts the read-ahead thread.
+ *
+ * @param buf_mgr. BufferManager * pages are read into.
+ */
+PagePrefetcher::PagePrefetcher(BufferManager *buf_mgr) {
+  this->buf_mgr = buf_mgr;
+  this->stopping = false;
+  this->num_issued = 0;
+  this->num_hits = 0;
+  this->num_misses = 0;
+  this->worker = std::thread(&PagePrefetcher::_worker, this);
+}
+
+/**
+ * @brief Destructor for PagePrefetcher. Stops the read-ahead thread,
+ *    dropping any reads not started, and unpins the pages still held under
+ *    the buffer latch.
+ */
+PagePrefetcher::~PagePrefetcher() {
+  {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->stopping = true;
+  }
+  this->work_ready.notify_all();
+  this->worker.join();
+  std::lock_guard<std::mutex> guard(buffer_latch);
+  for( auto &entry : this->pages ){
+    if( entry.second.state == PrefetchLoadedT ){
+      this->buf_mgr->releasePage(entry.second.page_id, false);
+    }
+  }
+}
+
+/**
+ * @brief Requests that a page be read into the buffer pool. The first
+ *    request for a page queues its read; later ones only add a reference.
+ *    Every request must be matched by a release.
+ *
+ * @param page_id. PageId of the page.
+ */
+void PagePrefetcher::prefetch(PageId page_id) {
+  std::lock_guard<std::mutex> guard(this->lock);
+  auto found = this->pages.find(_key(page_id));
+  if( found != this->pages.end() ){
+    found->second.refs++;
+    return;
+  }
+  PrefetchEntry entry;
+  entry.page_id = page_id;
+  entry.state = PrefetchQueuedT;
+  entry.refs = 1;
+  this->pages[_key(page_id)] = entry;
+  this->queue.push_back(page_id);
+  this->num_issued++;
+  this->work_ready.notify_one();
+}
+
+/**
+ * @brief Called before reading a requested page. A page whose read has not
+ *    started is taken off the queue, since the caller will block on it no
+ *    matter who reads it; a page being read is waited for.
+ *
+ * @param page_id. PageId of the page.
+ *
+ * @return True if the page was already in the buffer pool (a hit), False
+ *    otherwise (a miss).
+ */
+bool PagePrefetcher::wait(PageId page_id) {
+  std::unique_lock<std::mutex> guard(this->lock);
+  auto found = this->pages.find(_key(page_id));
+  if( found == this->pages.end() ){
+    this->num_misses++;
+    return false;
+  }
+  PrefetchEntry &entry = found->second;
+  if( entry.state == PrefetchLoadedT ){
+    this->num_hits++;
+    return true;
+  }
+  if( entry.state == PrefetchQueuedT ){
+    // the read-ahead thread skips pages that are no longer queued
+    entry.state = PrefetchFailedT;
+  }
+  while( entry.state == PrefetchLoadingT ){
+    this->page_ready.wait(guard);
+  }
+  this->num_misses++;
+  return false;
+}
+
+/**
+ * @brief Releases one request for a page. Once every request is released a
+ *    read page is unpinned, under the buffer latch; a page still being read
+ *    is left for the read-ahead thread to unpin.
+ *
+ * @param page_id. PageId of the page.
+ */
+void PagePrefetcher::release(PageId page_id) {
+  bool unpin = false;
+  {
+    std::lock_guard<std::mutex> guard(this->lock);
+    auto found = this->pages.find(_key(page_id));
+    if( found == this->pages.end() ) return;
+    PrefetchEntry &entry = found->second;
+    entry.refs--;
+    if( entry.refs > 0 || entry.state == PrefetchLoadingT ) return;
+    unpin = entry.state == PrefetchLoadedT;
+    this->pages.erase(found);
+  }
+  if( unpin ){
+    std::lock_guard<std::mutex> guard(buffer_latch);
+    this->buf_mgr->releasePage(page_id, false);
+  }
+}
+
+/**
+ * @brief Returns the number of page reads issued.
+ */
+std::uint64_t PagePrefetcher::getNumIssued() {
+  std::lock_guard<std::mutex> guard(this->lock);
+  return this->num_issued;
+}
+
+/**
+ * @brief Returns the number of waits that found their page read.
+ */
+std::uint64_t PagePrefetcher::getNumHits() {
+  std::lock_guard<std::mutex> guard(this->lock);
+  return this->num_hits;
+}
+
+/**
+ * @brief Returns the number of waits that did not.
+ */
+std::uint64_t PagePrefetcher::getNumMisses() {
+  std::lock_guard<std::mutex> guard(this->lock);
+  return this->num_misses;
+}
+
+/**
+ * @brief Body of the read-ahead thread. Takes the next queued page, pins
+ *    it in the buffer pool under the buffer latch rather than the
+ *    prefetcher's lock, and marks it read. A page whose requests were all
+ *    released meanwhile is unpinned again. A page that
+ *    cannot be pinned (the buffer pool is full of pinned pages) is marked
+ *    failed and read by the scan itself.
+ */
+void PagePrefetcher::_worker() {
+  while( true ){
+    PageId page_id;
+    {
+      std::unique_lock<std::mutex> guard(this->lock);
+      while( !this->stopping && this->queue.empty() ){
+        this->work_ready.wait(guard);
+      }
+      if( this->stopping ) return;
+      page_id = this->queue.front();
+      this->queue.pop_front();
+      auto found = this->pages.find(_key(page_id));
+      if( found == this->pages.end() || 
+          found->second.state != PrefetchQueuedT ){
+        continue;
+      }
+      found->second.state = PrefetchLoadingT;
+    }
+
+    bool pinned = true;
+    try {
+      std::lock_guard<std::mutex> latch(buffer_latch);
+      this->buf_mgr->getPage(page_id);
+    }
+    catch( SwatDBException &e ){
+      pinned = false;
+    }
+
+    bool unpin = false;
+    {
+      std::lock_guard<std::mutex> guard(this->lock);
+      auto found = this->pages.find(_key(page_id));
+      if( found->second.refs == 0 ){
+        unpin = pinned;
+        this->pages.erase(found);
+      }
+      else {
+        found->second.state = pinned ? PrefetchLoadedT : PrefetchFailedT;
+      }
+    }
+    this->page_ready.notify_all();
+    if( unpin ){
+      std::lock_guard<std::mutex> latch(buffer_latch);
+      this->buf_mgr->releasePage(page_id, false);
+    }
+  }
+}
+
+/**
+ * @brief Returns the key of a page in pages: its file id and page number.
+ */
+std::uint64_t PagePrefetcher::_key(PageId page_id) {
+  return ( (std::uint64_t)page_id.file_id << 32 ) | page_id.page_num;
+}
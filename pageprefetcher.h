@@ -0,0 +1,182 @@
+#ifndef _SWATDB_PAGEPREFETCHER_H_
+#define _SWATDB_PAGEPREFETCHER_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "swatdb_types.h"
+
+class BufferManager;
+
+/**
+ * States of a page requested from a PagePrefetcher
+ */
+enum PrefetchState {PrefetchQueuedT, PrefetchLoadingT, PrefetchLoadedT,
+  PrefetchFailedT};
+
+/**
+ * Struct for one page requested from a PagePrefetcher.
+ */
+struct PrefetchEntry {
+  /**
+   * Page requested
+   */
+  PageId page_id;
+  /**
+   * Where the read of the page is: queued, being read, read and pinned, or
+   * not pinned (the read failed or was overtaken by the reader)
+   */
+  PrefetchState state;
+  /**
+   * Number of requests for the page not yet released
+   */
+  std::uint32_t refs;
+};
+
+/**
+ * PagePrefetcher pins heap pages in the BufferManager ahead of their use
+ * on one read-ahead thread. A scan that knows which pages it will read
+ * next requests them with prefetch; the thread pins each one in turn, so
+ * that when the scan gets to it (wait) the page is usually already in the
+ * buffer pool. The pin is held until the scan releases the page. One
+ * prefetcher can be shared by many scans.
+ *
+ * The BufferManager is not thread safe and reads pages from disk inside
+ * getPage, so every call into it, here and in the scans that use the
+ * prefetcher, is made under the buffer latch, disk read included. This is
+ * read-ahead, not an asynchronous I/O pool: there is never more than one
+ * read in flight, and it only overlaps the scan's work outside the latch
+ * (evaluating predicates and building result records). A second thread
+ * would only queue on the latch, so there is one.
+ */
+class PagePrefetcher {
+
+  public:
+
+    /**
+     * @brief Constructor for PagePrefetcher. Starts the read-ahead thread.
+     *
+     * @param buf_mgr. BufferManager * pages are read into.
+     */
+    PagePrefetcher(BufferManager *buf_mgr);
+
+    /**
+     * @brief Destructor for PagePrefetcher. Stops the read-ahead thread
+     *    and unpins any pages still held.
+     */
+    ~PagePrefetcher();
+
+    /**
+     * @brief Requests that a page be read into the buffer pool. A page that
+     *    is already requested is not read again. Every request must be
+     *    matched by a release.
+     *
+     * @param page_id. PageId of the page.
+     */
+    void prefetch(PageId page_id);
+
+    /**
+     * @brief Called before reading a requested page. Waits if the page is
+     *    being read; if its read has not started the caller reads it
+     *    itself.
+     *
+     * @param page_id. PageId of the page.
+     *
+     * @return True if the page was already in the buffer pool (a hit),
+     *    False otherwise (a miss).
+     */
+    bool wait(PageId page_id);
+
+    /**
+     * @brief Releases one request for a page, unpinning it once every
+     *    request for it is released.
+     *
+     * @param page_id. PageId of the page.
+     */
+    void release(PageId page_id);
+
+    /**
+     * @brief Returns the number of page reads issued.
+     */
+    std::uint64_t getNumIssued();
+
+    /**
+     * @brief Returns the number of waits that found their page read.
+     */
+    std::uint64_t getNumHits();
+
+    /**
+     * @brief Returns the number of waits that did not.
+     */
+    std::uint64_t getNumMisses();
+
+  private:
+
+    /**
+     * @brief Body of the read-ahead thread: pins queued pages until
+     *    stopped.
+     */
+    void _worker();
+
+    /**
+     * @brief Returns the key of a page in pages.
+     */
+    static std::uint64_t _key(PageId page_id);
+
+    /**
+     * BufferManager pages are read into
+     */
+    BufferManager *buf_mgr;
+
+    /**
+     * The read-ahead thread
+     */
+    std::thread worker;
+
+    /**
+     * Pages waiting for the read-ahead thread, in request order
+     */
+    std::deque<PageId> queue;
+
+    /**
+     * Requested pages that are not yet released, by page
+     */
+    std::unordered_map<std::uint64_t, PrefetchEntry> pages;
+
+    /**
+     * True when the read-ahead thread should exit
+     */
+    bool stopping;
+
+    /**
+     * Counters of reads issued, hits and misses
+     */
+    std::uint64_t num_issued;
+    std::uint64_t num_hits;
+    std::uint64_t num_misses;
+
+    /**
+     * Protects everything above
+     */
+    std::mutex lock;
+
+    /**
+     * Signalled when a page is queued or the thread should stop
+     */
+    std::condition_variable work_ready;
+
+    /**
+     * Signalled when the read of a page finishes
+     */
+    std::condition_variable page_ready;
+
+};
+
+#endif
@@ -0,0 +1,215 @@
+#include <string>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "swatdb_types.h"
+#include "parallelfilescan.h"
+#include "recordlayout.h"
+#include "recordbatch.h"
+#include "record.h"
+#include "data.h"
+#include "heapfile.h"
+#include "catalog.h"
+#include "resultwriter.h"
+#include "pinnedpagescan.h"
+
+/*
+ * Number of consecutive pages a worker claims at a time. Ranges are small
+ * enough that workers finish close together, and large enough that they
+ * seldom contend for the queue lock.
+ */
+static const size_t RANGE_PAGES = 8;
+
+/**
+ * @brief Constructor for ParallelFileScan select operation. Allocates one
+ *    page batch per worker.
+ *
+ * @param rel_id. File id of the relation file. 
+ * @param result_id. File id of the result file. 
+ * @param fields. Vector of field ids for the select operation. 
+ * @param comps. Vector of Comps for the select operation.
+ * @param values. Vector of Void * for the select operation. 
+ * @param num_threads. Number of worker threads, if 0 one per core.
+ * @param catalog. Catalog * for SwatDB.
+ */
+ParallelFileScan::ParallelFileScan(FileId rel_id, FileId result_id,
+    std::vector<FieldId> fields, std::vector<Comp> comps,
+    std::vector<void *> values, std::uint32_t num_threads,
+    Catalog *catalog) : Select(rel_id, result_id, fields, comps, values,
+    catalog) {
+
+  if( num_threads == 0 ) num_threads = std::thread::hardware_concurrency();
+  if( num_threads == 0 ) num_threads = 1;
+  this->num_threads = num_threads;
+  this->next_page = 0;
+  this->num_running = 0;
+
+  this->page_capacity = PAGE_SIZE / this->layout->getRecordSize();
+  if( this->page_capacity == 0 ) this->page_capacity = 1;
+
+  for( std::uint32_t i = 0; i < num_threads; i++ ){
+    this->batches.push_back(new RecordBatch(this->layout, this->fields,
+        this->page_capacity));
+  }
+}
+
+/**
+ * @brief Destructor for ParallelFileScan select operation.
+ *
+ * @post Batches and left over result pages are cleaned up
+ */
+ParallelFileScan::~ParallelFileScan(){
+  for( RecordBatch *batch : this->batches ){
+    delete batch;
+  }
+  for( std::vector<char> *page : this->result_pages ){
+    delete page;
+  }
+}
+
+/**
+ * @brief Performs the parallel file scan select operation. The calling
+ *    thread merges result pages as workers queue them, and once more after
+ *    the last worker finishes.
+ *
+ * @pre Valid files and parameters have been passed to the contructor.      
+ * @post Result file has been populated with records that meet the criteria 
+ *    of the operation.                                                     
+ */
+void ParallelFileScan::runOperation() {
+  if( this->buf_mgr == nullptr ){
+    this->_runScan();
+    return;
+  }
+
+  this->pages = PinnedPageScan::listPages((HeapFile *)this->file_state.file);
+  this->next_page = 0;
+  this->num_running = this->num_threads;
+  std::vector<std::thread> workers;
+  for( std::uint32_t i = 0; i < this->num_threads; i++ ){
+    workers.push_back(std::thread(&ParallelFileScan::_worker, this,
+          this->batches[i]));
+  }
+
+  while( true ){
+    bool done;
+    {
+      std::unique_lock<std::mutex> guard(this->queue_lock);
+      this->result_ready.wait(guard, [this]{
+          return !this->result_pages.empty() || this->num_running == 0; });
+      done = this->num_running == 0;
+    }
+    this->_mergeResultPages();
+    if( done ) break;
+  }
+
+  for( std::thread &worker : workers ){
+    worker.join();
+  }
+}
+
+/**
+ * @brief Body of a worker thread. Each worker pins its own pages, and has
+ *    its own scratch Record for comparisons that have no batch kernel, and
+ *    its own result page. A page is released as soon as its records are
+ *    in the batch.
+ *
+ * @param batch. RecordBatch * owned by this worker.
+ */
+void ParallelFileScan::_worker(RecordBatch *batch) {
+  Record *scratch = new Record(this->file_state.schema);
+  PinnedPageScan page_scan(this->buf_mgr);
+  std::uint32_t rsize = this->layout->getRecordSize();
+  std::vector<char> *page = new std::vector<char>();
+  page->reserve(this->page_capacity * rsize);
+
+  size_t first, last;
+  while( this->_claimRange(&first, &last) ){
+    for( size_t pos = first; pos < last; pos++ ){
+      page_scan.pin(this->pages[pos]);
+      SlotId slot_id;
+      const char *bytes;
+      while( ( bytes = page_scan.next(&slot_id) ) != nullptr ){
+        batch->appendRow(bytes);
+      }
+      page_scan.release();
+
+      for( size_t i = 0; i < fields.size(); i++ ){
+        batch->filter(fields[i], comps[i], values[i], scratch);
+      }
+      for( std::uint32_t row : batch->getSelection() ){
+        const char *row_bytes = batch->getRow(row);
+        page->insert(page->end(), row_bytes, row_bytes + rsize);
+        // pass full result pages on to be merged
+        if( page->size() == this->page_capacity * rsize ){
+          {
+            std::lock_guard<std::mutex> guard(this->queue_lock);
+            this->result_pages.push_back(page);
+          }
+          this->result_ready.notify_one();
+          page = new std::vector<char>();
+          page->reserve(this->page_capacity * rsize);
+        }
+      }
+      batch->clear();
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(this->queue_lock);
+    if( page->empty() ){
+      delete page;
+    }
+    else {
+      this->result_pages.push_back(page);
+    }
+    this->num_running--;
+  }
+  this->result_ready.notify_one();
+  delete scratch->getRecordData();
+  delete scratch;
+}
+
+/**
+ * @brief Claims the next RANGE_PAGES pages, or what is left of them, for a
+ *    worker. Ranges are handed out in page order and never overlap, so
+ *    each page is read by exactly one worker.
+ *
+ * @param first. Set to the position in pages of the first page.
+ * @param last. Set to one past the position of the last page.
+ *
+ * @return False if every page has been claimed.
+ */
+bool ParallelFileScan::_claimRange(size_t *first, size_t *last) {
+  std::lock_guard<std::mutex> guard(this->queue_lock);
+  if( this->next_page == this->pages.size() ) return false;
+  *first = this->next_page;
+  *last = std::min(this->next_page + RANGE_PAGES, this->pages.size());
+  this->next_page = *last;
+  return true;
+}
+
+/**
+ * @brief Inserts the records of every finished result page into the result
+ *    file. The pages are taken off the queue under the lock, but inserted
+ *    without holding it so workers are not held up by the result file;
+ *    the result writer inserts under the buffer latch instead.
+ */
+void ParallelFileScan::_mergeResultPages() {
+  std::deque<std::vector<char> *> full_pages;
+  {
+    std::lock_guard<std::mutex> guard(this->queue_lock);
+    full_pages.swap(this->result_pages);
+  }
+
+  std::uint32_t rsize = this->layout->getRecordSize();
+  for( std::vector<char> *page : full_pages ){
+    for( size_t off = 0; off < page->size(); off += rsize ){
+      this->result_writer->append(page->data() + off);
+    }
+    delete page;
+  }
+}
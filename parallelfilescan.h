@@ -0,0 +1,141 @@
+#ifndef _SWATDB_PARALLELFILESCAN_H_
+#define  _SWATDB_PARALLELFILESCAN_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include "swatdb_types.h"
+#include "select.h"
+
+class Catalog;
+class HeapFile;
+class Record;
+class RecordLayout;
+class RecordBatch;
+
+/**
+ * ParallelFileScan is a file scan select that spreads the pages of the
+ * relation over a number of worker threads. The calling thread only lists
+ * the relation's page ids; each worker claims a range of pages no other
+ * worker reads, pins them itself and loads their records into its own
+ * RecordBatch. Workers evaluate the conjuncts on their pages and copy
+ * passing records into their own result pages, which are merged into the
+ * single result file by the calling thread while the workers run. Pages
+ * are pinned, and result records inserted, under the buffer latch.
+ */
+class ParallelFileScan : public Select {
+
+  public:
+
+    /**
+     * @brief Constructor for ParallelFileScan select operation.
+     *
+     * @param rel_id. File id for the relation file. 
+     * @param result_id. File id for the result file
+     * @param fields. Vector of field ids for the select operation. 
+     * @param comps. Vector of Comps for the select operation.
+     * @param values. Vector of Void * for the select operation. 
+     * @param num_threads. Number of worker threads, if 0 one per core.
+     * @param catalog. Catalog * for SwatDB.
+     */
+    ParallelFileScan(FileId rel_id, FileId result_id,
+        std::vector<FieldId> fields, std::vector<Comp> comps,
+        std::vector<void *> values, std::uint32_t num_threads,
+        Catalog *catalog);
+
+    /**
+     * @brief Destructor for ParallelFileScan. Deletes dynamic member
+     *    variables.
+     */
+    ~ParallelFileScan();
+
+    /**
+     * @brief Runs the parallel filescan operation. Lists the pages of the
+     *    relation, starts the workers and merges their result pages until
+     *    every worker is done. Without a buffer manager the scan runs on
+     *    the calling thread.
+     *
+     * @pre Valid files and parameters have been passed to the contructor.
+     * @post Result file has been populated with records that meet the
+     *    criteria of the operation.
+     */
+    void runOperation();
+
+  private:
+
+    /**
+     * @brief Body of a worker thread. Claims page ranges until every page
+     *    has been claimed, reads each page of a range into its batch,
+     *    filters it and stages the passing records in private result pages.
+     *
+     * @param batch. RecordBatch * owned by this worker.
+     */
+    void _worker(RecordBatch *batch);
+
+    /**
+     * @brief Claims the next range of pages for a worker.
+     *
+     * @param first. Set to the position in pages of the first page.
+     * @param last. Set to one past the position of the last page.
+     *
+     * @return False if every page has been claimed.
+     */
+    bool _claimRange(size_t *first, size_t *last);
+
+    /**
+     * @brief Inserts the records of every finished result page into the
+     *    result file. Only called by the thread running runOperation.
+     */
+    void _mergeResultPages();
+
+    /**
+     * Number of worker threads
+     */
+    std::uint32_t num_threads;
+
+    /**
+     * Number of records that fit on one page
+     */
+    std::uint32_t page_capacity;
+
+    /**
+     * One page batch per worker, owned by the operator
+     */
+    std::vector<RecordBatch *> batches;
+
+    /**
+     * Page ids of the relation, and the position of the first page not yet
+     * claimed by a worker
+     */
+    std::vector<PageId> pages;
+    size_t next_page;
+
+    /**
+     * Full worker result pages waiting to be merged into the result file
+     */
+    std::deque<std::vector<char> *> result_pages;
+
+    /**
+     * Number of workers that have not finished
+     */
+    std::uint32_t num_running;
+
+    /**
+     * Protects next_page, result_pages and num_running
+     */
+    std::mutex queue_lock;
+
+    /**
+     * Signalled when a result page is queued or a worker finishes
+     */
+    std::condition_variable result_ready;
+
+};
+
+#endif
@@ -0,0 +1,192 @@
+#include <string>
+#include <cstring>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "swatdb_types.h"
+#include "parallelproject.h"
+#include "project.h"
+#include "catalog.h"
+#include "record.h"
+#include "data.h"
+#include "heapfile.h"
+#include "resultwriter.h"
+#include "recordlayout.h"
+#include "pinnedpagescan.h"
+
+/*
+ * Number of relation pages in one range claimed by a worker, and how many
+ * ranges per worker may be finished but not yet appended. The second
+ * bounds the memory held by output buffers, which matters when order is
+ * preserved and one slow range holds back all those after it.
+ */
+static const std::uint32_t RANGE_PAGES = 8;
+static const std::uint32_t RANGES_AHEAD = 4;
+
+/**
+ * @brief Constructor for ParallelProject operation.
+ *
+ * @param rel_id. FileId of the relation file.
+ * @param result_id. FileId of the result file.
+ * @param fields. Vector of field ids for the project operation.
+ * @param num_threads. Number of worker threads, if 0 one per core.
+ * @param preserve_order. True to write the result in the relation's order.
+ * @param catalog. pointer to the catalog of SwatDB
+ *
+ * @pre rel_id is the name of a valid file.
+ * @post private variables have been set accordingly.
+ */
+ParallelProject::ParallelProject(FileId rel_id, FileId result_id,
+    std::vector<FieldId> fields, std::uint32_t num_threads,
+    bool preserve_order, Catalog *catalog)
+  : Project(rel_id, result_id, fields, catalog) {
+
+  if( num_threads == 0 ) num_threads = std::thread::hardware_concurrency();
+  if( num_threads == 0 ) num_threads = 1;
+  this->num_threads = num_threads;
+  this->preserve_order = preserve_order;
+  this->num_ranges = 0;
+  this->next_range = 0;
+  this->num_appended = 0;
+}
+
+/**
+ * @brief Destructor for the ParallelProject Operation.
+ */
+ParallelProject::~ParallelProject() {
+  for( std::vector<char> *output : this->outputs ){
+    delete output;
+  }
+}
+
+/**
+ * @brief Runs the operation. The relation's page list is cut into ranges of
+ *    RANGE_PAGES pages. While the workers project them, the calling thread
+ *    appends each finished range's records to the result: the lowest
+ *    unappended range when order is preserved, otherwise whichever
+ *    finished first. The page list is read when the operation runs, so it
+ *    covers every record in the file at that point.
+ *
+ * @pre Valid files and parameters have been passed to the contructor.
+ * @post Result file has been populated with all the records of the
+ *    original relation, with the new schema only consisting of fields that
+ *    were specified by passing them into the constructor.
+ */
+void ParallelProject::runOperation() {
+
+  if( this->buf_mgr == nullptr ){
+    this->num_ranges = 0;
+    Project::runOperation();
+    return;
+  }
+
+  this->pages = PinnedPageScan::listPages((HeapFile *)this->file_state.file);
+  std::uint32_t num_pages = this->pages.size();
+  this->num_ranges = ( num_pages + RANGE_PAGES - 1 ) / RANGE_PAGES;
+  this->next_range = 0;
+  this->num_appended = 0;
+  this->outputs.assign(this->num_ranges, nullptr);
+  this->finished.clear();
+
+  std::vector<std::thread> workers;
+  for( std::uint32_t i = 0; i < this->num_threads; i++ ){
+    workers.push_back(std::thread(&ParallelProject::_worker, this));
+  }
+
+  std::uint32_t rsize = this->result_layout->getRecordSize();
+  while( this->num_appended < this->num_ranges ){
+    std::vector<char> *output;
+    {
+      std::unique_lock<std::mutex> guard(this->range_lock);
+      std::uint32_t range;
+      if( this->preserve_order ){
+        range = this->num_appended;
+        this->range_done.wait(guard, [this, range]{
+            return this->outputs[range] != nullptr; });
+      }
+      else {
+        this->range_done.wait(guard, [this]{
+            return !this->finished.empty(); });
+        range = this->finished.front();
+        this->finished.pop_front();
+      }
+      output = this->outputs[range];
+      this->outputs[range] = nullptr;
+    }
+    // append without the lock so workers are not held up by the result
+    for( std::size_t off = 0; off < output->size(); off += rsize ){
+      this->result_writer->append(output->data() + off);
+    }
+    delete output;
+    {
+      std::lock_guard<std::mutex> guard(this->range_lock);
+      this->num_appended++;
+    }
+    this->range_appended.notify_all();
+  }
+
+  for( std::thread &worker : workers ){
+    worker.join();
+  }
+}
+
+/**
+ * @brief Returns the number of page ranges the last run was split into, 0
+ *    if it ran on the calling thread alone.
+ */
+std::uint32_t ParallelProject::getNumRanges() {
+  return this->num_ranges;
+}
+
+/**
+ * @brief Body of a worker thread. Each worker pins the pages of its ranges
+ *    itself and copies fields from each record's bytes on the page. It
+ *    claims the next range only once fewer than RANGES_AHEAD ranges per
+ *    worker are waiting to be appended. Ranges are claimed in order, so
+ *    the lowest unappended one is always claimed and an ordered run can
+ *    not stall.
+ */
+void ParallelProject::_worker() {
+
+  PinnedPageScan page_scan(this->buf_mgr);
+  std::uint32_t rsize = this->result_layout->getRecordSize();
+  std::uint32_t window = RANGES_AHEAD * this->num_threads;
+
+  while( true ){
+    std::uint32_t range;
+    {
+      std::unique_lock<std::mutex> guard(this->range_lock);
+      this->range_appended.wait(guard, [this, window]{
+          return this->next_range >= this->num_ranges ||
+            this->next_range < this->num_appended + window; });
+      if( this->next_range >= this->num_ranges ) break;
+      range = this->next_range++;
+    }
+
+    std::uint32_t first = range * RANGE_PAGES;
+    std::uint32_t last = std::min<std::size_t>(first + RANGE_PAGES,
+        this->pages.size());
+    std::vector<char> *output = new std::vector<char>();
+    for( std::uint32_t p = first; p < last; p++ ){
+      page_scan.pin(this->pages[p]);
+      SlotId slot_id;
+      const char *src;
+      while( ( src = page_scan.next(&slot_id) ) != nullptr ){
+        std::size_t off = output->size();
+        output->resize(off + rsize);
+        this->_copyFields(output->data() + off, src);
+      }
+      page_scan.release();
+    }
+
+    {
+      std::lock_guard<std::mutex> guard(this->range_lock);
+      this->outputs[range] = output;
+      if( !this->preserve_order ) this->finished.push_back(range);
+    }
+    this->range_done.notify_one();
+  }
+}
@@ -0,0 +1,134 @@
+#ifndef  _SWATDB_PARALLELPROJECT_H_
+#define  _SWATDB_PARALLELPROJECT_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include "swatdb_types.h"
+#include "project.h"
+
+class Catalog;
+
+/**
+ * ParallelProject is a Project that spreads the pages of the relation over
+ * a number of worker threads. The calling thread lists the relation's page
+ * ids, and workers claim disjoint ranges of them, pin each page of a range
+ * themselves and project its records in place into private output
+ * buffers. The calling thread appends each finished range to the result
+ * file, either in range order, so the result keeps the relation's order,
+ * or as soon as it is done. Pages are pinned, and result records inserted,
+ * under the buffer latch. Without a buffer manager the relation is
+ * projected by the calling thread alone.
+ */
+class ParallelProject : public Project {
+
+  public:
+
+    /**
+     * @brief Constructor for ParallelProject operation.
+     *
+     * @param rel_id. FileId of the relation file.
+     * @param result_id. FileId of the result file.
+     * @param fields. Vector of field ids for the project operation.
+     * @param num_threads. Number of worker threads, if 0 one per core.
+     * @param preserve_order. True to write the result in the relation's
+     *    order.
+     * @param catalog. pointer to the catalog of SwatDB
+     *
+     * @pre rel_id is the name of a valid file.
+     * @post private variables have been set accordingly.
+     */
+    ParallelProject(FileId rel_id, FileId result_id,
+        std::vector<FieldId> fields, std::uint32_t num_threads,
+        bool preserve_order, Catalog *catalog);
+
+    /**
+     * @brief Destructor for the ParallelProject Operation.
+     */
+    ~ParallelProject();
+
+    /**
+     * @brief Runs the operation. Starts the workers, appends the page
+     *    ranges they finish to the result, and waits for them.
+     *
+     * @pre Valid files and parameters have been passed to the contructor.
+     * @post Result file has been populated with all the records of the
+     *    original relation, with the new schema only consisting of fields
+     *    that were specified by passing them into the constructor.
+     */
+    void runOperation();
+
+    /**
+     * @brief Returns the number of page ranges the last run was split
+     *    into, 0 if it ran on the calling thread alone.
+     */
+    std::uint32_t getNumRanges();
+
+  private:
+
+    /**
+     * @brief Body of a worker thread. Claims page ranges in order until
+     *    there are none left, projecting each into its own buffer.
+     */
+    void _worker();
+
+    /**
+     * Number of worker threads
+     */
+    std::uint32_t num_threads;
+
+    /**
+     * True to append ranges in order
+     */
+    bool preserve_order;
+
+    /**
+     * Page ids of the relation, in file order
+     */
+    std::vector<PageId> pages;
+
+    /**
+     * Number of page ranges, the next one to claim, and the number
+     * appended to the result so far
+     */
+    std::uint32_t num_ranges;
+    std::uint32_t next_range;
+    std::uint32_t num_appended;
+
+    /**
+     * Projected records of each finished range that is not appended yet,
+     * indexed by range, nullptr until the range is done
+     */
+    std::vector<std::vector<char> *> outputs;
+
+    /**
+     * Ranges in the order they were finished, when order is not preserved
+     */
+    std::deque<std::uint32_t> finished;
+
+    /**
+     * Protects the range state above
+     */
+    std::mutex range_lock;
+
+    /**
+     * Signalled when a range is finished
+     */
+    std::condition_variable range_done;
+
+    /**
+     * Signalled when a range is appended, so workers that got too far
+     * ahead can claim more
+     */
+    std::condition_variable range_appended;
+
+};
+
+
+#endif
@@ -0,0 +1,197 @@
+#include <string>
+#include <cstring>
+#include <vector>
+#include <fstream>
+#include "swatdb_types.h"
+#include "paxfile.h"
+#include "recordlayout.h"
+#include "record.h"
+#include "data.h"
+#include "heapfile.h"
+#include "heapfilescanner.h"
+
+/*
+ * Each page starts with the number of records on it. The minipage of a
+ * field starts at PAX_HEADER_SIZE + (field offset * page capacity), so the
+ * minipages are laid out in schema order and each is exactly big enough
+ * for a full page.
+ */
+static const std::uint32_t PAX_HEADER_SIZE = sizeof(std::uint32_t);
+
+/**
+ * @brief Constructor for an empty PaxFile. A page holds as many records as
+ *    fit in it after the header.
+ *
+ * @param schema. Schema * of the relation.
+ */
+PaxFile::PaxFile(Schema *schema) {
+  this->schema = schema;
+  this->layout = new RecordLayout(schema);
+  this->page_capacity =
+    (PAGE_SIZE - PAX_HEADER_SIZE) / this->layout->getRecordSize();
+  this->num_recs = 0;
+}
+
+/**
+ * @brief Destructor for PaxFile.
+ */
+PaxFile::~PaxFile() {
+  delete this->layout;
+}
+
+/**
+ * @brief Rebuilds the file from scratch with a scan of the relation.
+ *
+ * @param file. HeapFile * of the relation.
+ */
+void PaxFile::build(HeapFile *file) {
+
+  this->pages.clear();
+  this->num_recs = 0;
+
+  HeapFileScanner* scanner = new HeapFileScanner(file);
+  Record *record = new Record(this->schema);
+  const char *bytes = RecordLayout::getBytes(record);
+  while( true ){
+    RecordId rid = scanner->getNext(record);
+    if( rid == INVALID_RECORD_ID ) break;
+    this->append(bytes);
+  }
+  delete record->getRecordData();
+  delete record;
+  delete scanner;
+}
+
+/**
+ * @brief Appends a record, splitting its fields over the last page's
+ *    minipages. Every page but the last is full, so the record goes to
+ *    page num_recs / page capacity, which is added if it does not exist.
+ *
+ * @param bytes. Raw bytes of a record of the relation.
+ */
+void PaxFile::append(const char *bytes) {
+
+  std::uint32_t page = this->num_recs / this->page_capacity;
+  std::uint32_t slot = this->num_recs % this->page_capacity;
+  if( slot == 0 ){
+    this->pages.resize(this->pages.size() + PAGE_SIZE, 0);
+  }
+
+  char *base = this->_page(page);
+  for( FieldId fid = 0; fid < this->layout->getNumFields(); fid++ ){
+    const FieldLayout &field = this->layout->getField(fid);
+    memcpy(base + PAX_HEADER_SIZE + field.offset * this->page_capacity +
+        slot * field.size, bytes + field.offset, field.size);
+  }
+  std::uint32_t page_recs = slot + 1;
+  memcpy(base, &page_recs, sizeof(page_recs));
+  this->num_recs++;
+}
+
+/**
+ * @brief Returns the number of records in the file.
+ */
+std::uint64_t PaxFile::getNumRecs() {
+  return this->num_recs;
+}
+
+/**
+ * @brief Returns the number of pages in the file.
+ */
+std::uint32_t PaxFile::getNumPages() {
+  return this->pages.size() / PAGE_SIZE;
+}
+
+/**
+ * @brief Returns the number of records on a page.
+ *
+ * @param page. Page number in the file.
+ */
+std::uint32_t PaxFile::getPageRecs(std::uint32_t page) {
+  std::uint32_t page_recs;
+  memcpy(&page_recs, this->_page(page), sizeof(page_recs));
+  return page_recs;
+}
+
+/**
+ * @brief Returns the layout of the relation's records.
+ */
+RecordLayout *PaxFile::getLayout() {
+  return this->layout;
+}
+
+/**
+ * @brief Returns a pointer to the values of one field for every record on a
+ *    page, field size bytes apart.
+ *
+ * @param page. Page number in the file.
+ * @param fid. FieldId of the field.
+ */
+const char *PaxFile::getColumn(std::uint32_t page, FieldId fid) {
+  return this->_page(page) + PAX_HEADER_SIZE +
+    this->layout->getField(fid).offset * this->page_capacity;
+}
+
+/**
+ * @brief Rebuilds the row image of one record from its page's minipages.
+ *
+ * @param page. Page number in the file.
+ * @param slot. Position of the record on the page.
+ * @param out. Record size bytes the row is written to.
+ */
+void PaxFile::getRow(std::uint32_t page, std::uint32_t slot, char *out) {
+
+  const char *base = this->_page(page) + PAX_HEADER_SIZE;
+  for( FieldId fid = 0; fid < this->layout->getNumFields(); fid++ ){
+    const FieldLayout &field = this->layout->getField(fid);
+    memcpy(out + field.offset, base + field.offset * this->page_capacity +
+        slot * field.size, field.size);
+  }
+}
+
+/**
+ * @brief Writes the file to a side file: the record size and count, then
+ *    every page.
+ *
+ * @param path. Path of the side file.
+ */
+void PaxFile::save(std::string path) {
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  std::uint32_t rsize = this->layout->getRecordSize();
+  out.write((const char *)&rsize, sizeof(rsize));
+  out.write((const char *)&this->num_recs, sizeof(this->num_recs));
+  out.write(this->pages.data(), this->pages.size());
+}
+
+/**
+ * @brief Reads a file written by save, replacing the current contents.
+ *
+ * @param path. Path of the side file.
+ *
+ * @return False if the file does not exist or was written for records of a
+ *    different size, True if it was loaded.
+ */
+bool PaxFile::load(std::string path) {
+
+  std::ifstream in(path, std::ios::binary);
+  std::uint32_t rsize;
+  if( !in.read((char *)&rsize, sizeof(rsize)) ) return false;
+  if( rsize != this->layout->getRecordSize() ) return false;
+  in.read((char *)&this->num_recs, sizeof(this->num_recs));
+
+  std::uint64_t num_pages =
+    ( this->num_recs + this->page_capacity - 1 ) / this->page_capacity;
+  this->pages.resize(num_pages * PAGE_SIZE);
+  in.read(this->pages.data(), this->pages.size());
+  return (bool)in;
+}
+
+/**
+ * @brief Returns a pointer to the start of a page.
+ *
+ * @param page. Page number in the file.
+ */
+char *PaxFile::_page(std::uint32_t page) {
+  return this->pages.data() + (std::size_t)page * PAGE_SIZE;
+}
@@ -0,0 +1,149 @@
+#ifndef _SWATDB_PAXFILE_H_
+#define _SWATDB_PAXFILE_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include "swatdb_types.h"
+
+class Schema;
+class HeapFile;
+class RecordLayout;
+
+/**
+ * PaxFile is a column-by-column (PAX) copy of a relation. Each PAGE_SIZE
+ * page holds a record count and then one minipage per field, in schema
+ * order, with that field's value for every record on the page back to
+ * back. A page holds as many records as fit in it whole, like a heap page,
+ * but a scan that needs a single field reads one contiguous column per
+ * page, which can be handed straight to a SIMD kernel, and only rebuilds
+ * the rows it keeps. The copy is built by appending records, either with a
+ * scan of the relation or as an operator writes its result, and saved in
+ * a side file next to the relation.
+ */
+class PaxFile {
+
+  public:
+
+    /**
+     * @brief Constructor for an empty PaxFile.
+     *
+     * @param schema. Schema * of the relation.
+     */
+    PaxFile(Schema *schema);
+
+    /**
+     * @brief Destructor for PaxFile.
+     */
+    ~PaxFile();
+
+    /**
+     * @brief Rebuilds the file from scratch with a scan of the relation.
+     *
+     * @param file. HeapFile * of the relation.
+     */
+    void build(HeapFile *file);
+
+    /**
+     * @brief Appends a record, splitting its fields over the last page's
+     *    minipages and starting a new page if the last one is full.
+     *
+     * @param bytes. Raw bytes of a record of the relation.
+     */
+    void append(const char *bytes);
+
+    /**
+     * @brief Returns the number of records in the file. If it differs from
+     *    the relation's record count the file is stale.
+     */
+    std::uint64_t getNumRecs();
+
+    /**
+     * @brief Returns the number of pages in the file.
+     */
+    std::uint32_t getNumPages();
+
+    /**
+     * @brief Returns the number of records on a page.
+     */
+    std::uint32_t getPageRecs(std::uint32_t page);
+
+    /**
+     * @brief Returns the layout of the relation's records.
+     */
+    RecordLayout *getLayout();
+
+    /**
+     * @brief Returns a pointer to the values of one field for every record
+     *    on a page, field size bytes apart.
+     *
+     * @param page. Page number in the file.
+     * @param fid. FieldId of the field.
+     */
+    const char *getColumn(std::uint32_t page, FieldId fid);
+
+    /**
+     * @brief Rebuilds the row image of one record from its page's
+     *    minipages.
+     *
+     * @param page. Page number in the file.
+     * @param slot. Position of the record on the page.
+     * @param out. Record size bytes the row is written to.
+     */
+    void getRow(std::uint32_t page, std::uint32_t slot, char *out);
+
+    /**
+     * @brief Writes the file to a side file: a header, then every page.
+     *
+     * @param path. Path of the side file.
+     */
+    void save(std::string path);
+
+    /**
+     * @brief Reads a file written by save, replacing the current contents.
+     *
+     * @param path. Path of the side file.
+     *
+     * @return False if the file does not exist or was written for another
+     *    record size, True if it was loaded.
+     */
+    bool load(std::string path);
+
+  private:
+
+    /**
+     * @brief Returns a pointer to the start of a page.
+     */
+    char *_page(std::uint32_t page);
+
+    /**
+     * Schema of the relation
+     */
+    Schema *schema;
+
+    /**
+     * Layout of the relation's records
+     */
+    RecordLayout *layout;
+
+    /**
+     * Number of records that fit on a page
+     */
+    std::uint32_t page_capacity;
+
+    /**
+     * The pages, PAGE_SIZE bytes each
+     */
+    std::vector<char> pages;
+
+    /**
+     * Number of records in the file
+     */
+    std::uint64_t num_recs;
+
+};
+
+#endif
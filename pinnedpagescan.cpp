@@ -0,0 +1,126 @@
+#include <string>
+#include <vector>
+#include <new>
+#include <mutex>
+#include "swatdb_types.h"
+#include "pinnedpagescan.h"
+#include "bufferlatch.h"
+#include "bufmgr.h"
+#include "page.h"
+#include "heappage.h"
+#include "heappagescanner.h"
+#include "heapfile.h"
+#include "blockheapfilescanner.h"
+
+/*
+ * Number of PageIds asked of the BlockHeapFileScanner at a time while
+ * listing a file's pages.
+ */
+static const std::uint32_t LIST_BLOCK_PAGES = 64;
+
+/**
+ * @brief Returns the PageIds of a heap file's data pages, in the order a
+ *    HeapFileScanner reads them. Only page ids are collected, a block at a
+ *    time, so no record is read. The file's header pages are read under
+ *    the buffer latch.
+ *
+ * @param file. HeapFile * of the relation.
+ */
+std::vector<PageId> PinnedPageScan::listPages(HeapFile *file) {
+
+  std::lock_guard<std::mutex> guard(buffer_latch);
+  std::vector<PageId> pages;
+  BlockHeapFileScanner *scanner = new BlockHeapFileScanner(file,
+      LIST_BLOCK_PAGES);
+  while( true ){
+    std::vector<PageId> block = scanner->getNextBlock();
+    if( block.empty() ) break;
+    pages.insert(pages.end(), block.begin(), block.end());
+  }
+  delete scanner;
+  return pages;
+}
+
+/**
+ * @brief Constructor for PinnedPageScan. No page is pinned. The memory the
+ *    page scanner of every pinned page is built in is allocated here.
+ *
+ * @param buf_mgr. BufferManager * pages are pinned in.
+ */
+PinnedPageScan::PinnedPageScan(BufferManager *buf_mgr) {
+  this->buf_mgr = buf_mgr;
+  this->page = nullptr;
+  this->page_id = INVALID_RECORD_ID.page_id;
+  this->page_scanner = nullptr;
+  this->page_scanner_mem = ::operator new(sizeof(HeapPageScanner));
+}
+
+/**
+ * @brief Destructor for PinnedPageScan. Releases the pinned page, if any.
+ */
+PinnedPageScan::~PinnedPageScan() {
+  this->release();
+  ::operator delete(this->page_scanner_mem);
+}
+
+/**
+ * @brief Pins a page and starts stepping through its records. The page is
+ *    pinned under the buffer latch, so scans on several threads can pin
+ *    pages at the same time, and its scanner is built in place in the
+ *    scan's reused memory.
+ *
+ * @pre No page is pinned.
+ *
+ * @param page_id. PageId of a heap page.
+ */
+void PinnedPageScan::pin(PageId page_id) {
+  std::lock_guard<std::mutex> guard(buffer_latch);
+  this->page = (HeapPage *)this->buf_mgr->getPage(page_id);
+  this->page_id = page_id;
+  this->page_scanner = new (this->page_scanner_mem) HeapPageScanner(
+      this->page);
+}
+
+/**
+ * @brief Returns the bytes of the next record on the pinned page, read in
+ *    place. They stay valid until the page is released.
+ *
+ * @pre A page is pinned.
+ *
+ * @param slot_id. Set to the SlotId of the record.
+ *
+ * @return const char * to the record on the page, nullptr once every record
+ *    of the page has been returned.
+ */
+const char *PinnedPageScan::next(SlotId *slot_id) {
+  *slot_id = this->page_scanner->getNext();
+  if( *slot_id == INVALID_SLOT_ID ) return nullptr;
+  return this->page->getRecordBytes(*slot_id);
+}
+
+/**
+ * @brief Releases the pinned page, if any, under the buffer latch. The page
+ *    is not modified, so it is released clean.
+ */
+void PinnedPageScan::release() {
+  if( this->page == nullptr ) return;
+  this->page_scanner->~HeapPageScanner();
+  this->page_scanner = nullptr;
+  std::lock_guard<std::mutex> guard(buffer_latch);
+  this->buf_mgr->releasePage(this->page_id, false);
+  this->page = nullptr;
+}
+
+/**
+ * @brief Returns true if a page is pinned.
+ */
+bool PinnedPageScan::isPinned() {
+  return this->page != nullptr;
+}
+
+/**
+ * @brief Returns the PageId of the pinned page.
+ */
+PageId PinnedPageScan::getPageId() {
+  return this->page_id;
+}
@@ -0,0 +1,110 @@
+#ifndef _SWATDB_PINNEDPAGESCAN_H_
+#define _SWATDB_PINNEDPAGESCAN_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include "swatdb_types.h"
+
+class BufferManager;
+class HeapFile;
+class HeapPage;
+class HeapPageScanner;
+
+/**
+ * PinnedPageScan reads the records of heap pages in place. A page is pinned
+ * in the BufferManager and a HeapPageScanner steps through its slots,
+ * handing out a pointer to each record's bytes on the page, so predicates
+ * and projections run on the buffer pool's copy of the record and a record
+ * is only copied when it is emitted. The caller decides which pages to read
+ * and in what order, usually from listPages, so a page range can be split
+ * between threads or pruned with a zone map.
+ */
+class PinnedPageScan {
+
+  public:
+
+    /**
+     * @brief Returns the PageIds of a heap file's data pages, in the order
+     *    a HeapFileScanner reads them.
+     *
+     * @param file. HeapFile * of the relation.
+     */
+    static std::vector<PageId> listPages(HeapFile *file);
+
+    /**
+     * @brief Constructor for PinnedPageScan. No page is pinned.
+     *
+     * @param buf_mgr. BufferManager * pages are pinned in.
+     */
+    PinnedPageScan(BufferManager *buf_mgr);
+
+    /**
+     * @brief Destructor for PinnedPageScan. Releases the pinned page, if
+     *    any.
+     */
+    ~PinnedPageScan();
+
+    /**
+     * @brief Pins a page and starts stepping through its records.
+     *
+     * @pre No page is pinned.
+     *
+     * @param page_id. PageId of a heap page.
+     */
+    void pin(PageId page_id);
+
+    /**
+     * @brief Returns the bytes of the next record on the pinned page. They
+     *    stay valid until the page is released.
+     *
+     * @pre A page is pinned.
+     *
+     * @param slot_id. Set to the SlotId of the record.
+     *
+     * @return const char * to the record on the page, nullptr once every
+     *    record of the page has been returned.
+     */
+    const char *next(SlotId *slot_id);
+
+    /**
+     * @brief Releases the pinned page, if any.
+     */
+    void release();
+
+    /**
+     * @brief Returns true if a page is pinned.
+     */
+    bool isPinned();
+
+    /**
+     * @brief Returns the PageId of the pinned page.
+     */
+    PageId getPageId();
+
+  private:
+
+    /**
+     * Buffer manager pages are pinned in
+     */
+    BufferManager *buf_mgr;
+
+    /**
+     * The pinned page and its id, nullptr if none is pinned
+     */
+    HeapPage *page;
+    PageId page_id;
+
+    /**
+     * Scanner over the slots of the pinned page, built in page_scanner_mem,
+     * which is allocated once and reused for every page
+     */
+    HeapPageScanner *page_scanner;
+    void *page_scanner_mem;
+
+};
+
+#endif
@@ -0,0 +1,179 @@
+#include <string>
+#include <cstring>
+#include <vector>
+#include "swatdb_types.h"
+#include "predicate.h"
+#include "recordlayout.h"
+#include "record.h"
+
+/*
+ * Returns the predicate's comparison value for type T.
+ */
+template <typename T>
+static inline T predValue(std::int32_t int_val, float float_val);
+
+template <>
+inline std::int32_t predValue<std::int32_t>(std::int32_t int_val, float) {
+  return int_val;
+}
+
+template <>
+inline float predValue<float>(std::int32_t, float float_val) {
+  return float_val;
+}
+
+/**
+ * @brief Constructor for Predicate. Compiles the conjunct: copies the
+ *    value out of the void * and picks the comparator for the field type
+ *    and comp.
+ *
+ * @param field. FieldLayout of the field compared.
+ * @param comp. Comp of the conjunct.
+ * @param value. void * to the value compared against.
+ */
+Predicate::Predicate(const FieldLayout &field, Comp comp, void *value) {
+
+  this->field = field;
+  this->offset = field.offset;
+  this->size = field.size;
+  this->fid = field.fid;
+  this->comp = comp;
+  this->setValue(value);
+
+  switch(field.type) {
+    case INT:
+      this->eval = _pickNumeric<std::int32_t>(comp);
+      break;
+    case FLOAT:
+      this->eval = _pickNumeric<float>(comp);
+      break;
+    default:
+      switch(comp) {
+        case EQUAL: this->eval = _evalChar<EQUAL>; break;
+        case NOTEQUAL: this->eval = _evalChar<NOTEQUAL>; break;
+        case LESS: this->eval = _evalChar<LESS>; break;
+        case LESS_EQUAL: this->eval = _evalChar<LESS_EQUAL>; break;
+        case GREATER: this->eval = _evalChar<GREATER>; break;
+        case GREATER_EQUAL: this->eval = _evalChar<GREATER_EQUAL>; break;
+        default: this->eval = nullptr; break;
+      }
+      break;
+  }
+}
+
+/**
+ * @brief Replaces the value compared against, copying it out of the
+ *    void * as the constructor does. The comparator depends only on the
+ *    field and comp, so it is kept.
+ *
+ * @param value. void * to the new value, of the field's type.
+ */
+void Predicate::setValue(void *value) {
+  this->value = value;
+  this->char_val = (const char *)value;
+  this->int_val = 0;
+  this->float_val = 0;
+  switch(this->field.type) {
+    case INT: this->int_val = *(std::int32_t *)value; break;
+    case FLOAT: this->float_val = *(float *)value; break;
+    default: break;
+  }
+}
+
+/**
+ * @brief Checks the conjunct against a record.
+ *
+ * @param rec. Record * being checked, used if the conjunct could not be
+ *    compiled.
+ * @param bytes. Raw bytes of rec.
+ *
+ * @return True if the record satisfies the conjunct, False otherwise.
+ */
+bool Predicate::matches(Record *rec, const char *bytes) const {
+  if( this->eval != nullptr ){
+    return this->eval(this, bytes);
+  }
+  return rec->compareFieldToValue(this->fid, this->value, this->comp);
+}
+
+/**
+ * @brief Checks if any record whose value of the conjunct's field lies
+ *    between the field values in min and max could satisfy the conjunct.
+ *    Conjuncts that are not compiled can not be reasoned about and always
+ *    may match.
+ *
+ * @param min. Record image holding the smallest value of the field.
+ * @param max. Record image holding the largest value of the field.
+ *
+ * @return False only if no value in [min, max] satisfies the conjunct.
+ */
+bool Predicate::mayMatch(const char *min, const char *max) const {
+  if( this->eval == nullptr ) return true;
+
+  int lo = RecordLayout::compareFieldValues(this->field, min + this->offset,
+      (const char *)this->value);
+  int hi = RecordLayout::compareFieldValues(this->field, max + this->offset,
+      (const char *)this->value);
+  switch(this->comp) {
+    case EQUAL: return lo <= 0 && hi >= 0;
+    case NOTEQUAL: return lo != 0 || hi != 0;
+    case LESS: return lo < 0;
+    case LESS_EQUAL: return lo <= 0;
+    case GREATER: return hi > 0;
+    case GREATER_EQUAL: return hi >= 0;
+    default: return true;
+  }
+}
+
+/**
+ * @brief Returns the field the conjunct is on.
+ */
+FieldId Predicate::getFieldId() const {
+  return this->fid;
+}
+
+/**
+ * @brief Returns true if the conjunct has a specialized comparator, false
+ *    if it falls back to Record::compareFieldToValue.
+ */
+bool Predicate::isCompiled() const {
+  return this->eval != nullptr;
+}
+
+/**
+ * @brief Comparator for INT and FLOAT fields. The field is copied out with
+ *    memcpy since fields are not necessarily aligned within the record.
+ */
+template <typename T, Comp C>
+bool Predicate::_evalNumeric(const Predicate *pred, const char *bytes) {
+  T field_val;
+  memcpy(&field_val, bytes + pred->offset, sizeof(T));
+  return compareValues<C>(field_val,
+      predValue<T>(pred->int_val, pred->float_val));
+}
+
+/**
+ * @brief Comparator for character fields.
+ */
+template <Comp C>
+bool Predicate::_evalChar(const Predicate *pred, const char *bytes) {
+  return compareValues<C>(
+      strncmp(bytes + pred->offset, pred->char_val, pred->size), 0);
+}
+
+/**
+ * @brief Picks the comparator instantiation for a value type T. Returns
+ *    nullptr for comparators that have no instantiation.
+ */
+template <typename T>
+Predicate::EvalFn Predicate::_pickNumeric(Comp comp) {
+  switch(comp) {
+    case EQUAL: return _evalNumeric<T, EQUAL>;
+    case NOTEQUAL: return _evalNumeric<T, NOTEQUAL>;
+    case LESS: return _evalNumeric<T, LESS>;
+    case LESS_EQUAL: return _evalNumeric<T, LESS_EQUAL>;
+    case GREATER: return _evalNumeric<T, GREATER>;
+    case GREATER_EQUAL: return _evalNumeric<T, GREATER_EQUAL>;
+    default: return nullptr;
+  }
+}
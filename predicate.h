@@ -0,0 +1,160 @@
+#ifndef _SWATDB_PREDICATE_H_
+#define _SWATDB_PREDICATE_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include "swatdb_types.h"
+#include "recordlayout.h"
+
+class Record;
+
+/**
+ * @brief Compares a field value against a select value. The comparator is a
+ *    template parameter, so the switch is resolved at compile time and
+ *    loops calling this are branch free.
+ *
+ * @param a. Value of the field.
+ * @param b. Value compared against.
+ *
+ * @return True if (a C b), False otherwise.
+ */
+template <Comp C, typename T>
+inline bool compareValues(T a, T b) {
+  switch(C) {
+    case EQUAL: return a == b;
+    case NOTEQUAL: return a != b;
+    case LESS: return a < b;
+    case LESS_EQUAL: return a <= b;
+    case GREATER: return a > b;
+    case GREATER_EQUAL: return a >= b;
+    default: return false;
+  }
+}
+
+/**
+ * Predicate is one conjunct of a select compiled against the relation's
+ * RecordLayout. The field offset, size and the comparison value are
+ * resolved once, and the comparison itself is a function instantiated for
+ * the field's (type, Comp) pair, so checking a record is one call that
+ * reads the field straight out of the record's bytes with no dispatch on
+ * type or comparator.
+ */
+class Predicate {
+
+  public:
+
+    /**
+     * @brief Constructor for Predicate. Compiles the conjunct.
+     *
+     * @param field. FieldLayout of the field compared.
+     * @param comp. Comp of the conjunct.
+     * @param value. void * to the value compared against. Must stay valid
+     *    for the lifetime of the predicate.
+     */
+    Predicate(const FieldLayout &field, Comp comp, void *value);
+
+    /**
+     * @brief Checks the conjunct against a record.
+     *
+     * @param rec. Record * being checked, used if the conjunct could not
+     *    be compiled.
+     * @param bytes. Raw bytes of rec.
+     *
+     * @return True if the record satisfies the conjunct, False otherwise.
+     */
+    bool matches(Record *rec, const char *bytes) const;
+
+    /**
+     * @brief Checks if any record whose value of the conjunct's field lies
+     *    between the field values in min and max could satisfy the
+     *    conjunct. Used to skip whole pages with a ZoneMap.
+     *
+     * @param min. Record image holding the smallest value of the field.
+     * @param max. Record image holding the largest value of the field.
+     *
+     * @return False only if no value in [min, max] satisfies the conjunct.
+     */
+    bool mayMatch(const char *min, const char *max) const;
+
+    /**
+     * @brief Replaces the value compared against, keeping the compiled
+     *    comparator.
+     *
+     * @param value. void * to the new value, of the field's type. Must
+     *    stay valid for the lifetime of the predicate.
+     */
+    void setValue(void *value);
+
+    /**
+     * @brief Returns the field the conjunct is on.
+     */
+    FieldId getFieldId() const;
+
+    /**
+     * @brief Returns true if the conjunct has a specialized comparator,
+     *    false if it falls back to Record::compareFieldToValue.
+     */
+    bool isCompiled() const;
+
+  private:
+
+    /**
+     * Signature of the specialized comparators
+     */
+    typedef bool (*EvalFn)(const Predicate *pred, const char *bytes);
+
+    /**
+     * @brief Comparator for INT and FLOAT fields.
+     */
+    template <typename T, Comp C>
+    static bool _evalNumeric(const Predicate *pred, const char *bytes);
+
+    /**
+     * @brief Comparator for character fields.
+     */
+    template <Comp C>
+    static bool _evalChar(const Predicate *pred, const char *bytes);
+
+    /**
+     * @brief Picks the comparator instantiation for a value type T.
+     */
+    template <typename T>
+    static EvalFn _pickNumeric(Comp comp);
+
+    /**
+     * Specialized comparator, nullptr if the conjunct is not compiled
+     */
+    EvalFn eval;
+
+    /**
+     * Layout of the field in the record
+     */
+    FieldLayout field;
+
+    /**
+     * Byte offset and size of the field in the record
+     */
+    std::uint32_t offset;
+    std::uint32_t size;
+
+    /**
+     * Comparison value, copied out of the void * for numeric fields
+     */
+    std::int32_t int_val;
+    float float_val;
+    const char *char_val;
+
+    /**
+     * The conjunct as given, used for the fallback comparison
+     */
+    FieldId fid;
+    Comp comp;
+    void *value;
+
+};
+
+#endif
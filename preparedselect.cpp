@@ -0,0 +1,91 @@
+#include <string>
+#include <vector>
+#include "swatdb_types.h"
+#include "preparedselect.h"
+#include "select.h"
+#include "record.h"
+
+/**
+ * @brief Constructor for PreparedSelect. Takes ownership of the select,
+ *    which is not opened until the first execute.
+ *
+ * @pre select was created with no result file.
+ *
+ * @param select. Select * to run, a FileScan or IndexScan.
+ */
+PreparedSelect::PreparedSelect(Select *select) {
+  this->select = select;
+  this->running = false;
+  this->num_executions = 0;
+}
+
+/**
+ * @brief Destructor for PreparedSelect. Closes the select if a run is open
+ *    and deletes it.
+ */
+PreparedSelect::~PreparedSelect() {
+  if( this->running ) this->select->close();
+  delete this->select;
+}
+
+/**
+ * @brief Starts a run of the select for new values: the last run is closed
+ *    if it is still open, the values are bound in place of the old ones,
+ *    and the select is opened again.
+ *
+ * @param values. Vector of void * lined up with the prepared fields.
+ *
+ * @throw MismatchingFieldsRelOpsManager if values is not the size of the
+ *    prepared fields.
+ */
+void PreparedSelect::execute(const std::vector<void *> &values) {
+  if( this->running ){
+    this->select->close();
+    this->running = false;
+  }
+  this->select->bindValues(values);
+  this->select->open();
+  this->running = true;
+  this->num_executions++;
+}
+
+/**
+ * @brief Reads the next record that matches the current run, closing the
+ *    run once there are no more.
+ *
+ * @pre execute has been called.
+ *
+ * @param rec. Record * the matching record is copied into, or nullptr.
+ *
+ * @return RecordId of the record in the relation, INVALID_RECORD_ID if there
+ *    are no more matches.
+ */
+RecordId PreparedSelect::getNext(Record *rec) {
+  if( !this->running ) return INVALID_RECORD_ID;
+  RecordId rid = this->select->getNextMatch(rec);
+  if( rid == INVALID_RECORD_ID ){
+    this->select->close();
+    this->running = false;
+  }
+  return rid;
+}
+
+/**
+ * @brief Runs the select for new values to completion.
+ *
+ * @param values. Vector of void * lined up with the prepared fields.
+ *
+ * @return Number of records that match.
+ */
+std::uint64_t PreparedSelect::count(const std::vector<void *> &values) {
+  this->execute(values);
+  while( this->getNext(nullptr) != INVALID_RECORD_ID );
+  return this->select->getNumMatches();
+}
+
+/**
+ * @brief Returns the number of runs started.
+ */
+std::uint64_t PreparedSelect::getNumExecutions() {
+  return this->num_executions;
+}
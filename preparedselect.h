@@ -0,0 +1,100 @@
+#ifndef _SWATDB_PREPAREDSELECT_H_
+#define _SWATDB_PREPAREDSELECT_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include "swatdb_types.h"
+
+class Select;
+class Record;
+
+/**
+ * PreparedSelect is a select that is checked and built once and then run
+ * many times for different values. Preparing validates the fields,
+ * compiles the conjuncts and allocates the select's records, key and
+ * scanner memory; each execution only rebinds the values and reruns the
+ * scan in place, so the steady state path does no heap allocation in the
+ * select itself. Matches are returned one at a time, as by a SelectCursor.
+ */
+class PreparedSelect {
+
+  public:
+
+    /**
+     * @brief Constructor for PreparedSelect. Takes ownership of the
+     *    select.
+     *
+     * @pre select was created with no result file.
+     *
+     * @param select. Select * to run, a FileScan or IndexScan.
+     */
+    PreparedSelect(Select *select);
+
+    /**
+     * @brief Destructor for PreparedSelect. Closes and deletes the select.
+     */
+    ~PreparedSelect();
+
+    /**
+     * @brief Starts a run of the select for new values, ending the last
+     *    run if its matches were not all read.
+     *
+     * @param values. Vector of void * lined up with the prepared fields,
+     *    each of the field's type. They must stay valid until the run
+     *    ends.
+     *
+     * @throw MismatchingFieldsRelOpsManager if values is not the size of
+     *    the prepared fields.
+     */
+    void execute(const std::vector<void *> &values);
+
+    /**
+     * @brief Reads the next record that matches the current run.
+     *
+     * @pre execute has been called.
+     *
+     * @param rec. Record * the matching record is copied into, or nullptr.
+     *
+     * @return RecordId of the record in the relation, INVALID_RECORD_ID if
+     *    there are no more matches. The run ends then.
+     */
+    RecordId getNext(Record *rec);
+
+    /**
+     * @brief Runs the select for new values to completion.
+     *
+     * @param values. Vector of void * lined up with the prepared fields.
+     *
+     * @return Number of records that match.
+     */
+    std::uint64_t count(const std::vector<void *> &values);
+
+    /**
+     * @brief Returns the number of runs started.
+     */
+    std::uint64_t getNumExecutions();
+
+  private:
+
+    /**
+     * Select that is rebound and rerun
+     */
+    Select *select;
+
+    /**
+     * True while a run is open
+     */
+    bool running;
+
+    /**
+     * Number of runs started
+     */
+    std::uint64_t num_executions;
+
+};
+
+#endif
@@ -11,6 +11,9 @@
 #include "record.h"
 #include "key.h"
 #include "heapfile.h"
+#include "resultwriter.h"
+#include "recordlayout.h"
+#include "pinnedpagescan.h"
 
 
 /**
@@ -29,7 +32,10 @@ Project::Project(FileId rel_id, FileId result_id, std::vector<FieldId> fields,
 
   this->_initState(rel_id, fields, &file_state);
   this->fields = fields; 
-  
+  this->layout = new RecordLayout(this->file_state.schema);
+  this->result_layout = new RecordLayout(this->result_state.schema);
+  this->copy_plan = RecordLayout::makeCopyPlan(*this->layout, fields,
+      *this->result_layout);
 }
 
 /**
@@ -37,10 +43,18 @@ Project::Project(FileId rel_id, FileId result_id, std::vector<FieldId> fields,
  */
 Project::~Project(){
   this->_delState(&this->file_state);
+  delete this->layout;
+  delete this->result_layout;
 }
 
 /**                                                                         
- * @brief Runs the operation.                                              
+ * @brief Runs the operation. Fields are copied from the scanned record's
+ *    bytes straight into space reserved by the result writer, so no
+ *    intermediate result Record is filled, and no field is
+ *    looked up per record: only the copy plan's memcpys run. With a buffer
+ *    manager the relation's pages are pinned one at a time and fields are
+ *    copied from each record's bytes on the page, so records are not
+ *    copied out of the buffer pool first.
  *                                                                          
  * @pre Valid files and parameters have been passed to the contructor.      
  * @post Result file has been populated with all the records of the 
@@ -48,18 +62,54 @@ Project::~Project(){
  *    that were specified by passing them into the constructor. 
  */   
 void Project::runOperation() {
-  // initialize scanner
   HeapFile* file = (HeapFile *)this->file_state.file;
+  if( this->buf_mgr != nullptr ){
+    PinnedPageScan page_scan(this->buf_mgr);
+    for( PageId page_id : PinnedPageScan::listPages(file) ){
+      page_scan.pin(page_id);
+      SlotId slot_id;
+      const char *src;
+      while( ( src = page_scan.next(&slot_id) ) != nullptr ){
+        this->_copyFields(this->result_writer->reserve(), src);
+        this->result_writer->commit();
+      }
+      page_scan.release();
+    }
+    return;
+  }
+
+  // initialize scanner
   HeapFileScanner* scanner = new HeapFileScanner(file);
   Record *record = this->file_state.rec;  
-  Record *dest = this->result_state.rec;
+  const char *src = RecordLayout::getBytes(record);
 
   while( true ){
     RecordId rid = scanner->getNext(record);
     if( rid == INVALID_RECORD_ID ) break;
-    record->setRecordFromRecord( this->fields, dest );
-    ((HeapFile *)this->result_state.file)->insertRecord( *dest );
+    this->_copyFields(this->result_writer->reserve(), src);
+    this->result_writer->commit();
   }
 
   delete scanner;
+}
+
+/**
+ * @brief Builds the result record at dest from the relation record at src
+ *    with the copy plan. A plan of a single copy, which is what a
+ *    projection of consecutive fields (such as a prefix of the schema)
+ *    coalesces to, is done without the loop.
+ *
+ * @param dest. Raw bytes of the result record.
+ * @param src. Raw bytes of the relation record.
+ */
+void Project::_copyFields(char *dest, const char *src) {
+
+  if( this->copy_plan.size() == 1 ){
+    const CopyRun &run = this->copy_plan[0];
+    memcpy(dest + run.dst_offset, src + run.src_offset, run.length);
+    return;
+  }
+  for( const CopyRun &run : this->copy_plan ){
+    memcpy(dest + run.dst_offset, src + run.src_offset, run.length);
+  }
 }
\ No newline at end of file
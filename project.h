@@ -9,6 +9,7 @@
 #include <vector>
 #include "swatdb_types.h"
 #include "operation.h"
+#include "recordlayout.h"
 
 class Catalog;
 class Schema;
@@ -49,7 +50,9 @@ class Project : public Operation {
     ~Project();
 
     /**                                                                         
-     * @brief Runs the operation.                                              
+     * @brief Runs the operation. Each projected record is built directly
+     *    in space reserved by the result writer from the scanned record's
+     *    bytes, with the copies of the copy plan.
      *                                                                          
      * @pre Valid files and parameters have been passed to the contructor.      
      * @post Result file has been populated with all the records of the 
@@ -70,6 +73,27 @@ class Project : public Operation {
      * fileState struct for the file project on 
      */
     fileState file_state;
+
+    /**
+     * Byte layouts of the relation's records and of the result's records
+     */
+    RecordLayout *layout;
+    RecordLayout *result_layout;
+
+    /**
+     * Coalesced copies that build a result record from a relation record,
+     * computed once by the constructor
+     */
+    std::vector<CopyRun> copy_plan;
+
+    /**
+     * @brief Builds the result record at dest from the relation record at
+     *    src with the copy plan.
+     *
+     * @param dest. Raw bytes of the result record.
+     * @param src. Raw bytes of the relation record.
+     */
+    void _copyFields(char *dest, const char *src);
     
 };
 
@@ -39,6 +39,11 @@
 #include "tupleNLJ.h"
 #include "hashjoin.h"
 #include "parallelHashJoin.h"
+#include "project.h"
+#include "distinctproject.h"
+#include "externalsort.h"
+#include "parallelproject.h"
+#include "recordlayout.h"
 
 #include "testerconf.h"
 
@@ -117,6 +122,60 @@ class TestFixture{
     }
 };
 
+/*
+ * Returns true if the records of file are in order on fields, scanning it
+ * and comparing each record with the one before it.
+ */
+bool isSorted(HeapFile *file, Schema *schema, std::vector<FieldId> fields,
+    std::vector<SortDirection> directions) {
+
+  RecordLayout layout(schema);
+  Record rec(schema);
+  HeapFileScanner scanner(file);
+  std::vector<char> prev(layout.getRecordSize());
+  const char *cur = RecordLayout::getBytes(&rec);
+  bool first = true;
+
+  while( scanner.getNext(&rec) != INVALID_RECORD_ID ){
+    if( !first ){
+      for( std::uint32_t i = 0; i < fields.size(); i++ ){
+        const FieldLayout &field = layout.getField(fields[i]);
+        int cmp = RecordLayout::compareFieldValues(field,
+            prev.data() + field.offset, cur + field.offset);
+        if( directions[i] == DescendingT ) cmp = -cmp;
+        if( cmp < 0 ) break;
+        if( cmp > 0 ) return false;
+      }
+    }
+    memcpy(prev.data(), cur, prev.size());
+    first = false;
+  }
+  return true;
+}
+
+/*
+ * Returns true if two files hold the same records in the same order.
+ */
+bool sameOrder(HeapFile *a, HeapFile *b, Schema *schema) {
+
+  RecordLayout layout(schema);
+  Record rec_a(schema);
+  Record rec_b(schema);
+  HeapFileScanner scan_a(a);
+  HeapFileScanner scan_b(b);
+
+  while( true ){
+    bool more_a = scan_a.getNext(&rec_a) != INVALID_RECORD_ID;
+    bool more_b = scan_b.getNext(&rec_b) != INVALID_RECORD_ID;
+    if( more_a != more_b ) return false;
+    if( !more_a ) return true;
+    if( memcmp(RecordLayout::getBytes(&rec_a), RecordLayout::getBytes(&rec_b),
+          layout.getRecordSize()) != 0 ){
+      return false;
+    }
+  }
+}
+
 SUITE(Projects) {
 
   TEST_FIXTURE(TestFixture, test1a) {
@@ -169,6 +228,240 @@ SUITE(Projects) {
 
   }
 
+  TEST_FIXTURE(TestFixture, test1f) {
+
+    // fields out of schema order, checked against a project on the same
+    // fields in schema order
+    std::vector<FieldId> fields = {3, 0};
+    std::vector<FieldId> ordered = {0, 3};
+    HeapFile *result = 
+      this->swatdb->getRelOpsMgr()->project(this->profs_file_id, fields);
+    HeapFile *expected = 
+      this->swatdb->getRelOpsMgr()->project(this->profs_file_id, ordered);
+    HeapFile *reordered = 
+      this->swatdb->getRelOpsMgr()->project(expected->getFileId(), {1, 0});
+    this->swatdb->getFileMgr()->printFile(result->getFileId());
+    CHECK_EQUAL(result->getNumRecords(), 12);
+    CHECK(this->swatdb->getRelOpsMgr()->checkFilesEqual(
+          reordered->getFileId(), result->getFileId()));
+
+  }
+
+  TEST_FIXTURE(TestFixture, copyPlan) {
+
+    // consecutive fields coalesce into one copy, any gap or reordering
+    // starts a new one
+    Catalog *catalog = this->swatdb->getCatalog();
+    RecordLayout src(catalog->getSchema(this->profs_file_id));
+    HeapFile *prefix = 
+      this->swatdb->getRelOpsMgr()->project(this->profs_file_id, {0, 1, 2});
+    RecordLayout prefix_layout(catalog->getSchema(prefix->getFileId()));
+    std::vector<CopyRun> plan =
+      RecordLayout::makeCopyPlan(src, {0, 1, 2}, prefix_layout);
+    CHECK_EQUAL(plan.size(), 1);
+    CHECK_EQUAL(plan[0].src_offset, 0);
+    CHECK_EQUAL(plan[0].length, prefix_layout.getRecordSize());
+
+    HeapFile *middle = 
+      this->swatdb->getRelOpsMgr()->project(this->profs_file_id, {1, 2});
+    RecordLayout middle_layout(catalog->getSchema(middle->getFileId()));
+    plan = RecordLayout::makeCopyPlan(src, {1, 2}, middle_layout);
+    CHECK_EQUAL(plan.size(), 1);
+    CHECK_EQUAL(plan[0].src_offset, src.getField(1).offset);
+
+    HeapFile *gaps = 
+      this->swatdb->getRelOpsMgr()->project(this->profs_file_id, {2, 0, 3});
+    RecordLayout gaps_layout(catalog->getSchema(gaps->getFileId()));
+    plan = RecordLayout::makeCopyPlan(src, {2, 0, 3}, gaps_layout);
+    CHECK_EQUAL(plan.size(), 3);
+    CHECK_EQUAL(gaps->getNumRecords(), 12);
+
+  }
+
+}
+
+SUITE(ParallelProjects) {
+
+  TEST_FIXTURE(TestFixture, ordered) {
+
+    // the workers split the pages, and the ranges are appended in order
+    // so the result matches a sequential project
+    RelOpsManager *relops = this->swatdb->getRelOpsMgr();
+    std::vector<FieldId> fields = {4, 1};
+    HeapFile *expected = relops->project(this->undergrads_file_id, fields);
+    HeapFile *result = relops->project(this->undergrads_file_id, fields,
+        false, 0, 4, true);
+    CHECK_EQUAL(result->getNumRecords(), 50000);
+    CHECK(sameOrder(expected, result,
+          this->swatdb->getCatalog()->getSchema(result->getFileId())));
+
+  }
+
+  TEST_FIXTURE(TestFixture, unordered) {
+
+    RelOpsManager *relops = this->swatdb->getRelOpsMgr();
+    std::vector<FieldId> fields = {0, 1, 4};
+    HeapFile *expected = relops->project(this->undergrads_file_id, fields);
+
+    FileId res_id = relops->_createProjectRes(
+        this->swatdb->getCatalog()->getSchema(this->undergrads_file_id),
+        fields);
+    ParallelProject *project = new ParallelProject(this->undergrads_file_id,
+        res_id, fields, 8, false, this->swatdb->getCatalog());
+    project->setBufferManager(this->swatdb->getBufMgr());
+    project->runOperation();
+    CHECK(project->getNumRanges() > 1);
+    delete project;
+
+    HeapFile *result =
+      (HeapFile *)this->swatdb->getCatalog()->getFile(res_id);
+    CHECK_EQUAL(result->getNumRecords(), 50000);
+    CHECK(relops->checkFilesEqual(expected->getFileId(), res_id));
+
+  }
+
+  TEST_FIXTURE(TestFixture, noBufferManager) {
+
+    // without a buffer manager the relation is projected on the calling
+    // thread
+    RelOpsManager *relops = this->swatdb->getRelOpsMgr();
+    std::vector<FieldId> fields = {0, 1};
+    FileId res_id = relops->_createProjectRes(
+        this->swatdb->getCatalog()->getSchema(this->courses_file_id),
+        fields);
+    ParallelProject *project = new ParallelProject(this->courses_file_id,
+        res_id, fields, 4, true, this->swatdb->getCatalog());
+    project->runOperation();
+    CHECK_EQUAL(project->getNumRanges(), 0);
+    delete project;
+    HeapFile *result =
+      (HeapFile *)this->swatdb->getCatalog()->getFile(res_id);
+    CHECK_EQUAL(result->getNumRecords(), 20);
+
+  }
+
+}
+
+SUITE(DistinctProjects) {
+
+  TEST_FIXTURE(TestFixture, distinctUnique) {
+
+    // every record is already distinct, so nothing is removed
+    std::vector<FieldId> fields = {0,1,2,3,4};
+    HeapFile *result = this->swatdb->getRelOpsMgr()->project(
+        this->phds_file_id, fields, true);
+    CHECK_EQUAL(result->getNumRecords(), 400);
+
+    result = this->swatdb->getRelOpsMgr()->project(
+        this->depts_file_id, {1}, true);
+    CHECK_EQUAL(result->getNumRecords(), 4);
+
+  }
+
+  TEST_FIXTURE(TestFixture, distinctDuplicates) {
+
+    // undergrad names repeat: a distinct project keeps one of each, and
+    // projecting its result again removes nothing more
+    RelOpsManager *relops = this->swatdb->getRelOpsMgr();
+    HeapFile *result = relops->project(this->undergrads_file_id, {1}, true);
+    std::cout << "distinct undergrad names: " << result->getNumRecords()
+      << std::endl;
+    CHECK(result->getNumRecords() > 0);
+    CHECK(result->getNumRecords() < 50000);
+
+    HeapFile *again = relops->project(result->getFileId(), {0}, true);
+    CHECK_EQUAL(again->getNumRecords(), result->getNumRecords());
+    CHECK(relops->checkFilesEqual(result->getFileId(), again->getFileId()));
+
+  }
+
+  TEST_FIXTURE(TestFixture, distinctSpill) {
+
+    // a one page table holds about a hundred (id, name) pairs out of
+    // 50000, so the project spills and recurses several levels, and must
+    // still match the in-memory one
+    RelOpsManager *relops = this->swatdb->getRelOpsMgr();
+    std::vector<FieldId> fields = {0, 1};
+    HeapFile *expected = relops->project(this->undergrads_file_id, fields,
+        true, 4096);
+
+    FileId res_id = relops->_createProjectRes(
+        this->swatdb->getCatalog()->getSchema(this->undergrads_file_id),
+        fields);
+    DistinctProject *project = new DistinctProject(this->undergrads_file_id,
+        res_id, fields, 1, this->swatdb->getCatalog());
+    project->runOperation();
+    std::cout << "spilled " << project->getNumSpilled() << " tuples to "
+      << project->getNumPartitions() << " partitions, depth "
+      << project->getMaxDepth() << std::endl;
+    CHECK(project->getNumSpilled() > 0);
+    CHECK(project->getMaxDepth() > 1);
+    delete project;
+
+    HeapFile *result =
+      (HeapFile *)this->swatdb->getCatalog()->getFile(res_id);
+    CHECK_EQUAL(result->getNumRecords(), expected->getNumRecords());
+    CHECK(relops->checkFilesEqual(expected->getFileId(), res_id));
+
+  }
+
+}
+
+SUITE(Sorts) {
+
+  TEST_FIXTURE(TestFixture, sortInMemory) {
+
+    // 400 phd students fit in the default budget: one in-memory run
+    HeapFile *result = this->swatdb->getRelOpsMgr()->sort(
+        this->phds_file_id, {4});
+    CHECK_EQUAL(result->getNumRecords(), 400);
+    CHECK(isSorted(result,
+          this->swatdb->getCatalog()->getSchema(this->phds_file_id),
+          {4}, {AscendingT}));
+
+  }
+
+  TEST_FIXTURE(TestFixture, sortDescending) {
+
+    std::vector<FieldId> fields = {1, 0};
+    std::vector<SortDirection> dirs = {DescendingT, AscendingT};
+    HeapFile *result = this->swatdb->getRelOpsMgr()->sort(
+        this->courses_file_id, fields, dirs);
+    CHECK_EQUAL(result->getNumRecords(), 20);
+    CHECK(isSorted(result,
+          this->swatdb->getCatalog()->getSchema(this->courses_file_id),
+          fields, dirs));
+
+  }
+
+  TEST_FIXTURE(TestFixture, sortExternal) {
+
+    // three pages hold a few hundred undergrads, so the sort writes many
+    // runs and merges them two at a time over several passes
+    RelOpsManager *relops = this->swatdb->getRelOpsMgr();
+    Schema *schema = this->swatdb->getCatalog()->getSchema(
+        this->undergrads_file_id);
+    std::vector<FieldId> fields = {4, 1};
+    std::vector<SortDirection> dirs = {DescendingT, AscendingT};
+
+    FileId res_id = relops->_createResultFile(schema);
+    ExternalSort *sort = new ExternalSort(this->undergrads_file_id, res_id,
+        fields, dirs, 3, this->swatdb->getCatalog());
+    sort->runOperation();
+    std::cout << "sorted undergrads in " << sort->getNumRuns() << " runs, "
+      << sort->getNumMergePasses() << " merge passes" << std::endl;
+    CHECK(sort->getNumRuns() > 2);
+    CHECK(sort->getNumMergePasses() > 1);
+    delete sort;
+
+    HeapFile *result =
+      (HeapFile *)this->swatdb->getCatalog()->getFile(res_id);
+    CHECK_EQUAL(result->getNumRecords(), 50000);
+    CHECK(isSorted(result, schema, fields, dirs));
+    CHECK(relops->checkFilesEqual(this->undergrads_file_id, res_id));
+
+  }
+
 }
 
 SUITE(ExceptionTests) {
@@ -176,6 +469,13 @@ SUITE(ExceptionTests) {
     CHECK_THROW(this->swatdb->getRelOpsMgr()->project(this->depts_file_id, {}),
         MismatchingFieldsRelOpsManager);
   }
+
+  TEST_FIXTURE(TestFixture, sortMismatch) {
+    CHECK_THROW(this->swatdb->getRelOpsMgr()->sort(this->depts_file_id, {}),
+        MismatchingFieldsRelOpsManager);
+    CHECK_THROW(this->swatdb->getRelOpsMgr()->sort(this->depts_file_id,
+          {0, 1}, {DescendingT}), MismatchingFieldsRelOpsManager);
+  }
 }
 
 
@@ -185,7 +485,8 @@ SUITE(ExceptionTests) {
  */
 void usage(){
   std::cout << "Usage: .projecttests -s <suite_name> -h help\n";
-  std::cout << "Available Suites: " << "Projects, ExceptionTests " << std::endl;
+  std::cout << "Available Suites: " << "Projects, ParallelProjects, "
+    << "DistinctProjects, Sorts, ExceptionTests " << std::endl;
 }
 
 /*
@@ -0,0 +1,162 @@
+#include <string>
+#include <vector>
+#include "swatdb_exceptions.h"
+#include "swatdb_types.h"
+#include "rangeindexscan.h"
+#include "btreeindex.h"
+#include "recordlayout.h"
+#include "record.h"
+#include "heapfile.h"
+#include "catalog.h"
+
+/**
+ * @brief Constructor for RangeIndexScan select operation. The conjuncts on
+ *    the indexed field are folded into the tightest lower and upper bound
+ *    (EQUAL gives both); those conjuncts are then guaranteed by the bounds
+ *    and only the others are left as residual conjuncts.
+ *
+ * @param rel_id. FileId of the relation file.
+ * @param result_id. FileId of the result file.
+ * @param fields. Vector of field ids for the select operation.
+ * @param comps. Vector of Comps for the select operation.
+ * @param values. Vector of Void * for the select operation.
+ * @param index. BTreeIndex * on one of the fields of the relation.
+ * @param catalog. Catalog * for SwatDB.
+ *
+ * @throw MismatchingFieldsRelOpsManager if no conjunct on the indexed field
+ *    can bound the scan.
+ */
+RangeIndexScan::RangeIndexScan(FileId rel_id, FileId result_id,
+    std::vector<FieldId> fields, std::vector<Comp> comps,
+    std::vector<void *> values, BTreeIndex *index, Catalog *catalog) :
+    Select(rel_id, result_id, fields, comps, values, catalog) {
+
+  this->index = index;
+  this->lower = nullptr;
+  this->lower_inclusive = true;
+  this->upper = nullptr;
+  this->upper_inclusive = true;
+  this->use_index = false;
+  this->entries_read = 0;
+  this->pos = {BTREE_NO_PAGE, 0};
+
+  const FieldLayout &field = index->getField();
+  bool bounded = false;
+  for( std::uint32_t i = 0; i < fields.size(); i++ ){
+    bool is_lower = comps[i] == EQUAL || comps[i] == GREATER || 
+      comps[i] == GREATER_EQUAL;
+    bool is_upper = comps[i] == EQUAL || comps[i] == LESS || 
+      comps[i] == LESS_EQUAL;
+    if( fields[i] != field.fid || ( !is_lower && !is_upper ) ){
+      this->residual_order.push_back(i);
+      continue;
+    }
+    const char *val = (const char *)values[i];
+    bool inclusive = comps[i] != GREATER && comps[i] != LESS;
+    if( is_lower ){
+      int cmp = this->lower == nullptr ? 1 :
+        RecordLayout::compareFieldValues(field, val, this->lower);
+      if( cmp > 0 || ( cmp == 0 && !inclusive ) ){
+        this->lower = val;
+        this->lower_inclusive = inclusive;
+      }
+    }
+    if( is_upper ){
+      int cmp = this->upper == nullptr ? -1 :
+        RecordLayout::compareFieldValues(field, val, this->upper);
+      if( cmp < 0 || ( cmp == 0 && !inclusive ) ){
+        this->upper = val;
+        this->upper_inclusive = inclusive;
+      }
+    }
+    bounded = true;
+  }
+  if( !bounded ){
+    throw MismatchingFieldsRelOpsManager();
+  }
+  this->full_order = this->order;
+}
+
+/**
+ * @brief Destructor for RangeIndexScan.
+ */
+RangeIndexScan::~RangeIndexScan() {
+}
+
+/**
+ * @brief Runs the range index scan select operation.
+ *
+ * @pre Valid files and parameters have been passed to the contructor.
+ * @post Result file has been populated with records that meet the criteria
+ *    of the operation.
+ */
+void RangeIndexScan::runOperation() {
+  this->_runScan();
+}
+
+/**
+ * @brief Returns the number of index entries read in the last run.
+ */
+std::uint64_t RangeIndexScan::getNumEntriesRead() {
+  return this->entries_read;
+}
+
+/**
+ * @brief Starts the scan by seeking to the lower bound, or to the first
+ *    entry if there is none. RelOpsManager drops ordered indexes when it
+ *    modifies their relation, so an index that is handed in is up to date
+ *    unless records were added or removed directly through the HeapFile.
+ *    That is caught by comparing its entry count with the relation's
+ *    record count, and the whole heap file is scanned instead, checking
+ *    every conjunct.
+ */
+void RangeIndexScan::_openScan() {
+  HeapFile *file = (HeapFile *)this->file_state.file;
+  this->entries_read = 0;
+  this->use_index = this->index->getNumRecs() == file->getNumRecs();
+  if( !this->use_index ){
+    this->order = this->full_order;
+    Select::_openScan();
+    return;
+  }
+  this->order = this->residual_order;
+  if( this->lower == nullptr ){
+    this->pos = this->index->begin();
+  }
+  else {
+    this->pos = this->index->seek(this->lower, this->lower_inclusive);
+  }
+}
+
+/**
+ * @brief Reads the record of the next index entry, stopping at the first
+ *    entry past the upper bound.
+ *
+ * @param rec. Record * the record is read into.
+ *
+ * @return RecordId of the record, INVALID_RECORD_ID past the upper bound.
+ */
+RecordId RangeIndexScan::_fetchNext(Record *rec) {
+  if( !this->use_index ) return Select::_fetchNext(rec);
+
+  if( this->index->isEnd(this->pos) ) return INVALID_RECORD_ID;
+  if( this->upper != nullptr ){
+    int cmp = RecordLayout::compareFieldValues(this->index->getField(),
+        this->index->getKey(this->pos), this->upper);
+    if( cmp > 0 || ( cmp == 0 && !this->upper_inclusive ) ){
+      return INVALID_RECORD_ID;
+    }
+  }
+  RecordId rid = this->index->getRecordId(this->pos);
+  this->index->next(this->pos);
+  this->entries_read++;
+  ((HeapFile *)this->file_state.file)->getRecord(rid, rec);
+  return rid;
+}
+
+/**
+ * @brief Ends the scan.
+ */
+void RangeIndexScan::_closeScan() {
+  if( !this->use_index ) Select::_closeScan();
+}
@@ -0,0 +1,124 @@
+#ifndef _SWATDB_RANGEINDEXSCAN_H_
+#define _SWATDB_RANGEINDEXSCAN_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include "swatdb_types.h"
+#include "select.h"
+#include "btreeindex.h"
+
+class Catalog;
+class Record;
+
+/**
+ * RangeIndexScan is a select that uses a BTreeIndex on one of the fields
+ * selected on. The conjuncts on the indexed field are combined into a lower
+ * and an upper bound; the scan seeks to the lower bound, walks the leaves
+ * until the upper bound, and fetches each entry's record. The other
+ * conjuncts are checked on the fetched records. Matches come out in order
+ * of the indexed field.
+ */
+class RangeIndexScan : public Select {
+
+  public:
+
+    /**
+     * @brief Constructor for RangeIndexScan select operation.
+     *
+     * @param rel_id. FileId of the relation file.
+     * @param result_id. FileId of the result file.
+     * @param fields. Vector of field ids for the select operation.
+     * @param comps. Vector of Comps for the select operation.
+     * @param values. Vector of Void * for the select operation.
+     * @param index. BTreeIndex * on one of the fields of the relation.
+     * @param catalog. Catalog * for SwatDB.
+     *
+     * @throw MismatchingFieldsRelOpsManager if no conjunct on the indexed
+     *    field can bound the scan.
+     */
+    RangeIndexScan(FileId rel_id, FileId result_id,
+        std::vector<FieldId> fields, std::vector<Comp> comps,
+        std::vector<void *> values, BTreeIndex *index, Catalog *catalog);
+
+    /**
+     * @brief Destructor for RangeIndexScan.
+     */
+    ~RangeIndexScan();
+
+    /**
+     * @brief Runs the range index scan select operation.
+     *
+     * @pre Valid files and parameters have been passed to the contructor.
+     * @post Result file has been populated with records that meet the
+     *    criteria of the operation.
+     */
+    void runOperation();
+
+    /**
+     * @brief Returns the number of index entries read in the last run.
+     */
+    std::uint64_t getNumEntriesRead();
+
+  protected:
+
+    /**
+     * @brief Starts the scan by seeking to the lower bound. If the index is
+     *    stale the whole heap file is scanned with every conjunct instead.
+     */
+    void _openScan();
+
+    /**
+     * @brief Reads the record of the next index entry within the bounds.
+     *
+     * @param rec. Record * the record is read into.
+     *
+     * @return RecordId of the record, INVALID_RECORD_ID past the upper
+     *    bound.
+     */
+    RecordId _fetchNext(Record *rec);
+
+    /**
+     * @brief Ends the scan.
+     */
+    void _closeScan();
+
+  private:
+
+    /**
+     * Index scanned and the current position in it
+     */
+    BTreeIndex *index;
+    BTreePos pos;
+
+    /**
+     * Bound values (nullptr for unbounded) and whether they are inclusive
+     */
+    const char *lower;
+    bool lower_inclusive;
+    const char *upper;
+    bool upper_inclusive;
+
+    /**
+     * Conjunct orders for an index scan (residual conjuncts only) and for
+     * a heap file scan (every conjunct)
+     */
+    std::vector<std::uint32_t> residual_order;
+    std::vector<std::uint32_t> full_order;
+
+    /**
+     * True if the current scan goes through the index
+     */
+    bool use_index;
+
+    /**
+     * Number of index entries read in the current scan
+     */
+    std::uint64_t entries_read;
+
+};
+
+#endif
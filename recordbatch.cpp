@@ -0,0 +1,310 @@
+#include <string>
+#include <cstring>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "swatdb_types.h"
+#include "recordbatch.h"
+#include "recordlayout.h"
+#include "predicate.h"
+#include "record.h"
+
+#ifdef __SSE2__
+/*
+ * SIMD helpers: broadcast the select value into all four lanes, and compare
+ * four column values against it, returning one bit per lane.
+ */
+static inline __m128i splat(std::int32_t val) {
+  return _mm_set1_epi32(val);
+}
+
+static inline __m128 splat(float val) {
+  return _mm_set1_ps(val);
+}
+
+template <Comp C>
+static inline int cmpSimd(const std::int32_t *col, __m128i v) {
+  __m128i a = _mm_loadu_si128((const __m128i *)col);
+  switch(C) {
+    case EQUAL:
+      return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, v)));
+    case NOTEQUAL:
+      return ~_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, v))) & 0xf;
+    case LESS:
+      return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(a, v)));
+    case LESS_EQUAL:
+      return ~_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(a, v))) & 0xf;
+    case GREATER:
+      return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(a, v)));
+    case GREATER_EQUAL:
+      return ~_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(a, v))) & 0xf;
+    default: return 0;
+  }
+}
+
+template <Comp C>
+static inline int cmpSimd(const float *col, __m128 v) {
+  __m128 a = _mm_loadu_ps(col);
+  switch(C) {
+    case EQUAL: return _mm_movemask_ps(_mm_cmpeq_ps(a, v));
+    case NOTEQUAL: return _mm_movemask_ps(_mm_cmpneq_ps(a, v));
+    case LESS: return _mm_movemask_ps(_mm_cmplt_ps(a, v));
+    case LESS_EQUAL: return _mm_movemask_ps(_mm_cmple_ps(a, v));
+    case GREATER: return _mm_movemask_ps(_mm_cmpgt_ps(a, v));
+    case GREATER_EQUAL: return _mm_movemask_ps(_mm_cmpge_ps(a, v));
+    default: return 0;
+  }
+}
+#endif
+
+/*
+ * Numeric kernel: ANDs the result of (col[i] C val) into mask[i] for every
+ * row, four rows at a time with SSE2 and the remainder one at a time.
+ */
+template <Comp C, typename T>
+static void numericKernel(const T *col, T val, std::uint32_t n,
+    std::uint8_t *mask) {
+
+  std::uint32_t i = 0;
+#ifdef __SSE2__
+  auto v = splat(val);
+  for( ; i + 4 <= n; i += 4 ){
+    int bits = cmpSimd<C>(col + i, v);
+    mask[i] &= bits & 1;
+    mask[i + 1] &= (bits >> 1) & 1;
+    mask[i + 2] &= (bits >> 2) & 1;
+    mask[i + 3] &= (bits >> 3) & 1;
+  }
+#endif
+  for( ; i < n; i++ ){
+    mask[i] &= compareValues<C>(col[i], val);
+  }
+}
+
+/*
+ * Character kernel: compares each fixed-width entry of the column against
+ * the value with strncmp.
+ */
+template <Comp C>
+static void charKernel(const char *col, std::uint32_t width, const char *val,
+    std::uint32_t n, std::uint8_t *mask) {
+
+  for( std::uint32_t i = 0; i < n; i++ ){
+    mask[i] &= compareValues<C>(strncmp(col + i * width, val, width), 0);
+  }
+}
+
+/*
+ * Picks the numeric kernel instantiation for comp. Returns false if comp
+ * has no kernel.
+ */
+template <typename T>
+static bool runNumeric(const T *col, T val, std::uint32_t n, Comp comp,
+    std::uint8_t *mask) {
+
+  switch(comp) {
+    case EQUAL: numericKernel<EQUAL>(col, val, n, mask); return true;
+    case NOTEQUAL: numericKernel<NOTEQUAL>(col, val, n, mask); return true;
+    case LESS: numericKernel<LESS>(col, val, n, mask); return true;
+    case LESS_EQUAL: numericKernel<LESS_EQUAL>(col, val, n, mask); return true;
+    case GREATER: numericKernel<GREATER>(col, val, n, mask); return true;
+    case GREATER_EQUAL:
+      numericKernel<GREATER_EQUAL>(col, val, n, mask); return true;
+    default: return false;
+  }
+}
+
+/*
+ * Picks the character kernel instantiation for comp. Returns false if comp
+ * has no kernel.
+ */
+static bool runChar(const char *col, std::uint32_t width, const char *val,
+    std::uint32_t n, Comp comp, std::uint8_t *mask) {
+
+  switch(comp) {
+    case EQUAL: charKernel<EQUAL>(col, width, val, n, mask); return true;
+    case NOTEQUAL: charKernel<NOTEQUAL>(col, width, val, n, mask); return true;
+    case LESS: charKernel<LESS>(col, width, val, n, mask); return true;
+    case LESS_EQUAL:
+      charKernel<LESS_EQUAL>(col, width, val, n, mask); return true;
+    case GREATER: charKernel<GREATER>(col, width, val, n, mask); return true;
+    case GREATER_EQUAL:
+      charKernel<GREATER_EQUAL>(col, width, val, n, mask); return true;
+    default: return false;
+  }
+}
+
+/**
+ * @brief Constructor for RecordBatch. All storage is allocated up front so
+ *    filling the batch never allocates.
+ *
+ * @param layout. RecordLayout * of the records stored in the batch.
+ * @param fields. Vector of field ids to keep in column form.
+ * @param capacity. Maximum number of rows the batch can hold.
+ */
+RecordBatch::RecordBatch(RecordLayout *layout, std::vector<FieldId> fields,
+    std::uint32_t capacity) {
+
+  this->layout = layout;
+  this->capacity = capacity;
+  this->num_rows = 0;
+
+  for( FieldId fid : fields ){
+    bool seen = false;
+    for( FieldId col_fid : this->col_fields ){
+      if( col_fid == fid ) seen = true;
+    }
+    if( seen ) continue;
+    this->col_fields.push_back(fid);
+    this->columns.push_back(std::vector<char>(
+          capacity * layout->getField(fid).size));
+  }
+  this->rows.resize(capacity * layout->getRecordSize());
+  this->mask.resize(capacity);
+  this->selection.reserve(capacity);
+}
+
+/**
+ * @brief Destructor for RecordBatch.
+ */
+RecordBatch::~RecordBatch() {
+}
+
+/**
+ * @brief Empties the batch so it can be refilled. Does not free space.
+ */
+void RecordBatch::clear() {
+  this->num_rows = 0;
+  this->selection.clear();
+}
+
+/**
+ * @brief Returns the number of rows in the batch.
+ */
+std::uint32_t RecordBatch::getNumRows() {
+  return this->num_rows;
+}
+
+/**
+ * @brief Returns true if no more rows can be appended to the batch.
+ */
+bool RecordBatch::isFull() {
+  return this->num_rows == this->capacity;
+}
+
+/**
+ * @brief Appends a record to the batch, copying its bytes into the row area
+ *    and its column fields into their columns. The row starts out selected.
+ *
+ * @pre The batch is not full.
+ *
+ * @param bytes. Raw bytes of the record.
+ */
+void RecordBatch::appendRow(const char *bytes) {
+
+  std::uint32_t rsize = this->layout->getRecordSize();
+  memcpy(&this->rows[this->num_rows * rsize], bytes, rsize);
+  for( std::uint32_t c = 0; c < this->col_fields.size(); c++ ){
+    const FieldLayout &field = this->layout->getField(this->col_fields[c]);
+    memcpy(&this->columns[c][this->num_rows * field.size],
+        bytes + field.offset, field.size);
+  }
+  this->mask[this->num_rows] = 1;
+  this->num_rows++;
+}
+
+/**
+ * @brief Returns the raw bytes of one row of the batch.
+ *
+ * @param row. Position of the row in the batch.
+ */
+const char *RecordBatch::getRow(std::uint32_t row) {
+  return &this->rows[row * this->layout->getRecordSize()];
+}
+
+/**
+ * @brief Evaluates one conjunct over every row of the batch, clearing the
+ *    rows that fail it.
+ *
+ * @pre fid is one of the fields passed to the constructor.
+ *
+ * @param fid. FieldId of the field compared.
+ * @param comp. Comp of the conjunct.
+ * @param value. void * to the value compared against.
+ * @param scratch. Record * used for the fallback comparison.
+ */
+void RecordBatch::filter(FieldId fid, Comp comp, void *value,
+    Record *scratch) {
+
+  const FieldLayout &field = this->layout->getField(fid);
+  const char *col = this->columns[this->_getColumn(fid)].data();
+  std::uint8_t *mask = this->mask.data();
+  if( RecordBatch::filterColumn(field, col, this->num_rows, comp, value,
+        mask) ){
+    return;
+  }
+
+  // no kernel for this comparison: check the still selected rows one by one
+  std::uint32_t rsize = this->layout->getRecordSize();
+  char *scratch_bytes = RecordLayout::getBytes(scratch);
+  for( std::uint32_t i = 0; i < this->num_rows; i++ ){
+    if( !mask[i] ) continue;
+    memcpy(scratch_bytes, this->getRow(i), rsize);
+    mask[i] = scratch->compareFieldToValue(fid, value, comp);
+  }
+}
+
+/**
+ * @brief Builds the selection vector of the rows that passed every conjunct
+ *    evaluated since the last clear.
+ *
+ * @return const reference to the vector of selected row positions.
+ */
+const std::vector<std::uint32_t> &RecordBatch::getSelection() {
+
+  this->selection.clear();
+  for( std::uint32_t i = 0; i < this->num_rows; i++ ){
+    if( this->mask[i] ) this->selection.push_back(i);
+  }
+  return this->selection;
+}
+
+/**
+ * @brief Runs the kernel for one conjunct over a column of values, ANDing
+ *    the result for each value into its mask byte. INT and FLOAT fields use
+ *    the SIMD kernels and character fields the strncmp loop.
+ *
+ * @param field. FieldLayout of the field compared.
+ * @param col. The field's values, field size bytes apart.
+ * @param n. Number of values in col.
+ * @param comp. Comp of the conjunct.
+ * @param value. void * to the value compared against.
+ * @param mask. n mask bytes, one per value.
+ *
+ * @return False if there is no kernel for the comparison, True otherwise.
+ */
+bool RecordBatch::filterColumn(const FieldLayout &field, const char *col,
+    std::uint32_t n, Comp comp, void *value, std::uint8_t *mask) {
+
+  switch(field.type) {
+    case INT:
+      return runNumeric((const std::int32_t *)col, *(std::int32_t *)value,
+          n, comp, mask);
+    case FLOAT:
+      return runNumeric((const float *)col, *(float *)value, n, comp, mask);
+    default:
+      return runChar(col, field.size, (const char *)value, n, comp, mask);
+  }
+}
+
+/**
+ * @brief Returns the position of fid in col_fields.
+ */
+std::uint32_t RecordBatch::_getColumn(FieldId fid) {
+
+  for( std::uint32_t c = 0; c < this->col_fields.size(); c++ ){
+    if( this->col_fields[c] == fid ) return c;
+  }
+  return 0;
+}
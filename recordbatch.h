@@ -0,0 +1,167 @@
+#ifndef _SWATDB_RECORDBATCH_H_
+#define _SWATDB_RECORDBATCH_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include "swatdb_types.h"
+
+class Record;
+class RecordLayout;
+struct FieldLayout;
+
+/**
+ * RecordBatch holds up to a page's worth of records for batch-at-a-time
+ * predicate evaluation. Full record images are kept row by row so that
+ * passing records can be emitted, and the fields that predicates are
+ * evaluated on are also kept column by column so that each conjunct can be
+ * run as a tight (SIMD where possible) loop over one column. The result of
+ * the conjuncts is a selection vector of the rows that pass all of them.
+ */
+class RecordBatch {
+
+  public:
+
+    /**
+     * @brief Constructor for RecordBatch.
+     *
+     * @param layout. RecordLayout * of the records stored in the batch.
+     * @param fields. Vector of field ids to keep in column form.
+     * @param capacity. Maximum number of rows the batch can hold.
+     */
+    RecordBatch(RecordLayout *layout, std::vector<FieldId> fields,
+        std::uint32_t capacity);
+
+    /**
+     * @brief Destructor for RecordBatch.
+     */
+    ~RecordBatch();
+
+    /**
+     * @brief Empties the batch so it can be refilled. Does not free space.
+     */
+    void clear();
+
+    /**
+     * @brief Returns the number of rows in the batch.
+     */
+    std::uint32_t getNumRows();
+
+    /**
+     * @brief Returns true if no more rows can be appended to the batch.
+     */
+    bool isFull();
+
+    /**
+     * @brief Appends a record to the batch, copying its bytes into the row
+     *    area and its column fields into their columns. The row starts out
+     *    selected.
+     *
+     * @pre The batch is not full.
+     *
+     * @param bytes. Raw bytes of the record.
+     */
+    void appendRow(const char *bytes);
+
+    /**
+     * @brief Returns the raw bytes of one row of the batch.
+     *
+     * @param row. Position of the row in the batch.
+     */
+    const char *getRow(std::uint32_t row);
+
+    /**
+     * @brief Evaluates one conjunct over every row of the batch, clearing
+     *    the rows that fail it. INT and FLOAT fields are compared with SIMD
+     *    kernels and character fields with a loop over the column; any
+     *    other comparison falls back to Record::compareFieldToValue on the
+     *    rows that are still selected.
+     *
+     * @pre fid is one of the fields passed to the constructor.
+     *
+     * @param fid. FieldId of the field compared.
+     * @param comp. Comp of the conjunct.
+     * @param value. void * to the value compared against.
+     * @param scratch. Record * used for the fallback comparison.
+     */
+    void filter(FieldId fid, Comp comp, void *value, Record *scratch);
+
+    /**
+     * @brief Builds the selection vector of the rows that passed every
+     *    conjunct evaluated since the last clear.
+     *
+     * @return const reference to the vector of selected row positions.
+     */
+    const std::vector<std::uint32_t> &getSelection();
+
+    /**
+     * @brief Runs the kernel for one conjunct over a column of values,
+     *    ANDing the result for each value into its mask byte. Used by
+     *    filter and by scans of columnar (PAX) pages.
+     *
+     * @param field. FieldLayout of the field compared.
+     * @param col. The field's values, field size bytes apart.
+     * @param n. Number of values in col.
+     * @param comp. Comp of the conjunct.
+     * @param value. void * to the value compared against.
+     * @param mask. n mask bytes, one per value.
+     *
+     * @return False if there is no kernel for the comparison, in which case
+     *    mask is left unchanged, True otherwise.
+     */
+    static bool filterColumn(const FieldLayout &field, const char *col,
+        std::uint32_t n, Comp comp, void *value, std::uint8_t *mask);
+
+  private:
+
+    /**
+     * @brief Returns the position of fid in col_fields.
+     */
+    std::uint32_t _getColumn(FieldId fid);
+
+    /**
+     * Layout of the records stored in the batch
+     */
+    RecordLayout *layout;
+
+    /**
+     * Field ids kept in column form, one per entry of columns
+     */
+    std::vector<FieldId> col_fields;
+
+    /**
+     * Column storage, each capacity * field size bytes
+     */
+    std::vector<std::vector<char>> columns;
+
+    /**
+     * Row storage, capacity * record size bytes
+     */
+    std::vector<char> rows;
+
+    /**
+     * One byte per row, 1 if the row passed every conjunct so far
+     */
+    std::vector<std::uint8_t> mask;
+
+    /**
+     * Positions of the selected rows, built by getSelection
+     */
+    std::vector<std::uint32_t> selection;
+
+    /**
+     * Number of rows currently in the batch
+     */
+    std::uint32_t num_rows;
+
+    /**
+     * Maximum number of rows in the batch
+     */
+    std::uint32_t capacity;
+
+};
+
+#endif
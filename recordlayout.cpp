@@ -0,0 +1,171 @@
+#include <string>
+#include <cstring>
+#include <vector>
+#include "swatdb_types.h"
+#include "recordlayout.h"
+#include "schema.h"
+#include "record.h"
+#include "data.h"
+
+/**
+ * @brief Constructor for RecordLayout. Walks the schema's field list and
+ *    computes the offset of every field. Records are fixed length, so each
+ *    field starts where the previous one ends.
+ *
+ * @param schema. Schema * of the relation the records belong to.
+ */
+RecordLayout::RecordLayout(Schema *schema) {
+
+  std::uint32_t offset = 0;
+  for( FieldId fid = 0; fid < schema->field_list.size(); fid++ ){
+    FieldLayout field;
+    field.fid = fid;
+    field.type = schema->field_list[fid].type;
+    field.offset = offset;
+    field.size = schema->field_list[fid].size;
+    this->fields.push_back(field);
+    offset += field.size;
+  }
+  this->record_size = offset;
+}
+
+/**
+ * @brief Destructor for RecordLayout.
+ */
+RecordLayout::~RecordLayout() {
+}
+
+/**
+ * @brief Returns the layout of one field.
+ *
+ * @pre fid is a valid field id of the schema.
+ *
+ * @param fid. FieldId (position) of the field.
+ *
+ * @return const reference to the FieldLayout of the field.
+ */
+const FieldLayout &RecordLayout::getField(FieldId fid) const {
+  return this->fields[fid];
+}
+
+/**
+ * @brief Returns the number of fields in the layout.
+ */
+std::uint32_t RecordLayout::getNumFields() const {
+  return this->fields.size();
+}
+
+/**
+ * @brief Returns the size in bytes of one record.
+ */
+std::uint32_t RecordLayout::getRecordSize() const {
+  return this->record_size;
+}
+
+/**
+ * @brief Returns a pointer to the raw bytes of a record.
+ *
+ * @param rec. Record * whose data is returned.
+ *
+ * @return char * to the first byte of the record's data.
+ */
+char *RecordLayout::getBytes(Record *rec) {
+  return rec->getRecordData()->getData();
+}
+
+/**
+ * @brief Compares two values of a field according to the field's type:
+ *    numerically for INT and FLOAT fields, and with strncmp for character
+ *    fields. Numeric values are copied out with memcpy since fields are not
+ *    necessarily aligned within a record.
+ *
+ * @param field. FieldLayout of the field.
+ * @param a. Pointer to the first value (not to the start of a record).
+ * @param b. Pointer to the second value.
+ *
+ * @return negative if a < b, 0 if they are equal, positive if a > b.
+ */
+int RecordLayout::compareFieldValues(const FieldLayout &field, const char *a,
+    const char *b) {
+
+  switch(field.type) {
+    case INT: {
+      std::int32_t x, y;
+      memcpy(&x, a, sizeof(x));
+      memcpy(&y, b, sizeof(y));
+      return (x > y) - (x < y);
+    }
+    case FLOAT: {
+      float x, y;
+      memcpy(&x, a, sizeof(x));
+      memcpy(&y, b, sizeof(y));
+      return (x > y) - (x < y);
+    }
+    default:
+      return strncmp(a, b, field.size);
+  }
+}
+
+/**
+ * @brief Sets out to a form of a field value that is byte for byte equal for
+ *    values that compareFieldValues finds equal: the bytes up to the end of
+ *    the string for character fields (which compare with strncmp), and the
+ *    value's bytes with -0.0 made 0.0 for FLOAT fields (which compare
+ *    equal).
+ *
+ * @param field. FieldLayout of the field.
+ * @param val. Pointer to the value.
+ * @param out. String set to the normalized value.
+ */
+void RecordLayout::normalizeValue(const FieldLayout &field, const char *val,
+    std::string &out) {
+
+  switch(field.type) {
+    case INT:
+      out.assign(val, sizeof(std::int32_t));
+      break;
+    case FLOAT: {
+      float x;
+      memcpy(&x, val, sizeof(x));
+      if( x == 0 ) x = 0;
+      out.assign((const char *)&x, sizeof(x));
+      break;
+    }
+    default:
+      out.assign(val, strnlen(val, field.size));
+      break;
+  }
+}
+
+/**
+ * @brief Builds the copies that turn a record of src into a record of dst
+ *    made of fields of src, in order. A field that starts where the last
+ *    copy ends in both records extends that copy instead of adding one.
+ *
+ * @pre Field i of dst has the type and size of field fields[i] of src.
+ *
+ * @param src. RecordLayout of the source records.
+ * @param fields. Vector of the src field ids that make up dst.
+ * @param dst. RecordLayout of the destination records.
+ *
+ * @return Vector of CopyRuns, in dst order.
+ */
+std::vector<CopyRun> RecordLayout::makeCopyPlan(const RecordLayout &src,
+    const std::vector<FieldId> &fields, const RecordLayout &dst) {
+
+  std::vector<CopyRun> plan;
+  for( FieldId i = 0; i < fields.size(); i++ ){
+    const FieldLayout &from = src.getField(fields[i]);
+    const FieldLayout &to = dst.getField(i);
+    if( !plan.empty() ){
+      CopyRun &last = plan.back();
+      if( last.src_offset + last.length == from.offset &&
+          last.dst_offset + last.length == to.offset ){
+        last.length += from.size;
+        continue;
+      }
+    }
+    plan.push_back({from.offset, to.offset, from.size});
+  }
+  return plan;
+}
@@ -0,0 +1,159 @@
+#ifndef _SWATDB_RECORDLAYOUT_H_
+#define _SWATDB_RECORDLAYOUT_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include "swatdb_types.h"
+
+class Schema;
+class Record;
+
+/**
+ * Struct describing where one field lives inside the fixed-length byte
+ * image of a record.
+ */
+struct FieldLayout {
+  /**
+   * Position of the field in the schema's field_list
+   */
+  FieldId fid;
+  /**
+   * Type of the field (INT, FLOAT or character data)
+   */
+  Type type;
+  /**
+   * Byte offset of the field from the start of the record
+   */
+  std::uint32_t offset;
+  /**
+   * Size of the field in bytes
+   */
+  std::uint32_t size;
+};
+
+/**
+ * Struct for one memcpy of a copy plan: length bytes from src_offset of the
+ * source record to dst_offset of the destination record.
+ */
+struct CopyRun {
+  std::uint32_t src_offset;
+  std::uint32_t dst_offset;
+  std::uint32_t length;
+};
+
+/**
+ * RecordLayout resolves the field offsets, sizes and types of a Schema once
+ * so operators can work on the raw bytes of a record without going back
+ * through the Schema for every tuple.
+ */
+class RecordLayout {
+
+  public:
+
+    /**
+     * @brief Constructor for RecordLayout. Walks the schema's field list
+     *    and computes the offset of every field.
+     *
+     * @param schema. Schema * of the relation the records belong to.
+     */
+    RecordLayout(Schema *schema);
+
+    /**
+     * @brief Destructor for RecordLayout.
+     */
+    ~RecordLayout();
+
+    /**
+     * @brief Returns the layout of one field.
+     *
+     * @pre fid is a valid field id of the schema.
+     *
+     * @param fid. FieldId (position) of the field.
+     *
+     * @return const reference to the FieldLayout of the field.
+     */
+    const FieldLayout &getField(FieldId fid) const;
+
+    /**
+     * @brief Returns the number of fields in the layout.
+     */
+    std::uint32_t getNumFields() const;
+
+    /**
+     * @brief Returns the size in bytes of one record.
+     */
+    std::uint32_t getRecordSize() const;
+
+    /**
+     * @brief Returns a pointer to the raw bytes of a record.
+     *
+     * @param rec. Record * whose data is returned.
+     *
+     * @return char * to the first byte of the record's data.
+     */
+    static char *getBytes(Record *rec);
+
+    /**
+     * @brief Compares two values of a field according to the field's type:
+     *    numerically for INT and FLOAT fields, and with strncmp for
+     *    character fields.
+     *
+     * @param field. FieldLayout of the field.
+     * @param a. Pointer to the first value (not to the start of a record).
+     * @param b. Pointer to the second value.
+     *
+     * @return negative if a < b, 0 if they are equal, positive if a > b.
+     */
+    static int compareFieldValues(const FieldLayout &field, const char *a,
+        const char *b);
+
+    /**
+     * @brief Sets out to a form of a field value that is byte for byte
+     *    equal for values that compareFieldValues finds equal: the bytes up
+     *    to the end of the string for character fields, and the value's
+     *    bytes with -0.0 made 0.0 for FLOAT fields. Used to hash values.
+     *
+     * @param field. FieldLayout of the field.
+     * @param val. Pointer to the value.
+     * @param out. String set to the normalized value. It keeps its
+     *    capacity, so reusing it does not allocate.
+     */
+    static void normalizeValue(const FieldLayout &field, const char *val,
+        std::string &out);
+
+    /**
+     * @brief Builds the copies that turn a record of src into a record of
+     *    dst made of fields of src, in order. Fields that are adjacent in
+     *    both records are coalesced into one copy, so a projection of
+     *    consecutive fields is a single memcpy.
+     *
+     * @pre Field i of dst has the type and size of field fields[i] of src.
+     *
+     * @param src. RecordLayout of the source records.
+     * @param fields. Vector of the src field ids that make up dst.
+     * @param dst. RecordLayout of the destination records.
+     *
+     * @return Vector of CopyRuns, in dst order.
+     */
+    static std::vector<CopyRun> makeCopyPlan(const RecordLayout &src,
+        const std::vector<FieldId> &fields, const RecordLayout &dst);
+
+  private:
+
+    /**
+     * Layout of each field, indexed by FieldId
+     */
+    std::vector<FieldLayout> fields;
+
+    /**
+     * Sum of the sizes of all the fields
+     */
+    std::uint32_t record_size;
+
+};
+
+#endif
@@ -4,6 +4,7 @@
 #include <thread>
 #include <algorithm>
 #include <string.h>
+#include <cstdio>
 #include <math.h>
 #include <mutex>
 #include "filemgr.h"
@@ -38,6 +39,12 @@
 #include "hashjoin.h"
 #include "parallelHashJoin.h"
 #include "project.h"
+#include "zonemap.h"
+#include "paxfile.h"
+#include "btreeindex.h"
+#include "tablestats.h"
+#include "pageprefetcher.h"
+#include "recordlayout.h"
 #include "testingconfig.h"
 #include "relopsmgr.h"
 
@@ -66,12 +73,307 @@ RelOpsManager::RelOpsManager(FileManager *file_mgr, BufferManager *buf_mgr,
   this->buf_mgr = buf_mgr;
   this->catalog = catalog;
   this->result_num = 0;
+  this->prefetcher = nullptr;
+  this->columnar_results = false;
+  this->last_plan.path = FileScanP;
+  this->last_plan.ordered_index = nullptr;
+  this->last_plan.est_rows = 0;
+  this->last_plan.cost = 0;
+  this->last_plan.file_scan_cost = 0;
   if(result_path != NULL) { 
     testdb_path = result_path;
   }
   // printf("Debug: relation results will be stored in %s\n", testdb_path.c_str());
 }
 
+/**
+ * @brief Destructor for RelOpsManager. Saves the side files of modified
+ *    relations, frees the zone maps, columnar copies, ordered indexes and
+ *    statistics, and stops the prefetcher.
+ */
+RelOpsManager::~RelOpsManager() {
+  this->flushSideFiles();
+  delete this->prefetcher;
+  for( auto &entry : this->zone_maps ){
+    delete entry.second;
+  }
+  for( auto &entry : this->pax_files ){
+    delete entry.second;
+  }
+  for( auto &entry : this->ordered_indexes ){
+    delete entry.second;
+  }
+  for( auto &entry : this->table_stats ){
+    delete entry.second;
+  }
+}
+
+/**
+ * @brief Builds a per-page min/max zone map of a relation with one scan and
+ *    saves it in a side file in the result directory.
+ *
+ * @pre rel_id is a valid HeapFile relation id.
+ *
+ * @param rel_id. FileId of the relation.
+ */
+void RelOpsManager::buildZoneMap(FileId rel_id) {
+
+  ZoneMap *zone_map = this->_getZoneMap(rel_id);
+  if( zone_map == nullptr ){
+    zone_map = new ZoneMap(this->catalog->getSchema(rel_id));
+    this->zone_maps[rel_id] = zone_map;
+  }
+  zone_map->build((HeapFile *)this->catalog->getFile(rel_id));
+  zone_map->save(this->_zoneMapPath(rel_id));
+}
+
+/**
+ * @brief Builds a columnar (PAX) copy of a relation with one scan and saves
+ *    it in a side file in the result directory.
+ *
+ * @pre rel_id is a valid HeapFile relation id.
+ *
+ * @param rel_id. FileId of the relation.
+ */
+void RelOpsManager::buildPaxFile(FileId rel_id) {
+
+  PaxFile *pax_file = this->_getPaxFile(rel_id);
+  if( pax_file == nullptr ){
+    pax_file = new PaxFile(this->catalog->getSchema(rel_id));
+    this->pax_files[rel_id] = pax_file;
+  }
+  pax_file->build((HeapFile *)this->catalog->getFile(rel_id));
+  pax_file->save(this->_paxPath(rel_id));
+}
+
+/**
+ * @brief Returns the columnar copy of a relation.
+ *
+ * @param rel_id. FileId of the relation.
+ *
+ * @return PaxFile * of the relation, nullptr if it has none.
+ */
+PaxFile *RelOpsManager::getPaxFile(FileId rel_id) {
+  return this->_getPaxFile(rel_id);
+}
+
+/**
+ * @brief Turns columnar results on or off.
+ *
+ * @param columnar. True to write columnar copies of results.
+ */
+void RelOpsManager::setColumnarResults(bool columnar) {
+  this->columnar_results = columnar;
+}
+
+/**
+ * @brief Bulk builds an ordered (B+-tree) index on one field of a relation
+ *    and saves it in a side file in the result directory.
+ *
+ * @pre rel_id is a valid HeapFile relation id and fid one of its fields.
+ *
+ * @param rel_id. FileId of the relation.
+ * @param fid. FieldId of the field to index.
+ */
+void RelOpsManager::buildOrderedIndex(FileId rel_id, FieldId fid) {
+
+  BTreeIndex *index = this->_getOrderedIndex(rel_id, fid);
+  if( index == nullptr ){
+    index = new BTreeIndex(this->catalog->getSchema(rel_id), fid);
+    this->ordered_indexes[std::make_pair(rel_id, fid)] = index;
+  }
+  index->build((HeapFile *)this->catalog->getFile(rel_id));
+  index->save(this->_orderedIndexPath(rel_id, fid));
+}
+
+/**
+ * @brief Collects per-field statistics of a relation and saves them in a
+ *    side file in the result directory. A sample is read by pinning a
+ *    random subset of the relation's pages, so pages left out of it are
+ *    never read.
+ *
+ * @pre rel_id is a valid HeapFile relation id.
+ *
+ * @param rel_id. FileId of the relation.
+ * @param sample_fraction. Fraction of the pages to read, in (0, 1].
+ */
+void RelOpsManager::analyze(FileId rel_id, double sample_fraction) {
+
+  HeapFile *file = (HeapFile *)this->catalog->getFile(rel_id);
+  TableStats *stats = this->_getTableStats(rel_id);
+  if( stats == nullptr ){
+    stats = new TableStats(this->catalog->getSchema(rel_id));
+    this->table_stats[rel_id] = stats;
+  }
+  stats->analyze(file, this->buf_mgr, sample_fraction);
+  stats->save(this->_statsPath(rel_id));
+}
+
+/**
+ * @brief Returns the statistics of a relation collected by analyze.
+ *
+ * @param rel_id. FileId of the relation.
+ *
+ * @return TableStats * of the relation, nullptr if it was never analyzed.
+ */
+TableStats *RelOpsManager::getTableStats(FileId rel_id) {
+  return this->_getTableStats(rel_id);
+}
+
+/**
+ * @brief Returns the heap page prefetcher shared by index scans.
+ *
+ * @return PagePrefetcher *, nullptr if no scan has prefetched yet.
+ */
+PagePrefetcher *RelOpsManager::getPrefetcher() {
+  return this->prefetcher;
+}
+
+/**
+ * @brief Refreshes the statistics of a relation after records were added
+ *    to it: each new record is read and added to the statistics, which are
+ *    then saved. Does nothing if the relation was never analyzed.
+ *
+ * @pre rel_id is a valid HeapFile relation id and new_rids are the
+ *    RecordIds of records added since the statistics were collected.
+ *
+ * @param rel_id. FileId of the relation.
+ * @param new_rids. Vector of RecordIds of the added records.
+ */
+void RelOpsManager::updateStats(FileId rel_id,
+    std::vector<RecordId> new_rids) {
+
+  TableStats *stats = this->_getTableStats(rel_id);
+  if( stats == nullptr ) return;
+  HeapFile *file = (HeapFile *)this->catalog->getFile(rel_id);
+  Record *record = new Record(this->catalog->getSchema(rel_id));
+  for( RecordId rid : new_rids ){
+    file->getRecord(rid, record);
+    stats->addRecord(RecordLayout::getBytes(record));
+  }
+  delete record->getRecordData();
+  delete record;
+  stats->save(this->_statsPath(rel_id));
+}
+
+/**
+ * @brief Inserts a record into a relation. The record is added to the
+ *    relation's zone map and statistics and appended to its columnar copy,
+ *    if it has them, in memory only; they are saved by the next
+ *    flushSideFiles. The relation's ordered indexes are dropped.
+ *
+ * @pre rel_id is a valid HeapFile relation id and rec has its schema.
+ *
+ * @param rel_id. FileId of the relation.
+ * @param rec. Record to insert.
+ *
+ * @return RecordId of the inserted record.
+ */
+RecordId RelOpsManager::insertRecord(FileId rel_id, Record &rec) {
+
+  HeapFile *file = (HeapFile *)this->catalog->getFile(rel_id);
+  RecordId rid = file->insertRecord(rec);
+  ZoneMap *zone_map = this->_getZoneMap(rel_id);
+  if( zone_map != nullptr ){
+    zone_map->addRecord(rid, RecordLayout::getBytes(&rec));
+  }
+  PaxFile *pax_file = this->_getPaxFile(rel_id);
+  if( pax_file != nullptr ){
+    pax_file->append(RecordLayout::getBytes(&rec));
+  }
+  TableStats *stats = this->_getTableStats(rel_id);
+  if( stats != nullptr ){
+    stats->addRecord(RecordLayout::getBytes(&rec));
+  }
+  this->dirty_rels.insert(rel_id);
+  this->_dropOrderedIndexes(rel_id);
+  return rid;
+}
+
+/**
+ * @brief Updates a record of a relation in place. The record's page in the
+ *    relation's zone map, if it has one, is widened to its new values, and
+ *    if the relation has statistics the old record is read and swapped for
+ *    the new one in them. Both change in memory, to be saved by the next
+ *    flushSideFiles. The relation's columnar copy and ordered indexes are
+ *    dropped.
+ *
+ * @pre rel_id is a valid HeapFile relation id, rid one of its records and
+ *    rec has its schema.
+ *
+ * @param rel_id. FileId of the relation.
+ * @param rid. RecordId of the record to update.
+ * @param rec. Record with the new values.
+ */
+void RelOpsManager::updateRecord(FileId rel_id, RecordId rid, Record &rec) {
+
+  HeapFile *file = (HeapFile *)this->catalog->getFile(rel_id);
+  this->_removeFromStats(rel_id, rid);
+  file->updateRecord(rid, rec);
+  TableStats *stats = this->_getTableStats(rel_id);
+  if( stats != nullptr ){
+    stats->addRecord(RecordLayout::getBytes(&rec));
+  }
+  ZoneMap *zone_map = this->_getZoneMap(rel_id);
+  if( zone_map != nullptr ){
+    zone_map->updateRecord(rid, RecordLayout::getBytes(&rec));
+  }
+  this->dirty_rels.insert(rel_id);
+  this->_dropPaxFile(rel_id);
+  this->_dropOrderedIndexes(rel_id);
+}
+
+/**
+ * @brief Deletes a record of a relation. The relation's zone map, if it has
+ *    one, counts the record as removed, and if the relation has statistics
+ *    the record is read and taken out of them. Both change in memory, to
+ *    be saved by the next flushSideFiles. The relation's columnar copy and
+ *    ordered indexes are dropped.
+ *
+ * @pre rel_id is a valid HeapFile relation id and rid one of its records.
+ *
+ * @param rel_id. FileId of the relation.
+ * @param rid. RecordId of the record to delete.
+ */
+void RelOpsManager::deleteRecord(FileId rel_id, RecordId rid) {
+
+  HeapFile *file = (HeapFile *)this->catalog->getFile(rel_id);
+  this->_removeFromStats(rel_id, rid);
+  file->deleteRecord(rid);
+  ZoneMap *zone_map = this->_getZoneMap(rel_id);
+  if( zone_map != nullptr ){
+    zone_map->removeRecord();
+  }
+  this->dirty_rels.insert(rel_id);
+  this->_dropPaxFile(rel_id);
+  this->_dropOrderedIndexes(rel_id);
+}
+
+/**
+ * @brief Saves the zone maps, columnar copies and statistics of the
+ *    relations modified through insertRecord, updateRecord and
+ *    deleteRecord since the last flush. Modifications only change the
+ *    copies in memory, so a load of many records writes each side file
+ *    once rather than once per record.
+ */
+void RelOpsManager::flushSideFiles() {
+  for( FileId rel_id : this->dirty_rels ){
+    auto zone_map = this->zone_maps.find(rel_id);
+    if( zone_map != this->zone_maps.end() ){
+      zone_map->second->save(this->_zoneMapPath(rel_id));
+    }
+    auto pax_file = this->pax_files.find(rel_id);
+    if( pax_file != this->pax_files.end() ){
+      pax_file->second->save(this->_paxPath(rel_id));
+    }
+    auto stats = this->table_stats.find(rel_id);
+    if( stats != this->table_stats.end() ){
+      stats->second->save(this->_statsPath(rel_id));
+    }
+  }
+  this->dirty_rels.clear();
+}
+
 /**
  * @brief Checks if two files have identical contents (every record in
  *    file1 also exists in file2 with the exact same value). This function
@@ -141,7 +443,250 @@ FileId RelOpsManager::_createResultFile(Schema *schema) {
   std::string filename = std::to_string(this->result_num) + "result";
   FileId res_id = this->file_mgr->createRelation(filename, schema, HeapFileT,
                               testdb_path + filename + ".rel", false);
+  // side files left for this id by an earlier run are stale
+  std::remove(this->_zoneMapPath(res_id).c_str());
+  std::remove(this->_paxPath(res_id).c_str());
+  for( FieldId fid = 0; fid < schema->field_list.size(); fid++ ){
+    std::remove(this->_orderedIndexPath(res_id, fid).c_str());
+  }
+  std::remove(this->_statsPath(res_id).c_str());
   this->result_num++;
   return res_id;
 
+}
+
+/**
+ * Returns the zone map of a relation, loading it from its side file if it
+ * is not in memory yet.
+ *
+ * @param rel_id: FileId of the relation
+ * @return ZoneMap * of the relation, nullptr if it has none
+ */
+ZoneMap *RelOpsManager::_getZoneMap(FileId rel_id) {
+
+  auto found = this->zone_maps.find(rel_id);
+  if( found != this->zone_maps.end() ){
+    return found->second;
+  }
+  ZoneMap *zone_map = new ZoneMap(this->catalog->getSchema(rel_id));
+  if( !zone_map->load(this->_zoneMapPath(rel_id)) ){
+    delete zone_map;
+    return nullptr;
+  }
+  this->zone_maps[rel_id] = zone_map;
+  return zone_map;
+}
+
+/**
+ * Returns the path of the side file for a relation's zone map, which is
+ * kept in the result directory and named after the relation's FileId.
+ *
+ * @param rel_id: FileId of the relation
+ * @return path of the zone map file
+ */
+std::string RelOpsManager::_zoneMapPath(FileId rel_id) {
+  return testdb_path + std::to_string(rel_id) + ".zmap";
+}
+
+/**
+ * Returns the columnar copy of a relation, loading it from its side file if
+ * it is not in memory yet.
+ *
+ * @param rel_id: FileId of the relation
+ * @return PaxFile * of the relation, nullptr if it has none
+ */
+PaxFile *RelOpsManager::_getPaxFile(FileId rel_id) {
+
+  auto found = this->pax_files.find(rel_id);
+  if( found != this->pax_files.end() ){
+    return found->second;
+  }
+  PaxFile *pax_file = new PaxFile(this->catalog->getSchema(rel_id));
+  if( !pax_file->load(this->_paxPath(rel_id)) ){
+    delete pax_file;
+    return nullptr;
+  }
+  this->pax_files[rel_id] = pax_file;
+  return pax_file;
+}
+
+/**
+ * Returns the path of the side file for a relation's columnar copy, which
+ * is kept in the result directory and named after the relation's FileId.
+ *
+ * @param rel_id: FileId of the relation
+ * @return path of the columnar copy
+ */
+std::string RelOpsManager::_paxPath(FileId rel_id) {
+  return testdb_path + std::to_string(rel_id) + ".pax";
+}
+
+/**
+ * Drops the columnar copy of a relation: deletes it if it is in memory and
+ * removes its side file. The copy's records are packed in insertion order
+ * with no record ids, so an update or delete cannot be applied to it.
+ *
+ * @param rel_id: FileId of the relation
+ */
+void RelOpsManager::_dropPaxFile(FileId rel_id) {
+
+  auto found = this->pax_files.find(rel_id);
+  if( found != this->pax_files.end() ){
+    delete found->second;
+    this->pax_files.erase(found);
+  }
+  std::remove(this->_paxPath(rel_id).c_str());
+}
+
+/**
+ * If columnar results are on, creates an empty columnar copy of a result
+ * file and has the operation append every record it writes to it. The
+ * caller passes it to _saveResultPax once the operation has run.
+ *
+ * @param op: Operation * writing the result
+ * @param res_id: FileId of the result file
+ * @return PaxFile * of the result, nullptr if columnar results are off
+ */
+PaxFile *RelOpsManager::_attachResultPax(Operation *op, FileId res_id) {
+
+  if( !this->columnar_results ) return nullptr;
+  PaxFile *pax_file = new PaxFile(this->catalog->getSchema(res_id));
+  op->setResultPaxFile(pax_file);
+  return pax_file;
+}
+
+/**
+ * Saves the columnar copy of a result file to its side file and deletes
+ * the in-memory copy, so results do not hold their copies in memory for
+ * the life of the manager. _getPaxFile loads it again when it is used.
+ *
+ * @param res_id: FileId of the result file
+ * @param res_pax: PaxFile * from _attachResultPax, nullptr for none
+ */
+void RelOpsManager::_saveResultPax(FileId res_id, PaxFile *res_pax) {
+
+  if( res_pax == nullptr ) return;
+  res_pax->save(this->_paxPath(res_id));
+  delete res_pax;
+}
+
+/**
+ * Returns the ordered index on a field of a relation, loading it from its
+ * side file if it is not in memory yet.
+ *
+ * @param rel_id: FileId of the relation
+ * @param fid: FieldId of the indexed field
+ * @return BTreeIndex * on the field, nullptr if there is none
+ */
+BTreeIndex *RelOpsManager::_getOrderedIndex(FileId rel_id, FieldId fid) {
+
+  auto found = this->ordered_indexes.find(std::make_pair(rel_id, fid));
+  if( found != this->ordered_indexes.end() ){
+    return found->second;
+  }
+  BTreeIndex *index = new BTreeIndex(this->catalog->getSchema(rel_id), fid);
+  if( !index->load(this->_orderedIndexPath(rel_id, fid)) ){
+    delete index;
+    return nullptr;
+  }
+  this->ordered_indexes[std::make_pair(rel_id, fid)] = index;
+  return index;
+}
+
+/**
+ * Returns the path of the side file for an ordered index, which is kept in
+ * the result directory and named after the relation's FileId and the field.
+ *
+ * @param rel_id: FileId of the relation
+ * @param fid: FieldId of the indexed field
+ * @return path of the index file
+ */
+std::string RelOpsManager::_orderedIndexPath(FileId rel_id, FieldId fid) {
+  return testdb_path + std::to_string(rel_id) + "_" + std::to_string(fid) +
+    ".bidx";
+}
+
+/**
+ * Drops every ordered index of a relation: deletes the ones in memory and
+ * removes their side files. Ordered indexes are bulk built and take no new
+ * entries, so any modification of the relation leaves them stale.
+ *
+ * @param rel_id: FileId of the relation
+ */
+void RelOpsManager::_dropOrderedIndexes(FileId rel_id) {
+
+  Schema *schema = this->catalog->getSchema(rel_id);
+  for( FieldId fid = 0; fid < schema->field_list.size(); fid++ ){
+    auto found = this->ordered_indexes.find(std::make_pair(rel_id, fid));
+    if( found != this->ordered_indexes.end() ){
+      delete found->second;
+      this->ordered_indexes.erase(found);
+    }
+    std::remove(this->_orderedIndexPath(rel_id, fid).c_str());
+  }
+}
+
+/**
+ * If a relation has statistics, reads one of its records and takes it out
+ * of them, before the record is updated or deleted.
+ *
+ * @param rel_id: FileId of the relation
+ * @param rid: RecordId of the record
+ */
+void RelOpsManager::_removeFromStats(FileId rel_id, RecordId rid) {
+
+  TableStats *stats = this->_getTableStats(rel_id);
+  if( stats == nullptr ) return;
+  HeapFile *file = (HeapFile *)this->catalog->getFile(rel_id);
+  Record *record = new Record(this->catalog->getSchema(rel_id));
+  file->getRecord(rid, record);
+  stats->removeRecord(RecordLayout::getBytes(record));
+  delete record->getRecordData();
+  delete record;
+}
+
+/**
+ * Returns the statistics of a relation, loading them from their side file
+ * if they are not in memory yet.
+ *
+ * @param rel_id: FileId of the relation
+ * @return TableStats * of the relation, nullptr if it has none
+ */
+TableStats *RelOpsManager::_getTableStats(FileId rel_id) {
+
+  auto found = this->table_stats.find(rel_id);
+  if( found != this->table_stats.end() ){
+    return found->second;
+  }
+  TableStats *stats = new TableStats(this->catalog->getSchema(rel_id));
+  if( !stats->load(this->_statsPath(rel_id)) ){
+    delete stats;
+    return nullptr;
+  }
+  this->table_stats[rel_id] = stats;
+  return stats;
+}
+
+/**
+ * Returns the path of the side file for a relation's statistics, which is
+ * kept in the result directory and named after the relation's FileId.
+ *
+ * @param rel_id: FileId of the relation
+ * @return path of the statistics file
+ */
+std::string RelOpsManager::_statsPath(FileId rel_id) {
+  return testdb_path + std::to_string(rel_id) + ".stats";
+}
+
+/**
+ * Returns the prefetcher of heap pages shared by index scans, starting its
+ * read-ahead thread on first use.
+ *
+ * @return PagePrefetcher * reading into the buffer manager
+ */
+PagePrefetcher *RelOpsManager::_getPrefetcher() {
+  if( this->prefetcher == nullptr ){
+    this->prefetcher = new PagePrefetcher(this->buf_mgr);
+  }
+  return this->prefetcher;
 }
\ No newline at end of file
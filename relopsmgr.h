@@ -10,7 +10,12 @@
 #include <string>
 #include <vector>
 #include <mutex>
+#include <map>
+#include <set>
 #include "swatdb_types.h"
+#include "ridbitmap.h"
+#include "selectplanner.h"
+#include "externalsort.h"
 
 class FileManager;
 class Catalog;
@@ -24,9 +29,25 @@ class HeapFileScanner;
 class Record;
 class Data;
 class Key;
+class ZoneMap;
+class PaxFile;
+class Operation;
+class Select;
+class SelectCursor;
+class PreparedSelect;
+class BTreeIndex;
+class TableStats;
+class PagePrefetcher;
 
 extern std::string relopsdir;
 
+/**
+ * Select types implemented in the relops layer, in addition to the
+ * SelectType values (FileScanT, IndexT) defined in swatdb_types.h
+ */
+enum RelOpsSelectType {VectorFileScanT, ParallelFileScanT, RangeIndexScanT,
+  AutoSelectT};
+
   // NOTE:  Do not modify this definition
 
 /**
@@ -54,6 +75,169 @@ class RelOpsManager {
     RelOpsManager(FileManager *file_mgr, BufferManager *buf_mgr, 
         Catalog *catalog, const char *result_path);
 
+    /**
+     * @brief Destructor for RelOpsManager. Saves the side files of
+     *    modified relations and frees the zone maps.
+     */
+    ~RelOpsManager();
+
+    /**
+     * @brief Builds a per-page min/max zone map of a relation with one scan
+     *    and saves it in a side file in the result directory. FileScanT
+     *    selects on the relation use it to skip pages. It is kept up to
+     *    date by insertRecord, updateRecord and deleteRecord; if the
+     *    relation's record count stops matching the zone map's, records
+     *    were added or removed some other way and it is not used.
+     *
+     * @pre rel_id is a valid HeapFile relation id.
+     *
+     * @param rel_id. FileId of the relation.
+     */
+    void buildZoneMap(FileId rel_id);
+
+    /**
+     * @brief Builds a columnar (PAX) copy of a relation with one scan and
+     *    saves it in a side file in the result directory. VectorFileScanT
+     *    selects on the relation scan it instead of the relation. Records
+     *    inserted with insertRecord are appended to the copy; updateRecord
+     *    and deleteRecord drop it.
+     *
+     * @pre rel_id is a valid HeapFile relation id.
+     *
+     * @param rel_id. FileId of the relation.
+     */
+    void buildPaxFile(FileId rel_id);
+
+    /**
+     * @brief Returns the columnar copy of a relation.
+     *
+     * @param rel_id. FileId of the relation.
+     *
+     * @return PaxFile * of the relation, nullptr if it has none.
+     */
+    PaxFile *getPaxFile(FileId rel_id);
+
+    /**
+     * @brief Turns columnar results on or off. While on, every select,
+     *    project, selectProject and sort writes a columnar copy of its
+     *    result as it fills it, so later vectorized selects on the result read only the
+     *    columns they compare.
+     *
+     * @param columnar. True to write columnar copies of results.
+     */
+    void setColumnarResults(bool columnar);
+
+    /**
+     * @brief Bulk builds an ordered (B+-tree) index on one field of a
+     *    relation and saves it in a side file in the result directory.
+     *    RangeIndexScanT selects with a range or equality conjunct on the
+     *    field use it. The index is memory resident and is dropped when
+     *    the relation is modified through insertRecord, updateRecord or
+     *    deleteRecord; if the relation's record count stops matching the
+     *    index's, records were added or removed some other way and it is
+     *    not used.
+     *
+     * @pre rel_id is a valid HeapFile relation id and fid one of its fields.
+     *
+     * @param rel_id. FileId of the relation.
+     * @param fid. FieldId of the field to index.
+     */
+    void buildOrderedIndex(FileId rel_id, FieldId fid);
+
+    /**
+     * @brief Collects per-field statistics of a relation (min and max, null
+     *    counts, equi-depth histograms and distinct count sketches) and
+     *    saves them in a side file in the result directory. AutoSelectT
+     *    selects use them to estimate selectivities. With a sample fraction
+     *    below 1 only that fraction of the pages is read.
+     *
+     * @pre rel_id is a valid HeapFile relation id.
+     *
+     * @param rel_id. FileId of the relation.
+     * @param sample_fraction. Fraction of the pages to read, in (0, 1].
+     */
+    void analyze(FileId rel_id, double sample_fraction = 1.0);
+
+    /**
+     * @brief Returns the statistics of a relation collected by analyze.
+     *
+     * @param rel_id. FileId of the relation.
+     *
+     * @return TableStats * of the relation, nullptr if it was never
+     *    analyzed.
+     */
+    TableStats *getTableStats(FileId rel_id);
+
+    /**
+     * @brief Returns the heap page prefetcher shared by index scans, whose
+     *    counters cover every prefetching scan run so far.
+     *
+     * @return PagePrefetcher *, nullptr if no scan has prefetched yet.
+     */
+    PagePrefetcher *getPrefetcher();
+
+    /**
+     * @brief Refreshes the statistics of a relation after records were
+     *    added to it through its HeapFile, reading only the new records,
+     *    and saves them. Records added with insertRecord are already in
+     *    the statistics. Does nothing if the relation was never analyzed.
+     *
+     * @pre rel_id is a valid HeapFile relation id and new_rids are the
+     *    RecordIds of records added since the statistics were collected.
+     *
+     * @param rel_id. FileId of the relation.
+     * @param new_rids. Vector of RecordIds of the added records.
+     */
+    void updateStats(FileId rel_id, std::vector<RecordId> new_rids);
+
+    /**
+     * @brief Inserts a record into a relation and keeps the relation's side
+     *    structures in step with it. Relations with side structures must be
+     *    modified through insertRecord, updateRecord and deleteRecord rather
+     *    than through their HeapFile, or the side structures go stale.
+     *
+     * @pre rel_id is a valid HeapFile relation id and rec has its schema.
+     *
+     * @param rel_id. FileId of the relation.
+     * @param rec. Record to insert.
+     *
+     * @return RecordId of the inserted record.
+     */
+    RecordId insertRecord(FileId rel_id, Record &rec);
+
+    /**
+     * @brief Updates a record of a relation in place and keeps the
+     *    relation's side structures in step with it.
+     *
+     * @pre rel_id is a valid HeapFile relation id, rid one of its records
+     *    and rec has its schema.
+     *
+     * @param rel_id. FileId of the relation.
+     * @param rid. RecordId of the record to update.
+     * @param rec. Record with the new values.
+     */
+    void updateRecord(FileId rel_id, RecordId rid, Record &rec);
+
+    /**
+     * @brief Deletes a record of a relation and keeps the relation's side
+     *    structures in step with it.
+     *
+     * @pre rel_id is a valid HeapFile relation id and rid one of its
+     *    records.
+     *
+     * @param rel_id. FileId of the relation.
+     * @param rid. RecordId of the record to delete.
+     */
+    void deleteRecord(FileId rel_id, RecordId rid);
+
+    /**
+     * @brief Saves the side structures of the relations modified through
+     *    insertRecord, updateRecord and deleteRecord since the last flush.
+     *    Those calls keep the side structures up to date in memory only;
+     *    the destructor flushes too.
+     */
+    void flushSideFiles();
+
     /**
      * @brief Runs the Project operation 
      *
@@ -63,13 +247,48 @@ class RelOpsManager {
      *    being projected on
      * @param fields. Vector of fieldids corresponding to fields 
      *    being projected on`
+     * @param distinct. True to remove duplicate result records.
+     * @param buffer_pages. Number of pages of memory a distinct project's
+     *    hash table may use before it spills to partition files, 0 for
+     *    DISTINCT_BUFFER_PAGES.
+     * @param num_threads. Number of worker threads for a project that is
+     *    not distinct: 1 runs on the calling thread, 0 uses one per core.
+     * @param preserve_order. True for a parallel project to keep the
+     *    relation's record order in its result.
      *
      * @throw MismatchingFieldsRelOpsManager if the fields parameter has
      *    invalid field Ids or is empty
      *
      * @return HeapFile * of the result file with results of the project.
      */
-    HeapFile *project(FileId rel_id, std::vector<FieldId> fields);
+    HeapFile *project(FileId rel_id, std::vector<FieldId> fields,
+                      bool distinct = false, std::uint32_t buffer_pages = 0,
+                      std::uint32_t num_threads = 1,
+                      bool preserve_order = true);
+
+    /**
+     * @brief Sorts a relation with an ExternalSort, using at most
+     *    buffer_pages pages of memory, into a result file with the
+     *    relation's schema. Records with equal keys keep their order.
+     *
+     * @pre Input parameters rel_id is a valid relation id to be sorted
+     *
+     * @param rel_id. FileId corresponding to relation fileid being sorted
+     * @param fields. Vector of fieldids to sort on, most significant first
+     * @param directions. Vector of the SortDirection of each field, or
+     *    empty to sort every field in ascending order
+     * @param buffer_pages. Number of pages of memory the sort may use, 0
+     *    for SORT_BUFFER_PAGES. Budgets under 3 pages are raised to 3.
+     *
+     * @throw MismatchingFieldsRelOpsManager if the fields parameter has
+     *    invalid field Ids or is empty, or directions is not empty and
+     *    does not have one entry per field
+     *
+     * @return HeapFile * of the result file with the sorted records.
+     */
+    HeapFile *sort(FileId rel_id, std::vector<FieldId> fields,
+                   std::vector<SortDirection> directions = {},
+                   std::uint32_t buffer_pages = 0);
 
     /**
      * @brief Runs the Select operation using the type of select given by the
@@ -86,10 +305,253 @@ class RelOpsManager {
      * @param values. Vector of void * corresponding to values for selection
      * @param index_id. FileId with default value INVALID_FILE_ID corresponding 
      *                  to index file id if indexscan is being used. 
+     * @param prefetch_depth. Number of RecordIds an index scan looks ahead
+     *                  to prefetch their heap pages, 0 for no prefetching.
      *
      * @return HeapFile * of the result file with results of the select.
      */
     HeapFile *select(SelectType stype, 
+                     FileId rel_id, std::vector<FieldId> fields, 
+                     std::vector<Comp> comps, std::vector<void *> values, 
+                     FileId index_id = INVALID_FILE_ID,
+                     std::uint32_t prefetch_depth = 0);
+
+    /**
+     * @brief Runs a select followed by a project of its result. An index
+     *    select whose conjuncts and projected fields are all on the index
+     *    key is answered from the index alone, without reading the
+     *    relation; any other narrows each match to the projected fields in
+     *    the select's scan loop and writes it straight to the result.
+     *
+     * @pre Input parameters rel_id is a valid relation id to be selected on,
+     *    and fields and values have the same types.
+     *
+     * @param stype.  SelectType indicating type of select (filescan, index)
+     * @param rel_id. FileId corresponding to relation fileid being selected on
+     * @param fields. Vector of fieldids corresponding to fields being 
+     *                selected on
+     * @param comps.  Vector of Comp corresponding to comparators for selection 
+     * @param values. Vector of void * corresponding to values for selection
+     * @param proj_fields. Vector of fieldids kept in the result, in order
+     * @param index_id. FileId with default value INVALID_FILE_ID corresponding 
+     *                  to index file id if indexscan is being used. 
+     *
+     * @return HeapFile * of the result file with the projected fields of
+     *    the records that match the select.
+     *
+     * @throw MismatchingFieldsRelOpsManager if proj_fields has invalid
+     *    field Ids or is empty
+     */
+    HeapFile *selectProject(SelectType stype, 
+                     FileId rel_id, std::vector<FieldId> fields, 
+                     std::vector<Comp> comps, std::vector<void *> values, 
+                     std::vector<FieldId> proj_fields,
+                     FileId index_id = INVALID_FILE_ID);
+
+    /**
+     * @brief Counts the records that match a select without creating a
+     *    result file. Uses the same FileScan and IndexScan operators as
+     *    select.
+     *
+     * @pre Input parameters rel_id is a valid relation id to be selected on,
+     *    and fields and values have the same types.
+     *
+     * @param stype.  SelectType indicating type of select (filescan, index)
+     * @param rel_id. FileId corresponding to relation fileid being selected on
+     * @param fields. Vector of fieldids corresponding to fields being 
+     *                selected on
+     * @param comps.  Vector of Comp corresponding to comparators for selection 
+     * @param values. Vector of void * corresponding to values for selection
+     * @param index_id. FileId with default value INVALID_FILE_ID corresponding 
+     *                  to index file id if indexscan is being used. 
+     *
+     * @return number of records that match the select.
+     */
+    std::uint64_t selectCount(SelectType stype, 
+                     FileId rel_id, std::vector<FieldId> fields, 
+                     std::vector<Comp> comps, std::vector<void *> values, 
+                     FileId index_id = INVALID_FILE_ID);
+
+    /**
+     * @brief Checks if any record matches a select without creating a
+     *    result file. The scan stops at the first match.
+     *
+     * @pre Input parameters rel_id is a valid relation id to be selected on,
+     *    and fields and values have the same types.
+     *
+     * @param stype.  SelectType indicating type of select (filescan, index)
+     * @param rel_id. FileId corresponding to relation fileid being selected on
+     * @param fields. Vector of fieldids corresponding to fields being 
+     *                selected on
+     * @param comps.  Vector of Comp corresponding to comparators for selection 
+     * @param values. Vector of void * corresponding to values for selection
+     * @param index_id. FileId with default value INVALID_FILE_ID corresponding 
+     *                  to index file id if indexscan is being used. 
+     *
+     * @return True if at least one record matches the select.
+     */
+    bool selectExists(SelectType stype, 
+                     FileId rel_id, std::vector<FieldId> fields, 
+                     std::vector<Comp> comps, std::vector<void *> values, 
+                     FileId index_id = INVALID_FILE_ID);
+
+    /**
+     * @brief Runs the Select operation using one of the relops layer select
+     *    types given by the argument stype. Takes the same arguments as the
+     *    SelectType version, so the two can be compared directly.
+     *
+     * @pre Input parameters rel_id is a valid relation id to be selected on,
+     *    and fields and values have the same types.
+     *
+     * @param stype.  RelOpsSelectType indicating type of select (vector,
+     *                parallel, range index, auto)
+     * @param rel_id. FileId corresponding to relation fileid being selected on
+     * @param fields. Vector of fieldids corresponding to fields being 
+     *                selected on
+     * @param comps.  Vector of Comp corresponding to comparators for selection 
+     * @param values. Vector of void * corresponding to values for selection
+     * @param index_id. FileId with default value INVALID_FILE_ID corresponding 
+     *                  to index file id for index based select types. For
+     *                  AutoSelectT, the hash index the planner may use.
+     * @param num_threads. Number of worker threads for parallel select
+     *                     types, 0 to use one per core.
+     *
+     * @return HeapFile * of the result file with results of the select.
+     */
+    HeapFile *select(RelOpsSelectType stype, 
+                     FileId rel_id, std::vector<FieldId> fields, 
+                     std::vector<Comp> comps, std::vector<void *> values, 
+                     FileId index_id = INVALID_FILE_ID,
+                     std::uint32_t num_threads = 0);
+
+    /**
+     * @brief Runs a select on the access path the cost model estimates is
+     *    cheapest: a file scan, a scan of one of the given hash indexes, an
+     *    intersection of several of them, or a range scan of an ordered
+     *    index built with buildOrderedIndex. Selectivities come from the
+     *    statistics collected by analyze when the relation has them. The
+     *    plan chosen is kept and returned by getLastSelectPlan.
+     *
+     * @pre Input parameters rel_id is a valid relation id to be selected on,
+     *    and fields and values have the same types.
+     *
+     * @param rel_id. FileId corresponding to relation fileid being selected on
+     * @param fields. Vector of fieldids corresponding to fields being 
+     *                selected on
+     * @param comps.  Vector of Comp corresponding to comparators for selection 
+     * @param values. Vector of void * corresponding to values for selection
+     * @param index_ids. Vector of FileIds of hash indexes that may be used;
+     *                   ones not on the relation are ignored
+     *
+     * @return HeapFile * of the result file with results of the select.
+     */
+    HeapFile *selectAuto(FileId rel_id, std::vector<FieldId> fields, 
+                     std::vector<Comp> comps, std::vector<void *> values, 
+                     std::vector<FileId> index_ids = {});
+
+    /**
+     * @brief Returns the plan chosen by the last automatic select.
+     */
+    const SelectPlan &getLastSelectPlan();
+
+    /**
+     * @brief Runs a select using several hash indexes on the relation.
+     *    Each index is probed with the equality conjuncts on its key, the
+     *    RecordIds found are combined as bitmaps, and only the surviving
+     *    records are fetched, in page order.
+     *
+     * @pre Input parameters rel_id is a valid relation id to be selected on,
+     *    and fields and values have the same types.
+     *
+     * @param rel_id. FileId corresponding to relation fileid being selected on
+     * @param fields. Vector of fieldids corresponding to fields being 
+     *                selected on
+     * @param comps.  Vector of Comp corresponding to comparators for selection 
+     * @param values. Vector of void * corresponding to values for selection
+     * @param index_ids. Vector of FileIds of hash indexes on the relation
+     * @param op. RidAndT to AND every conjunct, RidOrT to OR the conjuncts
+     *            of each index with each other (other conjuncts are ANDed)
+     *
+     * @return HeapFile * of the result file with results of the select.
+     */
+    HeapFile *selectMultiIndex(FileId rel_id, std::vector<FieldId> fields, 
+                     std::vector<Comp> comps, std::vector<void *> values, 
+                     std::vector<FileId> index_ids, RidBitmapOp op = RidAndT);
+
+    /**
+     * @brief Selects the records whose value of one field is in a list of
+     *    values (field IN (v1, ..., vK)) into one result file. With a hash
+     *    index on the field all the values are probed by one operator;
+     *    without one the relation is scanned once against a hash set of
+     *    the values.
+     *
+     * @pre rel_id is a valid relation id, and the values have the type of
+     *    the field.
+     *
+     * @param stype.  SelectType indicating type of select (filescan, index)
+     * @param rel_id. FileId corresponding to relation fileid being selected on
+     * @param field.  FieldId of the field compared to the list
+     * @param in_values. Vector of void * to the values of the list
+     * @param index_id. FileId with default value INVALID_FILE_ID corresponding 
+     *                  to a hash index on field alone if indexscan is used. 
+     *
+     * @return HeapFile * of the result file with results of the select.
+     */
+    HeapFile *selectIn(SelectType stype, FileId rel_id, FieldId field,
+                     std::vector<void *> in_values,
+                     FileId index_id = INVALID_FILE_ID);
+
+    /**
+     * @brief Opens a cursor over the records that match a select. No result
+     *    file is created: the cursor reads from the relation or index only
+     *    as its records are asked for, and stops after limit records.
+     *
+     * @pre Input parameters rel_id is a valid relation id to be selected on,
+     *    and fields and values have the same types.
+     *
+     * @param stype.  SelectType indicating type of select (filescan, index)
+     * @param rel_id. FileId corresponding to relation fileid being selected on
+     * @param fields. Vector of fieldids corresponding to fields being 
+     *                selected on
+     * @param comps.  Vector of Comp corresponding to comparators for selection 
+     * @param values. Vector of void * corresponding to values for selection
+     * @param index_id. FileId with default value INVALID_FILE_ID corresponding 
+     *                  to index file id if indexscan is being used. 
+     * @param limit. Maximum number of records the cursor returns, 0 for no
+     *               limit.
+     *
+     * @return SelectCursor * over the matching records. The caller deletes
+     *    it once done, and values must stay valid until then.
+     */
+    SelectCursor *selectCursor(SelectType stype, 
+                     FileId rel_id, std::vector<FieldId> fields, 
+                     std::vector<Comp> comps, std::vector<void *> values, 
+                     FileId index_id = INVALID_FILE_ID,
+                     std::uint64_t limit = 0);
+
+    /**
+     * @brief Prepares a select to be run many times with different values.
+     *    The fields are validated and the select's state is built once;
+     *    each PreparedSelect::execute only rebinds the values. No result
+     *    file is created.
+     *
+     * @pre Input parameters rel_id is a valid relation id to be selected on,
+     *    and fields and values have the same types.
+     *
+     * @param stype.  SelectType indicating type of select (filescan, index)
+     * @param rel_id. FileId corresponding to relation fileid being selected on
+     * @param fields. Vector of fieldids corresponding to fields being 
+     *                selected on
+     * @param comps.  Vector of Comp corresponding to comparators for selection 
+     * @param values. Vector of void * with example values of the fields'
+     *                types, used to compile the select
+     * @param index_id. FileId with default value INVALID_FILE_ID corresponding 
+     *                  to index file id if indexscan is being used. 
+     *
+     * @return PreparedSelect * for the select. The caller deletes it once
+     *    done.
+     */
+    PreparedSelect *prepareSelect(SelectType stype, 
                      FileId rel_id, std::vector<FieldId> fields, 
                      std::vector<Comp> comps, std::vector<void *> values, 
                      FileId index_id = INVALID_FILE_ID);
@@ -182,6 +644,133 @@ class RelOpsManager {
      */
     int result_num;
 
+    /**
+     * Zone maps of relations, by relation FileId
+     */
+    std::map<FileId, ZoneMap *> zone_maps;
+
+    /**
+     * Returns the zone map of a relation, loading it from its side file if
+     * it is not in memory yet. Returns nullptr if the relation has none.
+     */
+    ZoneMap *_getZoneMap(FileId rel_id);
+
+    /**
+     * Creates a FileScan or IndexScan select with no result file. File
+     * scans are given the relation's zone map.
+     */
+    Select *_newSelect(SelectType stype, FileId rel_id,
+        std::vector<FieldId> fields, std::vector<Comp> comps,
+        std::vector<void *> values, FileId index_id);
+
+    /**
+     * Returns the path of the side file for a relation's zone map
+     */
+    std::string _zoneMapPath(FileId rel_id);
+
+    /**
+     * Relations whose side structures were modified in memory and not yet
+     * saved
+     */
+    std::set<FileId> dirty_rels;
+
+    /**
+     * Columnar copies of relations, by relation FileId
+     */
+    std::map<FileId, PaxFile *> pax_files;
+
+    /**
+     * True if operator results get a columnar copy
+     */
+    bool columnar_results;
+
+    /**
+     * Returns the columnar copy of a relation, loading it from its side
+     * file if it is not in memory yet. Returns nullptr if there is none.
+     */
+    PaxFile *_getPaxFile(FileId rel_id);
+
+    /**
+     * Returns the path of the side file for a relation's columnar copy
+     */
+    std::string _paxPath(FileId rel_id);
+
+    /**
+     * If columnar results are on, creates an empty columnar copy of a
+     * result file and has op fill it. Returns nullptr otherwise.
+     */
+    PaxFile *_attachResultPax(Operation *op, FileId res_id);
+
+    /**
+     * Saves the columnar copy of a result file made by _attachResultPax
+     * and deletes it from memory
+     */
+    void _saveResultPax(FileId res_id, PaxFile *res_pax);
+
+    /**
+     * Drops the columnar copy of a relation, in memory and on disk
+     */
+    void _dropPaxFile(FileId rel_id);
+
+    /**
+     * Ordered indexes of relations, by relation FileId and indexed field
+     */
+    std::map<std::pair<FileId, FieldId>, BTreeIndex *> ordered_indexes;
+
+    /**
+     * Returns the ordered index on a field of a relation, loading it from
+     * its side file if it is not in memory yet. Returns nullptr if there is
+     * none.
+     */
+    BTreeIndex *_getOrderedIndex(FileId rel_id, FieldId fid);
+
+    /**
+     * Returns the path of the side file for an ordered index
+     */
+    std::string _orderedIndexPath(FileId rel_id, FieldId fid);
+
+    /**
+     * Drops every ordered index of a relation, in memory and on disk
+     */
+    void _dropOrderedIndexes(FileId rel_id);
+
+    /**
+     * Statistics of relations, by relation FileId
+     */
+    std::map<FileId, TableStats *> table_stats;
+
+    /**
+     * Returns the statistics of a relation, loading them from their side
+     * file if they are not in memory yet. Returns nullptr if there are none.
+     */
+    TableStats *_getTableStats(FileId rel_id);
+
+    /**
+     * Returns the path of the side file for a relation's statistics
+     */
+    std::string _statsPath(FileId rel_id);
+
+    /**
+     * Takes a record about to be updated or deleted out of its relation's
+     * statistics, if there are any
+     */
+    void _removeFromStats(FileId rel_id, RecordId rid);
+
+    /**
+     * Prefetcher of heap pages for index scans, started on first use
+     */
+    PagePrefetcher *prefetcher;
+
+    /**
+     * Returns the prefetcher, starting it if needed
+     */
+    PagePrefetcher *_getPrefetcher();
+
+    /**
+     * Plan chosen by the last automatic select
+     */
+    SelectPlan last_plan;
+
     /**
      * Creates a result file with the schema of the joined relations
      */
@@ -203,6 +792,14 @@ class RelOpsManager {
      */
     FileId _createResultFile(Schema *schema);
 
+    /**
+     * Runs a FileScan or IndexScan select with no result file, stopping
+     * after limit matches (0 for no limit), and returns the match count
+     */
+    std::uint64_t _countMatches(SelectType stype, FileId rel_id, 
+        std::vector<FieldId> fields, std::vector<Comp> comps,
+        std::vector<void *> values, FileId index_id, std::uint64_t limit);
+
 };
 
 #endif
@@ -38,15 +38,29 @@
 #include "hashjoin.h"
 #include "parallelHashJoin.h"
 #include "project.h"
+#include "distinctproject.h"
+#include "parallelproject.h"
+#include "externalsort.h"
+#include "paxfile.h"
 #include "testingconfig.h"
 
 /**
  * SwatDB RelOpsManager Class.
  * The interface to the relational operators of the system:
  * manages relational operations on files.
- * This file contains the project interface of RelOpsManager
+ * This file contains the project and sort interface of RelOpsManager
  */
 
+/*
+ * Default number of pages of memory for a distinct project's hash table
+ */
+static const std::uint32_t DISTINCT_BUFFER_PAGES = 64;
+
+/*
+ * Default number of pages of memory for a sort
+ */
+static const std::uint32_t SORT_BUFFER_PAGES = 64;
+
 
 /**
  * @brief Runs the Project operation 
@@ -55,22 +69,97 @@
  *
  * @param rel_id. FileId corresponding to relation fileid being projected on
  * @param fields. Vector of fieldids corresponding to fields being projected on
+ * @param distinct. True to remove duplicate result records, with a
+ *    DistinctProject.
+ * @param buffer_pages. Number of pages of memory a distinct project's hash
+ *    table may use before it spills to partition files, 0 for
+ *    DISTINCT_BUFFER_PAGES.
+ * @param num_threads. Number of worker threads for a project that is not
+ *    distinct: 1 runs a Project on the calling thread, any other number a
+ *    ParallelProject (0 for one per core).
+ * @param preserve_order. True for a parallel project to keep the
+ *    relation's record order in its result.
  *
  * @return HeapFile * of the result file with results of the project.
  *
  * @throw MismatchingFieldsRelOpsManager if the fields parameter has
  *    invalid field Ids or is empty
  */
-HeapFile *RelOpsManager::project(FileId rel_id, std::vector<FieldId> fields) {
+HeapFile *RelOpsManager::project(FileId rel_id, std::vector<FieldId> fields,
+    bool distinct, std::uint32_t buffer_pages, std::uint32_t num_threads,
+    bool preserve_order) {
   
   FileId res_id;
   Project *project;
 
   res_id = this->_createProjectRes(this->catalog->getSchema(rel_id), fields);
-  project = new Project(rel_id, res_id, fields, this->catalog);
+  if( distinct ){
+    if( buffer_pages == 0 ) buffer_pages = DISTINCT_BUFFER_PAGES;
+    project = new DistinctProject(rel_id, res_id, fields, buffer_pages,
+        this->catalog);
+  }
+  else if( num_threads != 1 ){
+    project = new ParallelProject(rel_id, res_id, fields, num_threads,
+        preserve_order, this->catalog);
+    project->setBufferManager(this->buf_mgr);
+  }
+  else {
+    project = new Project(rel_id, res_id, fields, this->catalog);
+    project->setBufferManager(this->buf_mgr);
+  }
+  PaxFile *res_pax = this->_attachResultPax(project, res_id);
   project->runOperation();
 
   delete project;
+  this->_saveResultPax(res_id, res_pax);
+
+  return ((HeapFile *)this->catalog->getFile(res_id));
+}
+
+
+/**
+ * @brief Sorts a relation with an ExternalSort, using at most buffer_pages
+ *    pages of memory, into a result file with the relation's schema.
+ *    Records with equal keys keep their order.
+ *
+ * @pre Input parameters rel_id is a valid relation id to be sorted
+ *
+ * @param rel_id. FileId corresponding to relation fileid being sorted
+ * @param fields. Vector of fieldids to sort on, most significant first
+ * @param directions. Vector of the SortDirection of each field, or empty
+ *    to sort every field in ascending order
+ * @param buffer_pages. Number of pages of memory the sort may use, 0 for
+ *    SORT_BUFFER_PAGES
+ *
+ * @return HeapFile * of the result file with the sorted records.
+ *
+ * @throw MismatchingFieldsRelOpsManager if the fields parameter has
+ *    invalid field Ids or is empty, or directions is not empty and does not
+ *    have one entry per field
+ */
+HeapFile *RelOpsManager::sort(FileId rel_id, std::vector<FieldId> fields,
+    std::vector<SortDirection> directions, std::uint32_t buffer_pages) {
+
+  Schema *schema = this->catalog->getSchema(rel_id);
+  if( fields.empty() ) throw MismatchingFieldsRelOpsManager();
+  for( FieldId fid : fields ){
+    if( fid >= schema->field_list.size() ){
+      throw MismatchingFieldsRelOpsManager();
+    }
+  }
+  if( directions.empty() ) directions.assign(fields.size(), AscendingT);
+  if( directions.size() != fields.size() ){
+    throw MismatchingFieldsRelOpsManager();
+  }
+  if( buffer_pages == 0 ) buffer_pages = SORT_BUFFER_PAGES;
+
+  FileId res_id = this->_createResultFile(schema);
+  ExternalSort *sort = new ExternalSort(rel_id, res_id, fields, directions,
+      buffer_pages, this->catalog);
+  PaxFile *res_pax = this->_attachResultPax(sort, res_id);
+  sort->runOperation();
+  delete sort;
+  this->_saveResultPax(res_id, res_pax);
 
   return ((HeapFile *)this->catalog->getFile(res_id));
 }
@@ -31,6 +31,20 @@
 #include "select.h"
 #include "filescan.h"
 #include "indexscan.h"
+#include "vectorfilescan.h"
+#include "parallelfilescan.h"
+#include "zonemap.h"
+#include "paxfile.h"
+#include "selectcursor.h"
+#include "rangeindexscan.h"
+#include "btreeindex.h"
+#include "inlistscan.h"
+#include "multiindexscan.h"
+#include "selectplanner.h"
+#include "recordlayout.h"
+#include "pageprefetcher.h"
+#include "indexonlyscan.h"
+#include "preparedselect.h"
 #include "join.h"
 #include "tupleNLJ.h"
 #include "indexNLJ.h"
@@ -38,6 +52,7 @@
 #include "hashjoin.h"
 #include "parallelHashJoin.h"
 #include "project.h"
+#include "pinnedpagescan.h"
 #include "testingconfig.h"
 
 /**
@@ -62,33 +77,502 @@
  * @param values. Vector of void * corresponding to values for selection
  * @param index_id. FileId with default value INVALID_FILE_ID corresponding to 
  *    index file id if indexscan is being used. 
+ * @param prefetch_depth. Number of RecordIds an index scan looks ahead to
+ *    prefetch their heap pages, 0 for no prefetching.
  *
  * @return HeapFile * of the result file with results of the select.
  */
 HeapFile *RelOpsManager::select(SelectType stype, FileId rel_id, 
                   std::vector<FieldId> fields, std::vector<Comp> comps,
                   std::vector<void *> values, 
-                  FileId index_id){
+                  FileId index_id, std::uint32_t prefetch_depth){
 
   FileId res_id = this->_createResultFile(this->catalog->getSchema(rel_id));
+  PaxFile *res_pax = nullptr;
 
   switch(stype) {
     case FileScanT: {
       FileScan *fscan = new FileScan(rel_id, res_id, fields, comps, values,
           this->catalog);
+      fscan->setBufferManager(this->buf_mgr);
+      // relations with a zone map get one for their result too
+      ZoneMap *zone_map = this->_getZoneMap(rel_id);
+      ZoneMap *res_zone_map = nullptr;
+      if( zone_map != nullptr ){
+        res_zone_map = new ZoneMap(this->catalog->getSchema(res_id));
+        fscan->setZoneMap(zone_map);
+        fscan->setResultZoneMap(res_zone_map);
+      }
+      res_pax = this->_attachResultPax(fscan, res_id);
       fscan->runOperation();
       delete fscan;
+      if( res_zone_map != nullptr ){
+        this->zone_maps[res_id] = res_zone_map;
+      }
       break;
      }
     case IndexT: {
       IndexScan *iscan = new IndexScan(rel_id, index_id, res_id, 
           fields, comps, values, this->catalog);
+      if( prefetch_depth > 0 ){
+        iscan->setPrefetcher(this->_getPrefetcher(), prefetch_depth);
+      }
+      res_pax = this->_attachResultPax(iscan, res_id);
       iscan->runOperation();
       delete iscan;
       break;
     }
     default: throw;
   }
+  this->_saveResultPax(res_id, res_pax);
+  return ((HeapFile *)this->catalog->getFile(res_id));
+
+}
+
+/**
+ * @brief Runs a select followed by a project of its result. An index select
+ *    covered by its index (see IndexOnlyScan::isCovered) builds the result
+ *    tuples from the probe values, one per index entry, without reading the
+ *    relation. Any other select is run with a projection set, so each match
+ *    is narrowed to the projected fields in the scan loop and written
+ *    straight into the project result, with no intermediate file.
+ *
+ * @pre Input parameters rel_id is a valid relation id to be selected on,
+ *    and fields and values have the same types.
+ *
+ * @param stype. SelectType indicating type of select (filescan, index)
+ * @param rel_id. FileId corresponding to relation fileid being selected on
+ * @param fields. Vector of fieldids corresponding to fields being selected on
+ * @param comps. Vector of Comp corresponding to comparators for selection 
+ * @param values. Vector of void * corresponding to values for selection
+ * @param proj_fields. Vector of fieldids kept in the result, in order
+ * @param index_id. FileId with default value INVALID_FILE_ID corresponding to 
+ *    index file id if indexscan is being used. 
+ *
+ * @return HeapFile * of the result file with the projected fields of the
+ *    records that match the select.
+ *
+ * @throw MismatchingFieldsRelOpsManager if proj_fields has invalid field
+ *    Ids or is empty
+ */
+HeapFile *RelOpsManager::selectProject(SelectType stype, FileId rel_id, 
+                  std::vector<FieldId> fields, std::vector<Comp> comps,
+                  std::vector<void *> values, 
+                  std::vector<FieldId> proj_fields, FileId index_id){
+
+  HashIndexFile *index_file = nullptr;
+  if( stype == IndexT ){
+    index_file = (HashIndexFile *)this->catalog->getFile(index_id);
+  }
+  if( index_file != nullptr && 
+      this->catalog->getRelationFileId(index_id) == rel_id &&
+      IndexOnlyScan::isCovered(index_file, fields, comps, proj_fields) ){
+    FileId res_id = this->_createProjectRes(
+        this->catalog->getSchema(rel_id), proj_fields);
+    IndexOnlyScan *oscan = new IndexOnlyScan(rel_id, index_id, res_id,
+        fields, comps, values, proj_fields, this->catalog);
+    PaxFile *res_pax = this->_attachResultPax(oscan, res_id);
+    oscan->runOperation();
+    delete oscan;
+    this->_saveResultPax(res_id, res_pax);
+    return ((HeapFile *)this->catalog->getFile(res_id));
+  }
+
+  FileId res_id = this->_createProjectRes(this->catalog->getSchema(rel_id),
+      proj_fields);
+  Select *sel;
+  switch(stype) {
+    case FileScanT: {
+      FileScan *fscan = new FileScan(rel_id, res_id, fields, comps, values,
+          this->catalog);
+      fscan->setBufferManager(this->buf_mgr);
+      fscan->setZoneMap(this->_getZoneMap(rel_id));
+      sel = fscan;
+      break;
+    }
+    case IndexT:
+      sel = new IndexScan(rel_id, index_id, res_id, fields, comps, values,
+          this->catalog);
+      break;
+    default: throw;
+  }
+  sel->setProjection(proj_fields);
+  PaxFile *res_pax = this->_attachResultPax(sel, res_id);
+  sel->runOperation();
+  delete sel;
+  this->_saveResultPax(res_id, res_pax);
+  return ((HeapFile *)this->catalog->getFile(res_id));
+}
+
+
+/**
+ * @brief Counts the records that match a select without creating a result
+ *    file.
+ *
+ * @pre Input parameters rel_id is a valid relation id to be selected on,
+ *    and fields and values have the same types.
+ *
+ * @param stype. SelectType indicating type of select (filescan, index)
+ * @param rel_id. FileId corresponding to relation fileid being selected on
+ * @param fields. Vector of fieldids corresponding to fields being selected on
+ * @param comps. Vector of Comp corresponding to comparators for selection 
+ * @param values. Vector of void * corresponding to values for selection
+ * @param index_id. FileId with default value INVALID_FILE_ID corresponding to 
+ *    index file id if indexscan is being used. 
+ *
+ * @return number of records that match the select.
+ */
+std::uint64_t RelOpsManager::selectCount(SelectType stype, FileId rel_id, 
+                  std::vector<FieldId> fields, std::vector<Comp> comps,
+                  std::vector<void *> values, 
+                  FileId index_id){
+
+  return this->_countMatches(stype, rel_id, fields, comps, values, index_id,
+      0);
+}
+
+/**
+ * @brief Checks if any record matches a select without creating a result
+ *    file. The scan stops at the first match.
+ *
+ * @pre Input parameters rel_id is a valid relation id to be selected on,
+ *    and fields and values have the same types.
+ *
+ * @param stype. SelectType indicating type of select (filescan, index)
+ * @param rel_id. FileId corresponding to relation fileid being selected on
+ * @param fields. Vector of fieldids corresponding to fields being selected on
+ * @param comps. Vector of Comp corresponding to comparators for selection 
+ * @param values. Vector of void * corresponding to values for selection
+ * @param index_id. FileId with default value INVALID_FILE_ID corresponding to 
+ *    index file id if indexscan is being used. 
+ *
+ * @return True if at least one record matches the select.
+ */
+bool RelOpsManager::selectExists(SelectType stype, FileId rel_id, 
+                  std::vector<FieldId> fields, std::vector<Comp> comps,
+                  std::vector<void *> values, 
+                  FileId index_id){
+
+  return this->_countMatches(stype, rel_id, fields, comps, values, index_id,
+      1) > 0;
+}
+
+/**
+ * Runs a FileScan or IndexScan select with no result file, stopping after
+ * limit matches (0 for no limit), and returns the match count.
+ *
+ * Helper function for selectCount and selectExists.
+ */
+std::uint64_t RelOpsManager::_countMatches(SelectType stype, FileId rel_id, 
+    std::vector<FieldId> fields, std::vector<Comp> comps,
+    std::vector<void *> values, FileId index_id, std::uint64_t limit) {
+
+  Select *sel = this->_newSelect(stype, rel_id, fields, comps, values,
+      index_id);
+  sel->setMatchLimit(limit);
+  sel->runOperation();
+  std::uint64_t count = sel->getNumMatches();
+  delete sel;
+  return count;
+}
+
+/**
+ * @brief Runs a select on the access path the cost model estimates is
+ *    cheapest. The relation's size comes from its record count and the
+ *    length of its page list; the candidates are the given hash indexes
+ *    and the ordered indexes on the fields selected on.
+ *
+ * @pre Input parameters rel_id is a valid relation id to be selected on,
+ *    and fields and values have the same types.
+ *
+ * @param rel_id. FileId corresponding to relation fileid being selected on
+ * @param fields. Vector of fieldids corresponding to fields being selected on
+ * @param comps. Vector of Comp corresponding to comparators for selection 
+ * @param values. Vector of void * corresponding to values for selection
+ * @param index_ids. Vector of FileIds of hash indexes that may be used
+ *
+ * @return HeapFile * of the result file with results of the select.
+ */
+HeapFile *RelOpsManager::selectAuto(FileId rel_id,
+                  std::vector<FieldId> fields, std::vector<Comp> comps,
+                  std::vector<void *> values, std::vector<FileId> index_ids){
+
+  Schema *schema = this->catalog->getSchema(rel_id);
+  HeapFile *file = (HeapFile *)this->catalog->getFile(rel_id);
+  std::uint64_t num_recs = file->getNumRecs();
+  std::uint64_t num_pages = PinnedPageScan::listPages(file).size();
+
+  SelectPlanner planner(this->catalog, rel_id, num_recs, num_pages);
+  for( FileId index_id : index_ids ){
+    planner.addHashIndex(index_id);
+  }
+  std::vector<FieldId> seen;
+  for( FieldId fid : fields ){
+    if( std::find(seen.begin(), seen.end(), fid) != seen.end() ) continue;
+    seen.push_back(fid);
+    planner.addOrderedIndex(this->_getOrderedIndex(rel_id, fid));
+  }
+  planner.setTableStats(this->_getTableStats(rel_id));
+  this->last_plan = planner.plan(fields, comps, values);
+
+  switch(this->last_plan.path) {
+    case IndexScanP:
+      return this->select(IndexT, rel_id, fields, comps, values,
+          this->last_plan.index_ids[0]);
+    case MultiIndexP:
+      return this->selectMultiIndex(rel_id, fields, comps, values,
+          this->last_plan.index_ids, RidAndT);
+    case RangeIndexP: {
+      FileId res_id = this->_createResultFile(schema);
+      RangeIndexScan *rscan = new RangeIndexScan(rel_id, res_id, fields,
+          comps, values, this->last_plan.ordered_index, this->catalog);
+      PaxFile *res_pax = this->_attachResultPax(rscan, res_id);
+      rscan->runOperation();
+      delete rscan;
+      this->_saveResultPax(res_id, res_pax);
+      return ((HeapFile *)this->catalog->getFile(res_id));
+    }
+    default:
+      return this->select(FileScanT, rel_id, fields, comps, values);
+  }
+}
+
+/**
+ * @brief Returns the plan chosen by the last automatic select.
+ */
+const SelectPlan &RelOpsManager::getLastSelectPlan() {
+  return this->last_plan;
+}
+
+/**
+ * @brief Runs a select using several hash indexes on the relation. Each
+ *    index is probed with the equality conjuncts on its key, the RecordIds
+ *    found are combined as bitmaps, and only the surviving records are
+ *    fetched, in page order.
+ *
+ * @pre Input parameters rel_id is a valid relation id to be selected on,
+ *    and fields and values have the same types.
+ *
+ * @param rel_id. FileId corresponding to relation fileid being selected on
+ * @param fields. Vector of fieldids corresponding to fields being selected on
+ * @param comps. Vector of Comp corresponding to comparators for selection 
+ * @param values. Vector of void * corresponding to values for selection
+ * @param index_ids. Vector of FileIds of hash indexes on the relation
+ * @param op. RidAndT to AND every conjunct, RidOrT to OR the conjuncts of
+ *    each index with each other (other conjuncts are ANDed)
+ *
+ * @return HeapFile * of the result file with results of the select.
+ */
+HeapFile *RelOpsManager::selectMultiIndex(FileId rel_id,
+                  std::vector<FieldId> fields, std::vector<Comp> comps,
+                  std::vector<void *> values, std::vector<FileId> index_ids,
+                  RidBitmapOp op){
+
+  FileId res_id = this->_createResultFile(this->catalog->getSchema(rel_id));
+  MultiIndexScan *mscan = new MultiIndexScan(rel_id, index_ids, res_id,
+      fields, comps, values, op, this->catalog);
+  PaxFile *res_pax = this->_attachResultPax(mscan, res_id);
+  mscan->runOperation();
+  delete mscan;
+  this->_saveResultPax(res_id, res_pax);
+  return ((HeapFile *)this->catalog->getFile(res_id));
+}
+
+/**
+ * @brief Selects the records whose value of one field is in a list of
+ *    values (field IN (v1, ..., vK)) into one result file.
+ *
+ * @pre rel_id is a valid relation id, and the values have the type of the
+ *    field.
+ *
+ * @param stype. SelectType indicating type of select (filescan, index)
+ * @param rel_id. FileId corresponding to relation fileid being selected on
+ * @param field. FieldId of the field compared to the list
+ * @param in_values. Vector of void * to the values of the list
+ * @param index_id. FileId with default value INVALID_FILE_ID corresponding to 
+ *    a hash index on field alone if indexscan is being used. 
+ *
+ * @return HeapFile * of the result file with results of the select.
+ */
+HeapFile *RelOpsManager::selectIn(SelectType stype, FileId rel_id,
+                  FieldId field, std::vector<void *> in_values,
+                  FileId index_id){
+
+  if( stype != IndexT ) index_id = INVALID_FILE_ID;
+  FileId res_id = this->_createResultFile(this->catalog->getSchema(rel_id));
+  InListScan *lscan = new InListScan(rel_id, index_id, res_id, field,
+      in_values, this->catalog);
+  PaxFile *res_pax = this->_attachResultPax(lscan, res_id);
+  lscan->runOperation();
+  delete lscan;
+  this->_saveResultPax(res_id, res_pax);
+  return ((HeapFile *)this->catalog->getFile(res_id));
+}
+
+/**
+ * Creates a FileScan or IndexScan select with no result file. File scans
+ * are given the relation's zone map.
+ *
+ * Helper function for _countMatches and selectCursor.
+ */
+Select *RelOpsManager::_newSelect(SelectType stype, FileId rel_id,
+    std::vector<FieldId> fields, std::vector<Comp> comps,
+    std::vector<void *> values, FileId index_id) {
+
+  switch(stype) {
+    case FileScanT: {
+      FileScan *fscan = new FileScan(rel_id, INVALID_FILE_ID, fields, comps,
+          values, this->catalog);
+      fscan->setBufferManager(this->buf_mgr);
+      fscan->setZoneMap(this->_getZoneMap(rel_id));
+      return fscan;
+    }
+    case IndexT: 
+      return new IndexScan(rel_id, index_id, INVALID_FILE_ID, fields, comps,
+          values, this->catalog);
+    default: throw;
+  }
+}
+
+/**
+ * @brief Opens a cursor over the records that match a select. No result
+ *    file is created: the cursor reads from the relation or index only as
+ *    its records are asked for, and stops after limit records.
+ *
+ * @pre Input parameters rel_id is a valid relation id to be selected on,
+ *    and fields and values have the same types.
+ *
+ * @param stype. SelectType indicating type of select (filescan, index)
+ * @param rel_id. FileId corresponding to relation fileid being selected on
+ * @param fields. Vector of fieldids corresponding to fields being selected on
+ * @param comps. Vector of Comp corresponding to comparators for selection 
+ * @param values. Vector of void * corresponding to values for selection
+ * @param index_id. FileId with default value INVALID_FILE_ID corresponding to 
+ *    index file id if indexscan is being used. 
+ * @param limit. Maximum number of records the cursor returns, 0 for no limit.
+ *
+ * @return SelectCursor * over the matching records, deleted by the caller.
+ */
+SelectCursor *RelOpsManager::selectCursor(SelectType stype, FileId rel_id, 
+                  std::vector<FieldId> fields, std::vector<Comp> comps,
+                  std::vector<void *> values, FileId index_id,
+                  std::uint64_t limit){
+
+  Select *sel = this->_newSelect(stype, rel_id, fields, comps, values,
+      index_id);
+  sel->setMatchLimit(limit);
+  return new SelectCursor(sel);
+}
+
+/**
+ * @brief Prepares a select to be run many times with different values. The
+ *    select is built with no result file, so executing it writes nothing.
+ *
+ * @pre Input parameters rel_id is a valid relation id to be selected on,
+ *    and fields and values have the same types.
+ *
+ * @param stype. SelectType indicating type of select (filescan, index)
+ * @param rel_id. FileId corresponding to relation fileid being selected on
+ * @param fields. Vector of fieldids corresponding to fields being selected on
+ * @param comps. Vector of Comp corresponding to comparators for selection 
+ * @param values. Vector of void * with example values of the fields' types
+ * @param index_id. FileId with default value INVALID_FILE_ID corresponding to 
+ *    index file id if indexscan is being used. 
+ *
+ * @return PreparedSelect * for the select.
+ */
+PreparedSelect *RelOpsManager::prepareSelect(SelectType stype, 
+                  FileId rel_id, std::vector<FieldId> fields, 
+                  std::vector<Comp> comps, std::vector<void *> values, 
+                  FileId index_id){
+
+  Select *sel = this->_newSelect(stype, rel_id, fields, comps, values,
+      index_id);
+  return new PreparedSelect(sel);
+}
+
+/**
+ * @brief Runs the Select operation using one of the relops layer select
+ *    types given by the argument stype.
+ *
+ * @pre Input parameters rel_id is a valid relation id to be selected on,
+ *    and fields and values have the same types.
+ *
+ * @param stype. RelOpsSelectType indicating type of select (vector, parallel,
+ *    range index, auto)
+ * @param rel_id. FileId corresponding to relation fileid being selected on
+ * @param fields. Vector of fieldids corresponding to fields being selected on
+ * @param comps. Vector of Comp corresponding to comparators for selection 
+ * @param values. Vector of void * corresponding to values for selection
+ * @param index_id. FileId with default value INVALID_FILE_ID corresponding to 
+ *    index file id for index based select types. For AutoSelectT it is the
+ *    hash index the cost model may choose.
+ * @param num_threads. Number of worker threads for parallel select types,
+ *    0 to use one per core.
+ *
+ * @throw MismatchingFieldsRelOpsManager for RangeIndexScanT if no range
+ *    or equality conjunct is on a field with an ordered index.
+ *
+ * @return HeapFile * of the result file with results of the select.
+ */
+HeapFile *RelOpsManager::select(RelOpsSelectType stype, FileId rel_id, 
+                  std::vector<FieldId> fields, std::vector<Comp> comps,
+                  std::vector<void *> values, 
+                  FileId index_id, std::uint32_t num_threads){
+
+  if( stype == AutoSelectT ){
+    return this->selectAuto(rel_id, fields, comps, values, {index_id});
+  }
+
+  // a range index scan uses the ordered index of the first conjunct that
+  // can bound it
+  BTreeIndex *ordered_index = nullptr;
+  if( stype == RangeIndexScanT ){
+    for( size_t i = 0; i < fields.size() && ordered_index == nullptr; i++ ){
+      if( comps[i] != EQUAL && comps[i] != LESS && comps[i] != LESS_EQUAL &&
+          comps[i] != GREATER && comps[i] != GREATER_EQUAL ){
+        continue;
+      }
+      ordered_index = this->_getOrderedIndex(rel_id, fields[i]);
+    }
+    if( ordered_index == nullptr ){
+      throw MismatchingFieldsRelOpsManager();
+    }
+  }
+
+  FileId res_id = this->_createResultFile(this->catalog->getSchema(rel_id));
+  PaxFile *res_pax = nullptr;
+
+  switch(stype) {
+    case VectorFileScanT: {
+      VectorFileScan *vscan = new VectorFileScan(rel_id, res_id, fields, 
+          comps, values, this->catalog);
+      vscan->setPaxFile(this->_getPaxFile(rel_id));
+      res_pax = this->_attachResultPax(vscan, res_id);
+      vscan->runOperation();
+      delete vscan;
+      break;
+    }
+    case ParallelFileScanT: {
+      ParallelFileScan *pscan = new ParallelFileScan(rel_id, res_id, fields,
+          comps, values, num_threads, this->catalog);
+      pscan->setBufferManager(this->buf_mgr);
+      res_pax = this->_attachResultPax(pscan, res_id);
+      pscan->runOperation();
+      delete pscan;
+      break;
+    }
+    case RangeIndexScanT: {
+      RangeIndexScan *rscan = new RangeIndexScan(rel_id, res_id, fields,
+          comps, values, ordered_index, this->catalog);
+      res_pax = this->_attachResultPax(rscan, res_id);
+      rscan->runOperation();
+      delete rscan;
+      break;
+    }
+    default: throw;
+  }
+  this->_saveResultPax(res_id, res_pax);
   return ((HeapFile *)this->catalog->getFile(res_id));
 
 }
\ No newline at end of file
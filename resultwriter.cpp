@@ -0,0 +1,118 @@
+#include <string>
+#include <cstring>
+#include <vector>
+#include <mutex>
+#include "swatdb_types.h"
+#include "resultwriter.h"
+#include "bufferlatch.h"
+#include "recordlayout.h"
+#include "operation.h"
+#include "record.h"
+#include "heapfile.h"
+#include "zonemap.h"
+#include "paxfile.h"
+
+/**
+ * @brief Constructor for ResultWriter.
+ *
+ * @pre state has been initialized by Operation::_initState.
+ *
+ * @param state. fileState * of the result file.
+ */
+ResultWriter::ResultWriter(fileState *state) {
+
+  this->file = (HeapFile *)state->file;
+  this->rec = state->rec;
+  this->layout = new RecordLayout(state->schema);
+  this->num_appended = 0;
+  this->zone_map = nullptr;
+  this->pax_file = nullptr;
+}
+
+/**
+ * @brief Destructor for ResultWriter.
+ */
+ResultWriter::~ResultWriter() {
+  delete this->layout;
+}
+
+/**
+ * @brief Returns space for the caller to build one record in place. The
+ *    space is the scratch record's own bytes, which are handed to the
+ *    result file as they are by commit.
+ *
+ * @return char * to record size bytes for the new record.
+ */
+char *ResultWriter::reserve() {
+  return RecordLayout::getBytes(this->rec);
+}
+
+/**
+ * @brief Inserts the record built in the scratch record into the result
+ *    file and adds it to the result's zone map and columnar copy. The
+ *    insert goes through the buffer manager, so it is made under the buffer
+ *    latch in case workers of a parallel operator are pinning pages
+ *    meanwhile.
+ *
+ * @pre reserve was called and the record at its address is complete.
+ */
+void ResultWriter::commit() {
+
+  char *rec_bytes = RecordLayout::getBytes(this->rec);
+  RecordId rid;
+  {
+    std::lock_guard<std::mutex> guard(buffer_latch);
+    rid = this->file->insertRecord( *this->rec );
+  }
+  if( this->zone_map != nullptr ){
+    this->zone_map->addRecord(rid, rec_bytes);
+  }
+  if( this->pax_file != nullptr ){
+    this->pax_file->append(rec_bytes);
+  }
+  this->num_appended++;
+}
+
+/**
+ * @brief Adds one record to the result.
+ *
+ * @param bytes. Raw bytes of a record with the result file's schema.
+ */
+void ResultWriter::append(const char *bytes) {
+  memcpy(this->reserve(), bytes, this->layout->getRecordSize());
+  this->commit();
+}
+
+/**
+ * @brief Adds one record to the result.
+ *
+ * @param rec. Record * with the result file's schema.
+ */
+void ResultWriter::append(Record *rec) {
+  this->append(RecordLayout::getBytes(rec));
+}
+
+/**
+ * @brief Returns the number of records appended so far.
+ */
+std::uint64_t ResultWriter::getNumAppended() {
+  return this->num_appended;
+}
+
+/**
+ * @brief Sets a zone map of the result file to keep up to date.
+ *
+ * @param zone_map. ZoneMap * of the result file, nullptr for none.
+ */
+void ResultWriter::setZoneMap(ZoneMap *zone_map) {
+  this->zone_map = zone_map;
+}
+
+/**
+ * @brief Sets a columnar copy of the result file to keep up to date.
+ *
+ * @param pax_file. PaxFile * of the result file, nullptr for none.
+ */
+void ResultWriter::setPaxFile(PaxFile *pax_file) {
+  this->pax_file = pax_file;
+}
@@ -0,0 +1,132 @@
+#ifndef _SWATDB_RESULTWRITER_H_
+#define _SWATDB_RESULTWRITER_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include "swatdb_types.h"
+
+class HeapFile;
+class Record;
+class RecordLayout;
+class ZoneMap;
+class PaxFile;
+struct fileState;
+
+/**
+ * ResultWriter is how operators add records to their result file. A
+ * record is either appended from bytes the operator already has, or built
+ * in place in the result file's scratch record and committed, so output is
+ * copied once on its way to the file. Every record is inserted into the
+ * result HeapFile as soon as it is appended or committed. Side structures
+ * of the result, its zone map and columnar copy, are kept up to date here
+ * as records are inserted.
+ */
+class ResultWriter {
+
+  public:
+
+    /**
+     * @brief Constructor for ResultWriter.
+     *
+     * @pre state has been initialized by Operation::_initState.
+     *
+     * @param state. fileState * of the result file. Its rec is used as
+     *    scratch space when records are written to the file.
+     */
+    ResultWriter(fileState *state);
+
+    /**
+     * @brief Destructor for ResultWriter.
+     */
+    ~ResultWriter();
+
+    /**
+     * @brief Returns space for the caller to build one record in place.
+     *    Nothing is added to the result until commit is called.
+     *
+     * @return char * to record size bytes for the new record.
+     */
+    char *reserve();
+
+    /**
+     * @brief Inserts the record built in the space returned by reserve into
+     *    the result file.
+     *
+     * @pre reserve was called and the record at its address is complete.
+     */
+    void commit();
+
+    /**
+     * @brief Adds one record to the result.
+     *
+     * @param bytes. Raw bytes of a record with the result file's schema.
+     */
+    void append(const char *bytes);
+
+    /**
+     * @brief Adds one record to the result.
+     *
+     * @param rec. Record * with the result file's schema.
+     */
+    void append(Record *rec);
+
+    /**
+     * @brief Returns the number of records appended so far.
+     */
+    std::uint64_t getNumAppended();
+
+    /**
+     * @brief Sets a zone map of the result file to keep up to date. Every
+     *    record written to the file from then on is added to it.
+     *
+     * @param zone_map. ZoneMap * of the result file, nullptr for none.
+     */
+    void setZoneMap(ZoneMap *zone_map);
+
+    /**
+     * @brief Sets a columnar copy of the result file to keep up to date.
+     *    Every record written to the file from then on is appended to it.
+     *
+     * @param pax_file. PaxFile * of the result file, nullptr for none.
+     */
+    void setPaxFile(PaxFile *pax_file);
+
+  private:
+
+    /**
+     * The result file
+     */
+    HeapFile *file;
+
+    /**
+     * Scratch record each record is built in
+     */
+    Record *rec;
+
+    /**
+     * Byte layout of the result file's records
+     */
+    RecordLayout *layout;
+
+    /**
+     * Number of records appended since construction
+     */
+    std::uint64_t num_appended;
+
+    /**
+     * Zone map of the result file, nullptr if there is none
+     */
+    ZoneMap *zone_map;
+
+    /**
+     * Columnar copy of the result file, nullptr if there is none
+     */
+    PaxFile *pax_file;
+
+};
+
+#endif
@@ -0,0 +1,320 @@
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <iterator>
+#include "swatdb_types.h"
+#include "ridbitmap.h"
+
+/**
+ * Returns true if a container holds a slot.
+ */
+static bool hasSlot(const RidContainer &cont, std::uint16_t slot) {
+  if( !cont.dense ){
+    return std::binary_search(cont.slots.begin(), cont.slots.end(), slot);
+  }
+  if( cont.words.size() <= slot / 64u ) return false;
+  return cont.words[slot / 64] >> ( slot % 64 ) & 1;
+}
+
+/**
+ * Returns the number of bits set in a container's words.
+ */
+static std::uint32_t countBits(const std::vector<std::uint64_t> &words) {
+  std::uint32_t count = 0;
+  for( std::uint64_t word : words ){
+    count += __builtin_popcountll(word);
+  }
+  return count;
+}
+
+/**
+ * @brief Constructor for an empty RidBitmap.
+ *
+ * @param file_id. FileId of the relation the RecordIds belong to.
+ */
+RidBitmap::RidBitmap(FileId file_id) {
+  this->file_id = file_id;
+  this->scan_pos = this->pages.end();
+}
+
+/**
+ * @brief Destructor for RidBitmap.
+ */
+RidBitmap::~RidBitmap() {
+}
+
+/**
+ * @brief Removes every RecordId from the bitmap.
+ */
+void RidBitmap::clear() {
+  this->pages.clear();
+  this->scan_pos = this->pages.end();
+}
+
+/**
+ * @brief Adds a RecordId to the bitmap. A new page starts as an empty slot
+ *    array; a slot is inserted in order, and the array turns into a bitmap
+ *    once that is smaller.
+ *
+ * @param rid. RecordId to add.
+ */
+void RidBitmap::add(RecordId rid) {
+  RidContainer &cont = this->pages[rid.page_id.page_num];
+  std::uint16_t slot = rid.slot_id;
+  if( cont.dense ){
+    if( cont.words.size() <= slot / 64u ){
+      cont.words.resize(slot / 64 + 1, 0);
+    }
+    std::uint64_t bit = (std::uint64_t)1 << ( slot % 64 );
+    if( cont.words[slot / 64] & bit ) return;
+    cont.words[slot / 64] |= bit;
+    cont.count++;
+    return;
+  }
+  auto pos = std::lower_bound(cont.slots.begin(), cont.slots.end(), slot);
+  if( pos != cont.slots.end() && *pos == slot ) return;
+  cont.slots.insert(pos, slot);
+  cont.count++;
+  RidBitmap::_optimize(cont);
+}
+
+/**
+ * @brief Returns true if the bitmap holds rid.
+ */
+bool RidBitmap::contains(RecordId rid) {
+  auto found = this->pages.find(rid.page_id.page_num);
+  if( found == this->pages.end() ) return false;
+  return hasSlot(found->second, rid.slot_id);
+}
+
+/**
+ * @brief Returns the number of RecordIds in the bitmap.
+ */
+std::uint64_t RidBitmap::getNumRids() {
+  std::uint64_t count = 0;
+  for( auto &entry : this->pages ){
+    count += entry.second.count;
+  }
+  return count;
+}
+
+/**
+ * @brief Keeps only the RecordIds that are also in other. Pages missing
+ *    from other, or left with no slots, are dropped.
+ *
+ * @param other. RidBitmap of the same relation.
+ */
+void RidBitmap::intersectWith(const RidBitmap &other) {
+  auto it = this->pages.begin();
+  while( it != this->pages.end() ){
+    auto found = other.pages.find(it->first);
+    if( found != other.pages.end() ){
+      RidBitmap::_intersect(it->second, found->second);
+    }
+    if( found != other.pages.end() && it->second.count > 0 ){
+      it++;
+    }
+    else {
+      it = this->pages.erase(it);
+    }
+  }
+  this->scan_pos = this->pages.end();
+}
+
+/**
+ * @brief Adds every RecordId of other.
+ *
+ * @param other. RidBitmap of the same relation.
+ */
+void RidBitmap::unionWith(const RidBitmap &other) {
+  for( const auto &entry : other.pages ){
+    auto found = this->pages.find(entry.first);
+    if( found == this->pages.end() ){
+      this->pages[entry.first] = entry.second;
+    }
+    else {
+      RidBitmap::_union(found->second, entry.second);
+    }
+  }
+  this->scan_pos = this->pages.end();
+}
+
+/**
+ * @brief Swaps the contents of two bitmaps of the same relation.
+ *
+ * @param other. RidBitmap to swap with.
+ */
+void RidBitmap::swap(RidBitmap &other) {
+  this->pages.swap(other.pages);
+  this->scan_pos = this->pages.end();
+  other.scan_pos = other.pages.end();
+}
+
+/**
+ * @brief Starts reading the RecordIds back from the first page.
+ */
+void RidBitmap::startScan() {
+  this->scan_pos = this->pages.begin();
+}
+
+/**
+ * @brief Appends the RecordIds of the next page, in slot order, to rids.
+ *
+ * @param rids. Vector the RecordIds are appended to.
+ *
+ * @return False if every page has been read.
+ */
+bool RidBitmap::nextPage(std::vector<RecordId> &rids) {
+  if( this->scan_pos == this->pages.end() ) return false;
+
+  RecordId rid;
+  rid.page_id.file_id = this->file_id;
+  rid.page_id.page_num = this->scan_pos->first;
+  const RidContainer &cont = this->scan_pos->second;
+  if( !cont.dense ){
+    for( std::uint16_t slot : cont.slots ){
+      rid.slot_id = slot;
+      rids.push_back(rid);
+    }
+  }
+  for( size_t w = 0; cont.dense && w < cont.words.size(); w++ ){
+    std::uint64_t word = cont.words[w];
+    while( word != 0 ){
+      rid.slot_id = w * 64 + __builtin_ctzll(word);
+      rids.push_back(rid);
+      word &= word - 1;
+    }
+  }
+  this->scan_pos++;
+  return true;
+}
+
+/**
+ * @brief Stores a container as a bitmap or as a slot array, whichever is
+ *    smaller: an array takes two bytes per slot, a bitmap eight bytes per
+ *    64 slots up to the highest one. Trailing empty words are dropped.
+ *
+ * @param cont. RidContainer to convert.
+ */
+void RidBitmap::_optimize(RidContainer &cont) {
+  if( !cont.dense ){
+    if( cont.slots.empty() ) return;
+    std::size_t num_words = cont.slots.back() / 64 + 1;
+    if( cont.count * sizeof(std::uint16_t) >
+        num_words * sizeof(std::uint64_t) ){
+      RidBitmap::_toBitmap(cont);
+    }
+    return;
+  }
+
+  while( !cont.words.empty() && cont.words.back() == 0 ){
+    cont.words.pop_back();
+  }
+  if( cont.count * sizeof(std::uint16_t) >=
+      cont.words.size() * sizeof(std::uint64_t) ){
+    return;
+  }
+  std::vector<std::uint16_t> slots;
+  slots.reserve(cont.count);
+  for( size_t w = 0; w < cont.words.size(); w++ ){
+    std::uint64_t word = cont.words[w];
+    while( word != 0 ){
+      slots.push_back(w * 64 + __builtin_ctzll(word));
+      word &= word - 1;
+    }
+  }
+  cont.slots.swap(slots);
+  std::vector<std::uint64_t>().swap(cont.words);
+  cont.dense = false;
+}
+
+/**
+ * @brief Converts a container to a bitmap, if it is a slot array.
+ *
+ * @param cont. RidContainer to convert.
+ */
+void RidBitmap::_toBitmap(RidContainer &cont) {
+  if( cont.dense ) return;
+  cont.words.assign(cont.slots.empty() ? 0 : cont.slots.back() / 64 + 1, 0);
+  for( std::uint16_t slot : cont.slots ){
+    cont.words[slot / 64] |= (std::uint64_t)1 << ( slot % 64 );
+  }
+  std::vector<std::uint16_t>().swap(cont.slots);
+  cont.dense = true;
+}
+
+/**
+ * @brief Keeps only the slots of cont that are also in other. Two bitmaps
+ *    are ANDed a word at a time; otherwise the result is at most as big as
+ *    a slot array, so the array's slots are checked against the other
+ *    container.
+ *
+ * @param cont. RidContainer that keeps the result.
+ * @param other. RidContainer of the same page.
+ */
+void RidBitmap::_intersect(RidContainer &cont, const RidContainer &other) {
+  if( cont.dense && other.dense ){
+    if( cont.words.size() > other.words.size() ){
+      cont.words.resize(other.words.size());
+    }
+    for( size_t w = 0; w < cont.words.size(); w++ ){
+      cont.words[w] &= other.words[w];
+    }
+    cont.count = countBits(cont.words);
+    RidBitmap::_optimize(cont);
+    return;
+  }
+
+  const RidContainer &array = cont.dense ? other : cont;
+  const RidContainer &probe = cont.dense ? cont : other;
+  std::vector<std::uint16_t> slots;
+  for( std::uint16_t slot : array.slots ){
+    if( hasSlot(probe, slot) ) slots.push_back(slot);
+  }
+  cont.slots.swap(slots);
+  std::vector<std::uint64_t>().swap(cont.words);
+  cont.dense = false;
+  cont.count = cont.slots.size();
+  RidBitmap::_optimize(cont);
+}
+
+/**
+ * @brief Adds every slot of other to cont. Two slot arrays are merged;
+ *    otherwise cont is made a bitmap and other's slots are ORed in.
+ *
+ * @param cont. RidContainer that keeps the result.
+ * @param other. RidContainer of the same page.
+ */
+void RidBitmap::_union(RidContainer &cont, const RidContainer &other) {
+  if( !cont.dense && !other.dense ){
+    std::vector<std::uint16_t> slots;
+    slots.reserve(cont.slots.size() + other.slots.size());
+    std::set_union(cont.slots.begin(), cont.slots.end(),
+        other.slots.begin(), other.slots.end(), std::back_inserter(slots));
+    cont.slots.swap(slots);
+    cont.count = cont.slots.size();
+    RidBitmap::_optimize(cont);
+    return;
+  }
+
+  RidBitmap::_toBitmap(cont);
+  if( other.dense ){
+    if( cont.words.size() < other.words.size() ){
+      cont.words.resize(other.words.size(), 0);
+    }
+    for( size_t w = 0; w < other.words.size(); w++ ){
+      cont.words[w] |= other.words[w];
+    }
+  }
+  else {
+    if( !other.slots.empty() && cont.words.size() <= other.slots.back() / 64u ){
+      cont.words.resize(other.slots.back() / 64 + 1, 0);
+    }
+    for( std::uint16_t slot : other.slots ){
+      cont.words[slot / 64] |= (std::uint64_t)1 << ( slot % 64 );
+    }
+  }
+  cont.count = countBits(cont.words);
+  RidBitmap::_optimize(cont);
+}
@@ -0,0 +1,171 @@
+#ifndef _SWATDB_RIDBITMAP_H_
+#define _SWATDB_RIDBITMAP_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include <map>
+#include "swatdb_types.h"
+
+/**
+ * How the RidBitmaps of several index probes are combined: intersected for
+ * conjuncts that must all hold, united for alternatives
+ */
+enum RidBitmapOp {RidAndT, RidOrT};
+
+/**
+ * Struct for the slots of one page in a RidBitmap, stored like a Roaring
+ * bitmap container: a sorted array of 16 bit slot ids while the page has
+ * few of them, and one bit per slot once the bits take less space.
+ */
+struct RidContainer {
+  /**
+   * True if the slots are kept in words, False if they are in slots
+   */
+  bool dense;
+  /**
+   * Sorted slot ids, if not dense
+   */
+  std::vector<std::uint16_t> slots;
+  /**
+   * One bit per slot, in 64 bit words, if dense
+   */
+  std::vector<std::uint64_t> words;
+  /**
+   * Number of slots in the container
+   */
+  std::uint32_t count;
+};
+
+/**
+ * RidBitmap is a set of RecordIds of one relation, kept as one container
+ * per page that has any; pages without RecordIds take no space. A page's
+ * container is a sorted slot array while it holds few RecordIds and a
+ * bitmap once that is smaller, so a sparse probe result costs two bytes per
+ * RecordId rather than a word per 64 slots. Adding the same RecordId twice
+ * has no effect, bitmaps can be intersected and united container by
+ * container, and the RecordIds are read back a page at a time in page
+ * order, so each heap page is visited once for all of its RecordIds.
+ */
+class RidBitmap {
+
+  public:
+
+    /**
+     * @brief Constructor for an empty RidBitmap.
+     *
+     * @param file_id. FileId of the relation the RecordIds belong to.
+     */
+    RidBitmap(FileId file_id);
+
+    /**
+     * @brief Destructor for RidBitmap.
+     */
+    ~RidBitmap();
+
+    /**
+     * @brief Removes every RecordId from the bitmap.
+     */
+    void clear();
+
+    /**
+     * @brief Adds a RecordId to the bitmap.
+     *
+     * @param rid. RecordId to add.
+     */
+    void add(RecordId rid);
+
+    /**
+     * @brief Returns true if the bitmap holds rid.
+     */
+    bool contains(RecordId rid);
+
+    /**
+     * @brief Returns the number of RecordIds in the bitmap.
+     */
+    std::uint64_t getNumRids();
+
+    /**
+     * @brief Keeps only the RecordIds that are also in other.
+     *
+     * @param other. RidBitmap of the same relation.
+     */
+    void intersectWith(const RidBitmap &other);
+
+    /**
+     * @brief Adds every RecordId of other.
+     *
+     * @param other. RidBitmap of the same relation.
+     */
+    void unionWith(const RidBitmap &other);
+
+    /**
+     * @brief Swaps the contents of two bitmaps of the same relation.
+     *
+     * @param other. RidBitmap to swap with.
+     */
+    void swap(RidBitmap &other);
+
+    /**
+     * @brief Starts reading the RecordIds back from the first page.
+     */
+    void startScan();
+
+    /**
+     * @brief Appends the RecordIds of the next page, in slot order, to
+     *    rids.
+     *
+     * @param rids. Vector the RecordIds are appended to.
+     *
+     * @return False if every page has been read.
+     */
+    bool nextPage(std::vector<RecordId> &rids);
+
+  private:
+
+    /**
+     * @brief Stores a container as a bitmap or as a slot array, whichever
+     *    is smaller, and drops trailing empty words.
+     *
+     * @param cont. RidContainer to convert.
+     */
+    static void _optimize(RidContainer &cont);
+
+    /**
+     * @brief Converts a container to a bitmap.
+     *
+     * @param cont. RidContainer to convert.
+     */
+    static void _toBitmap(RidContainer &cont);
+
+    /**
+     * @brief Keeps only the slots of cont that are also in other.
+     */
+    static void _intersect(RidContainer &cont, const RidContainer &other);
+
+    /**
+     * @brief Adds every slot of other to cont.
+     */
+    static void _union(RidContainer &cont, const RidContainer &other);
+
+    /**
+     * FileId of the relation
+     */
+    FileId file_id;
+
+    /**
+     * Slots of each page that has any, by page number
+     */
+    std::map<PageNum, RidContainer> pages;
+
+    /**
+     * Next page to read back
+     */
+    std::map<PageNum, RidContainer>::iterator scan_pos;
+
+};
+
+#endif
@@ -1,12 +1,29 @@
 #include <string>
+#include <cstring>
 #include <vector>
+#include <new>
 #include <iostream>
+#include <chrono>
+#include <math.h>
 #include "swatdb_types.h"
 #include "swatdb_exceptions.h"
 #include "schema.h"
 #include "select.h"
 #include "operation.h"
 #include "catalog.h"
+#include "record.h"
+#include "recordlayout.h"
+#include "predicate.h"
+#include "resultwriter.h"
+#include "heapfile.h"
+#include "heapfilescanner.h"
+
+/*
+ * One record in every SAMPLE_INTERVAL has its conjunct checks timed, and
+ * the conjuncts are reordered every REORDER_INTERVAL records.
+ */
+static const std::uint64_t SAMPLE_INTERVAL = 64;
+static const std::uint64_t REORDER_INTERVAL = 4096;
 
 
 /**
@@ -25,7 +42,9 @@
  *    values, or comps
  *
  * @pre file_name is the name of a valid file.
- * @post private variables have been set accordingly.
+ * @post private variables have been set accordingly, and each conjunct has
+ *    been compiled into a Predicate with its field offset, type and value
+ *    resolved from the schema.
  */
 Select::Select(FileId rel_id, FileId result_id, std::vector<FieldId> fields, 
        std::vector<Comp> comps, std::vector<void *> values, Catalog *catalog) : 
@@ -59,11 +78,320 @@ Select::Select(FileId rel_id, FileId result_id, std::vector<FieldId> fields,
       throw MismatchingFieldsRelOpsManager();
     }
   }
+
+  // compile the conjuncts
+  this->layout = new RecordLayout(s);
+  for( size_t i = 0; i < fields.size(); i++ ){
+    this->preds.push_back(Predicate(this->layout->getField(fields[i]),
+          comps[i], values[i]));
+    this->stats.push_back({0, 0, 0, 0});
+    this->order.push_back(i);
+  }
+  this->num_checked = 0;
+  this->num_matches = 0;
+  this->match_limit = 0;
+  this->scanner = nullptr;
+  this->scanner_mem = nullptr;
+  this->rank.resize(fields.size());
+  this->result_layout = nullptr;
 }
 
 /**
  * @brief Destructor for the Select Operation.
  */
 Select::~Select() {
+  if( this->scanner != nullptr ) this->scanner->~HeapFileScanner();
+  ::operator delete(this->scanner_mem);
   this->_delState(&this->file_state);
+  delete this->layout;
+  delete this->result_layout;
+}
+
+/**
+ * @brief Returns the counters of each conjunct, indexed by the conjunct's
+ *    position in the fields, comps and values vectors.
+ */
+const std::vector<ConjunctStats> &Select::getConjunctStats() const {
+  return this->stats;
+}
+
+/**
+ * @brief Returns the order conjuncts are currently checked in, as positions
+ *    in the fields, comps and values vectors.
+ */
+const std::vector<std::uint32_t> &Select::getConjunctOrder() const {
+  return this->order;
+}
+
+/**
+ * @brief Sets the number of matching records after which the select stops
+ *    scanning. 0, the default, means no limit.
+ *
+ * @param limit. Maximum number of matches to produce.
+ */
+void Select::setMatchLimit(std::uint64_t limit) {
+  this->match_limit = limit;
+}
+
+/**
+ * @brief Returns the number of records that matched every conjunct in the
+ *    last run of the operation.
+ */
+std::uint64_t Select::getNumMatches() const {
+  return this->num_matches;
+}
+
+/**
+ * @brief Starts a pull based run of the select. Matching records are then
+ *    produced one at a time by getNextMatch.
+ *
+ * @pre The select is not already open.
+ */
+void Select::open() {
+  this->num_matches = 0;
+  this->_openScan();
+}
+
+/**
+ * @brief Advances the scan to the next record that passes every conjunct.
+ *    Once match_limit matches have been returned no more records are read.
+ *
+ * @pre open has been called.
+ *
+ * @param out. Record * the matching record is copied into, or nullptr to
+ *    leave it only in file_state.rec.
+ *
+ * @return RecordId of the matching record, INVALID_RECORD_ID if there are no
+ *    more matches.
+ */
+RecordId Select::getNextMatch(Record *out) {
+  RecordId rid;
+  const char *bytes = this->_nextMatchBytes(&rid);
+  if( bytes == nullptr ) return rid;
+
+  // a match read in place is copied out of its page here
+  char *rec_bytes = RecordLayout::getBytes(this->file_state.rec);
+  if( bytes != rec_bytes ){
+    memcpy(rec_bytes, bytes, this->layout->getRecordSize());
+  }
+  if( out != nullptr ){
+    memcpy(RecordLayout::getBytes(out), bytes, this->layout->getRecordSize());
+  }
+  return rid;
+}
+
+/**
+ * @brief Advances the scan to the next record that passes every conjunct,
+ *    without copying it. Once match_limit matches have been returned no
+ *    more records are read.
+ *
+ * @param rid. Set to the RecordId of the match, INVALID_RECORD_ID if there
+ *    are no more matches.
+ *
+ * @return const char * to the match's bytes, valid until the next fetch,
+ *    nullptr if there are no more matches.
+ */
+const char *Select::_nextMatchBytes(RecordId *rid) {
+  if( this->match_limit != 0 && this->num_matches >= this->match_limit ){
+    *rid = INVALID_RECORD_ID;
+    return nullptr;
+  }
+  Record *rec = this->file_state.rec;
+  const char *bytes;
+  while( ( bytes = this->_fetchNextBytes(rec, rid) ) != nullptr ){
+    if( this->_passes(rec, bytes) ) break;
+  }
+  if( bytes != nullptr ) this->num_matches++;
+  return bytes;
+}
+
+/**
+ * @brief Ends a pull based run of the select, releasing its scanner.
+ */
+void Select::close() {
+  this->_closeScan();
+}
+
+/**
+ * @brief Replaces the values of the conjuncts, recompiling each predicate's
+ *    value in place.
+ *
+ * @pre The select is not open.
+ *
+ * @param values. Vector of void * lined up with the select's fields.
+ *
+ * @throw MismatchingFieldsRelOpsManager if values is not the size of the
+ *    select's fields.
+ */
+void Select::bindValues(const std::vector<void *> &values) {
+  if( values.size() != this->values.size() ){
+    throw MismatchingFieldsRelOpsManager();
+  }
+  for( size_t i = 0; i < values.size(); i++ ){
+    this->values[i] = values[i];
+    this->preds[i].setValue(values[i]);
+  }
+}
+
+/**
+ * @brief Starts a scan of the whole heap file selected on. The scanner is
+ *    built in memory kept from the last scan.
+ */
+void Select::_openScan() {
+  if( this->scanner_mem == nullptr ){
+    this->scanner_mem = ::operator new(sizeof(HeapFileScanner));
+  }
+  this->scanner = new (this->scanner_mem) HeapFileScanner(
+      (HeapFile *)this->file_state.file);
+}
+
+/**
+ * @brief Reads the next record of the heap file scan.
+ *
+ * @param rec. Record * the record is read into.
+ *
+ * @return RecordId of the record, INVALID_RECORD_ID at the end of the file.
+ */
+RecordId Select::_fetchNext(Record *rec) {
+  return this->scanner->getNext(rec);
+}
+
+/**
+ * @brief Reads the next candidate record into rec with _fetchNext and
+ *    returns rec's bytes.
+ *
+ * @param rec. Record * the candidate is read into.
+ * @param rid. Set to the RecordId of the candidate, INVALID_RECORD_ID at
+ *    the end of the scan.
+ *
+ * @return const char * to rec's bytes, nullptr at the end of the scan.
+ */
+const char *Select::_fetchNextBytes(Record *rec, RecordId *rid) {
+  *rid = this->_fetchNext(rec);
+  if( *rid == INVALID_RECORD_ID ) return nullptr;
+  return RecordLayout::getBytes(rec);
+}
+
+/**
+ * @brief Ends the heap file scan.
+ */
+void Select::_closeScan() {
+  if( this->scanner != nullptr ) this->scanner->~HeapFileScanner();
+  this->scanner = nullptr;
+}
+
+/**
+ * @brief Makes the select write only some fields of each match to its
+ *    result file. The copy plan is built here so the scan loop only runs
+ *    its memcpys.
+ *
+ * @pre The result file's schema is made of proj_fields of the relation's
+ *    schema, in order, as created by _createProjectRes.
+ *
+ * @param proj_fields. Vector of field ids kept in the result, in order.
+ */
+void Select::setProjection(std::vector<FieldId> proj_fields) {
+  this->proj_fields = proj_fields;
+  delete this->result_layout;
+  this->result_layout = new RecordLayout(this->result_state.schema);
+  this->copy_plan = RecordLayout::makeCopyPlan(*this->layout, proj_fields,
+      *this->result_layout);
+}
+
+/**
+ * @brief Runs the select to completion by pulling every match and adding it
+ *    to the result file if there is one. With a projection each match's
+ *    fields are copied straight into space reserved by the result writer,
+ *    as Project does.
+ *
+ * @post Result file, if any, has been populated with the matching records.
+ */
+void Select::_runScan() {
+  this->open();
+  RecordId rid;
+  const char *src;
+  while( ( src = this->_nextMatchBytes(&rid) ) != nullptr ){
+    if( this->result_writer == nullptr ) continue;
+    if( this->result_layout == nullptr ){
+      this->result_writer->append(src);
+      continue;
+    }
+    char *dest = this->result_writer->reserve();
+    for( const CopyRun &run : this->copy_plan ){
+      memcpy(dest + run.dst_offset, src + run.src_offset, run.length);
+    }
+    this->result_writer->commit();
+  }
+  this->close();
+}
+
+/**
+ * @brief Checks a record against every conjunct of the select using the
+ *    compiled predicates, stopping at the first one it fails. The conjuncts
+ *    are checked in the current order, their counters are updated, and
+ *    every REORDER_INTERVAL records the order is recomputed from them.
+ *
+ * @param rec. Record * to check, from the relation being selected on,
+ *    used by conjuncts that are not compiled.
+ * @param bytes. Raw bytes of the record, in rec or on a pinned page.
+ *
+ * @return True if the record passes all the conjuncts, False otherwise.
+ */
+bool Select::_passes(Record *rec, const char *bytes) {
+  bool timed = ( ++this->num_checked % SAMPLE_INTERVAL ) == 0;
+  bool passes = true;
+
+  for( std::uint32_t i : this->order ){
+    ConjunctStats &stat = this->stats[i];
+    bool match;
+    if( timed ){
+      auto start = std::chrono::steady_clock::now();
+      match = this->preds[i].matches(rec, bytes);
+      auto end = std::chrono::steady_clock::now();
+      stat.nanos += std::chrono::duration_cast<std::chrono::nanoseconds>(
+          end - start).count();
+      stat.timed++;
+    }
+    else {
+      match = this->preds[i].matches(rec, bytes);
+    }
+    stat.evals++;
+    if( !match ){
+      passes = false;
+      break;
+    }
+    stat.passes++;
+  }
+
+  if( this->num_checked % REORDER_INTERVAL == 0 ){
+    this->_reorderConjuncts();
+  }
+  return passes;
+}
+
+/**
+ * @brief Sorts the conjunct order by estimated cost / (1 - pass rate),
+ *    which puts cheap conjuncts that reject many records first. Conjuncts
+ *    that have not been timed or checked yet get a neutral estimate. The
+ *    order is insertion sorted in place: it has one entry per conjunct and
+ *    is mostly sorted already, and unlike std::stable_sort this allocates
+ *    no buffer.
+ */
+void Select::_reorderConjuncts() {
+  std::vector<double> &rank = this->rank;
+  for( size_t i = 0; i < this->stats.size(); i++ ){
+    const ConjunctStats &stat = this->stats[i];
+    double cost = stat.timed ? (double)stat.nanos / stat.timed : 1.0;
+    double pass_rate = stat.evals ? (double)stat.passes / stat.evals : 0.5;
+    rank[i] = pass_rate >= 1.0 ? HUGE_VAL : cost / (1.0 - pass_rate);
+  }
+  for( size_t i = 1; i < this->order.size(); i++ ){
+    std::uint32_t conj = this->order[i];
+    size_t j = i;
+    while( j > 0 && rank[conj] < rank[this->order[j - 1]] ){
+      this->order[j] = this->order[j - 1];
+      j--;
+    }
+    this->order[j] = conj;
+  }
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include <vector>
 #include "swatdb_types.h"
 #include "operation.h"
+#include "predicate.h"
 
 class Catalog;
 class Schema;
@@ -19,6 +20,31 @@ class HeapFileScanner;
 class Record;
 class Data;
 class Key;
+class RecordLayout;
+
+/**
+ * Struct of counters kept for each conjunct of a select while it runs. They
+ * are used to reorder the conjuncts so the cheapest and most selective run
+ * first.
+ */
+struct ConjunctStats {
+  /**
+   * Number of records the conjunct was checked on
+   */
+  std::uint64_t evals;
+  /**
+   * Number of those records that passed the conjunct
+   */
+  std::uint64_t passes;
+  /**
+   * Number of checks that were timed (one in every sample interval)
+   */
+  std::uint64_t timed;
+  /**
+   * Total nanoseconds spent in the timed checks
+   */
+  std::uint64_t nanos;
+};
 
 /**
  * Select is an abstract class that lays the foundation for select operations
@@ -45,6 +71,8 @@ class Select : public Operation {
      * @throw MismatchingFieldsRelOpsManager if the fields parameter has
      *    incorrect fields or if there are mismatching numbers of fields,
      *    values, or comps
+     *
+     * @post The conjuncts have been compiled into preds.
      */
     Select(FileId rel_id, FileId result_id, std::vector<FieldId> fields,
            std::vector<Comp> comps, std::vector<void *> values, 
@@ -55,7 +83,167 @@ class Select : public Operation {
      */
     ~Select();
 
+    /**
+     * @brief Returns the counters of each conjunct, indexed by the
+     *    conjunct's position in the fields, comps and values vectors.
+     */
+    const std::vector<ConjunctStats> &getConjunctStats() const;
+
+    /**
+     * @brief Returns the order conjuncts are currently checked in, as
+     *    positions in the fields, comps and values vectors.
+     */
+    const std::vector<std::uint32_t> &getConjunctOrder() const;
+
+    /**
+     * @brief Sets the number of matching records after which the select
+     *    stops scanning. 0, the default, means no limit.
+     *
+     * @param limit. Maximum number of matches to produce.
+     */
+    void setMatchLimit(std::uint64_t limit);
+
+    /**
+     * @brief Returns the number of records that matched every conjunct in
+     *    the last run of the operation.
+     */
+    std::uint64_t getNumMatches() const;
+
+    /**
+     * @brief Starts a pull based run of the select. Matching records are
+     *    then produced one at a time by getNextMatch, so a caller can stop
+     *    as soon as it has seen enough of them.
+     *
+     * @pre The select is not already open.
+     */
+    void open();
+
+    /**
+     * @brief Advances the scan to the next record that passes every
+     *    conjunct. The scan stops for good once the match limit is reached.
+     *
+     * @pre open has been called.
+     *
+     * @param out. Record * the matching record is copied into, or nullptr to
+     *    leave it only in the select's own record.
+     *
+     * @return RecordId of the matching record, INVALID_RECORD_ID if there are
+     *    no more matches.
+     */
+    RecordId getNextMatch(Record *out = nullptr);
+
+    /**
+     * @brief Ends a pull based run of the select, releasing its scanner.
+     */
+    void close();
+
+    /**
+     * @brief Replaces the values of the conjuncts so the same select can be
+     *    run again for other values without being rebuilt. Subclasses that
+     *    derive other state from the values override it to refresh that
+     *    too. Does not allocate.
+     *
+     * @pre The select is not open.
+     *
+     * @param values. Vector of void * lined up with the select's fields,
+     *    each of the field's type. They must stay valid while the select
+     *    runs.
+     *
+     * @throw MismatchingFieldsRelOpsManager if values is not the size of
+     *    the select's fields.
+     */
+    virtual void bindValues(const std::vector<void *> &values);
+
+    /**
+     * @brief Makes the select write only some fields of each match to its
+     *    result file, building the narrow tuple straight from the scanned
+     *    record, so a select and project run as one scan with no
+     *    intermediate file.
+     *
+     * @pre The result file's schema is made of proj_fields of the
+     *    relation's schema, in order, as created by _createProjectRes.
+     *
+     * @param proj_fields. Vector of field ids kept in the result, in order.
+     */
+    void setProjection(std::vector<FieldId> proj_fields);
+
   protected:
+
+    /**
+     * @brief Starts the scan that produces candidate records. The default
+     *    scans the whole heap file; subclasses override it to scan through
+     *    an index or a zone map instead.
+     */
+    virtual void _openScan();
+
+    /**
+     * @brief Reads the next candidate record of the scan.
+     *
+     * @param rec. Record * the candidate is read into.
+     *
+     * @return RecordId of the candidate, INVALID_RECORD_ID at the end of the
+     *    scan.
+     */
+    virtual RecordId _fetchNext(Record *rec);
+
+    /**
+     * @brief Reads the next candidate record and returns its bytes. The
+     *    default reads it into rec with _fetchNext; scans over pinned pages
+     *    override it to return the record's bytes on the page, leaving rec
+     *    untouched.
+     *
+     * @param rec. Record * the candidate may be read into.
+     * @param rid. Set to the RecordId of the candidate, INVALID_RECORD_ID
+     *    at the end of the scan.
+     *
+     * @return const char * to the candidate's bytes, valid until the next
+     *    fetch, nullptr at the end of the scan.
+     */
+    virtual const char *_fetchNextBytes(Record *rec, RecordId *rid);
+
+    /**
+     * @brief Ends the scan started by _openScan.
+     */
+    virtual void _closeScan();
+
+    /**
+     * @brief Advances the scan to the next record that passes every
+     *    conjunct, without copying it.
+     *
+     * @param rid. Set to the RecordId of the match, INVALID_RECORD_ID if
+     *    there are no more matches.
+     *
+     * @return const char * to the match's bytes, valid until the next
+     *    fetch, nullptr if there are no more matches.
+     */
+    const char *_nextMatchBytes(RecordId *rid);
+
+    /**
+     * @brief Runs the select to completion by pulling every match and adding
+     *    it, or its projected fields if there is a projection, to the
+     *    result file if there is one.
+     */
+    void _runScan();
+
+    /**
+     * @brief Checks a record against every conjunct of the select using the
+     *    compiled predicates, stopping at the first one it fails. The
+     *    conjuncts are checked in the current order, their counters are
+     *    updated, and every so often the order is recomputed from them.
+     *
+     * @param rec. Record * to check, from the relation being selected on,
+     *    used by conjuncts that are not compiled.
+     * @param bytes. Raw bytes of the record, in rec or on a pinned page.
+     *
+     * @return True if the record passes all the conjuncts, False otherwise.
+     */
+    bool _passes(Record *rec, const char *bytes);
+
+    /**
+     * @brief Sorts the conjunct order by estimated cost / (1 - pass rate),
+     *    which puts cheap conjuncts that reject many records first.
+     */
+    void _reorderConjuncts();
     
     /**
      * The positions of the following three vectors are lined up, so index 0
@@ -81,6 +269,65 @@ class Select : public Operation {
      * fileState struct for the file selected on 
      */
     fileState file_state;
+
+    /**
+     * Byte layout of the records of the file selected on
+     */
+    RecordLayout *layout;
+
+    /**
+     * The conjuncts compiled against layout, lined up with fields, comps and
+     * values
+     */
+    std::vector<Predicate> preds;
+
+    /**
+     * Counters for each conjunct, lined up with preds
+     */
+    std::vector<ConjunctStats> stats;
+
+    /**
+     * Positions in preds in the order they are checked
+     */
+    std::vector<std::uint32_t> order;
+
+    /**
+     * Number of records checked by _passes
+     */
+    std::uint64_t num_checked;
+
+    /**
+     * Number of records returned by getNextMatch, and the number to stop at
+     * (0 for no limit)
+     */
+    std::uint64_t num_matches;
+    std::uint64_t match_limit;
+
+    /**
+     * Scanner used by the default _openScan, nullptr when not scanning. It
+     * is built in scanner_mem, allocated on the first scan and reused by
+     * every later one.
+     */
+    HeapFileScanner *scanner;
+    void *scanner_mem;
+
+    /**
+     * Rank of each conjunct, reused by _reorderConjuncts
+     */
+    std::vector<double> rank;
+
+    /**
+     * Fields written to the result, and the result's layout, nullptr if
+     * whole records are written
+     */
+    std::vector<FieldId> proj_fields;
+    RecordLayout *result_layout;
+
+    /**
+     * Coalesced copies that build a result record from a match, built by
+     * setProjection
+     */
+    std::vector<CopyRun> copy_plan;
     
 };
 
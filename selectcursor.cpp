@@ -0,0 +1,49 @@
+#include <string>
+#include <vector>
+#include "swatdb_types.h"
+#include "selectcursor.h"
+#include "select.h"
+#include "record.h"
+
+/**
+ * @brief Constructor for SelectCursor. The cursor takes ownership of the
+ *    select and opens it. No records are read until getNext is called.
+ *
+ * @pre select was created with no result file, and its match limit is set
+ *    to the cursor's limit.
+ *
+ * @param select. Select * producing the cursor's records.
+ */
+SelectCursor::SelectCursor(Select *select) {
+  this->select = select;
+  this->select->open();
+}
+
+/**
+ * @brief Destructor for SelectCursor. Closes and deletes the select, which
+ *    ends the scan even if not every match has been read.
+ */
+SelectCursor::~SelectCursor() {
+  this->select->close();
+  delete this->select;
+}
+
+/**
+ * @brief Reads the next record that matches the select.
+ *
+ * @param rec. Record * the matching record is copied into. It must have the
+ *    schema of the relation selected on.
+ *
+ * @return RecordId of the record in the relation, INVALID_RECORD_ID if there
+ *    are no more matches or the limit has been reached.
+ */
+RecordId SelectCursor::getNext(Record *rec) {
+  return this->select->getNextMatch(rec);
+}
+
+/**
+ * @brief Returns the number of records returned so far.
+ */
+std::uint64_t SelectCursor::getNumReturned() {
+  return this->select->getNumMatches();
+}
@@ -0,0 +1,68 @@
+#ifndef _SWATDB_SELECTCURSOR_H_
+#define _SWATDB_SELECTCURSOR_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include "swatdb_types.h"
+
+class Select;
+class Record;
+
+/**
+ * SelectCursor returns the results of a select one record at a time, as
+ * the caller asks for them, instead of materializing them into a result
+ * file. Each call to getNext pulls from the underlying HeapFileScanner or
+ * HashIndexScanner only until the next match is found, so the first match
+ * is returned as soon as it is read, and a cursor with a limit stops
+ * reading once it has returned that many records.
+ */
+class SelectCursor {
+
+  public:
+
+    /**
+     * @brief Constructor for SelectCursor. The cursor takes ownership of
+     *    the select and opens it.
+     *
+     * @pre select was created with no result file, and its match limit is
+     *    set to the cursor's limit.
+     *
+     * @param select. Select * producing the cursor's records.
+     */
+    SelectCursor(Select *select);
+
+    /**
+     * @brief Destructor for SelectCursor. Closes and deletes the select.
+     */
+    ~SelectCursor();
+
+    /**
+     * @brief Reads the next record that matches the select.
+     *
+     * @param rec. Record * the matching record is copied into. It must have
+     *    the schema of the relation selected on.
+     *
+     * @return RecordId of the record in the relation, INVALID_RECORD_ID if
+     *    there are no more matches or the limit has been reached.
+     */
+    RecordId getNext(Record *rec);
+
+    /**
+     * @brief Returns the number of records returned so far.
+     */
+    std::uint64_t getNumReturned();
+
+  private:
+
+    /**
+     * Select the records are pulled from
+     */
+    Select *select;
+
+};
+
+#endif
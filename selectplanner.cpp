@@ -0,0 +1,325 @@
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <math.h>
+#include "swatdb_types.h"
+#include "selectplanner.h"
+#include "btreeindex.h"
+#include "tablestats.h"
+#include "recordlayout.h"
+#include "catalog.h"
+#include "file.h"
+#include "hashindexfile.h"
+#include "searchkeyformat.h"
+
+/*
+ * Cost model constants, in units of one page read: checking one record
+ * against the conjuncts, probing a hash index for one key, and adding one
+ * RecordId to a bitmap.
+ */
+static const double CPU_RECORD_COST = 0.01;
+static const double PROBE_COST = 1.0;
+static const double BITMAP_RID_COST = 0.001;
+
+/*
+ * Selectivity estimates used when nothing is known about a field's values
+ */
+static const double EQUAL_SELECTIVITY = 0.1;
+static const double RANGE_SELECTIVITY = 1.0 / 3;
+static const double OTHER_SELECTIVITY = 0.5;
+
+/**
+ * @brief Constructor for SelectPlanner.
+ *
+ * @param catalog. Catalog * for SwatDB.
+ * @param rel_id. FileId of the relation selected on.
+ * @param num_recs. Number of records in the relation.
+ * @param num_pages. Number of pages in the relation.
+ */
+SelectPlanner::SelectPlanner(Catalog *catalog, FileId rel_id,
+    std::uint64_t num_recs, std::uint64_t num_pages) {
+  this->catalog = catalog;
+  this->rel_id = rel_id;
+  this->num_recs = num_recs;
+  this->num_pages = num_pages > 0 ? num_pages : 1;
+  this->stats = nullptr;
+}
+
+/**
+ * @brief Destructor for SelectPlanner.
+ */
+SelectPlanner::~SelectPlanner() {
+}
+
+/**
+ * @brief Adds a hash index that may be used. Indexes that do not exist or
+ *    are not on the relation are ignored.
+ *
+ * @param index_id. FileId of the hash index.
+ */
+void SelectPlanner::addHashIndex(FileId index_id) {
+  if( index_id == INVALID_FILE_ID ) return;
+  if( this->catalog->getFile(index_id) == nullptr ) return;
+  if( this->catalog->getRelationFileId(index_id) != this->rel_id ) return;
+  this->hash_indexes.push_back(index_id);
+}
+
+/**
+ * @brief Adds an ordered index on the relation that may be used.
+ *
+ * @param index. BTreeIndex * on one field of the relation.
+ */
+void SelectPlanner::addOrderedIndex(BTreeIndex *index) {
+  if( index != nullptr ) this->ordered_indexes.push_back(index);
+}
+
+/**
+ * @brief Sets the statistics used to estimate selectivities.
+ *
+ * @param stats. TableStats * of the relation, nullptr for none.
+ */
+void SelectPlanner::setTableStats(TableStats *stats) {
+  this->stats = stats;
+}
+
+/**
+ * @brief Chooses the cheapest access path for a select. Every path reads
+ *    some pages and checks the records it fetches; a hash index scan
+ *    fetches its matches in page order, an intersection pays for every
+ *    probe but fetches only the records all of them match, and a range
+ *    scan descends the tree, reads the leaves in range, and fetches each
+ *    entry's record separately. Stale ordered indexes are not considered.
+ *
+ * @param fields. Vector of field ids for the select operation.
+ * @param comps. Vector of Comps for the select operation.
+ * @param values. Vector of Void * for the select operation.
+ *
+ * @return SelectPlan of the chosen path.
+ */
+SelectPlan SelectPlanner::plan(std::vector<FieldId> fields,
+    std::vector<Comp> comps, std::vector<void *> values) {
+
+  double n = this->num_recs;
+  std::vector<double> sel(fields.size());
+  double all_sel = 1;
+  for( size_t i = 0; i < fields.size(); i++ ){
+    sel[i] = this->_selectivity(fields[i], comps[i], values[i]);
+    all_sel *= sel[i];
+  }
+
+  SelectPlan best;
+  best.path = FileScanP;
+  best.ordered_index = nullptr;
+  best.est_rows = n * all_sel;
+  best.cost = this->num_pages + n * CPU_RECORD_COST;
+  best.file_scan_cost = best.cost;
+
+  // each usable hash index alone, and all of them intersected
+  std::vector<bool> used(fields.size(), false);
+  std::vector<FileId> usable;
+  double and_sel = 1;
+  double probe_rids = 0;
+  for( FileId index_id : this->hash_indexes ){
+    std::vector<bool> is_key(fields.size(), false);
+    if( !this->_covers(index_id, fields, comps, is_key) ) continue;
+    double index_sel = 1;
+    for( size_t i = 0; i < fields.size(); i++ ){
+      if( is_key[i] ) index_sel *= sel[i];
+    }
+    double rows = n * index_sel;
+    double cost = PROBE_COST + this->_pagesTouched(rows) + 
+      rows * CPU_RECORD_COST;
+    if( cost < best.cost ){
+      best.path = IndexScanP;
+      best.index_ids = {index_id};
+      best.cost = cost;
+    }
+    // the intersection needs indexes on disjoint conjuncts
+    std::vector<bool> and_key = used;
+    if( this->_covers(index_id, fields, comps, and_key) ){
+      used = and_key;
+      usable.push_back(index_id);
+      and_sel *= index_sel;
+      probe_rids += rows;
+    }
+  }
+  if( usable.size() > 1 ){
+    double rows = n * and_sel;
+    double cost = usable.size() * PROBE_COST + probe_rids * BITMAP_RID_COST +
+      this->_pagesTouched(rows) + rows * CPU_RECORD_COST;
+    if( cost < best.cost ){
+      best.path = MultiIndexP;
+      best.index_ids = usable;
+      best.cost = cost;
+    }
+  }
+
+  // each usable ordered index; the RelOpsManager drops an ordered index
+  // when its relation is modified, so the count only guards against
+  // changes made through the HeapFile
+  for( BTreeIndex *index : this->ordered_indexes ){
+    if( index->getNumRecs() != this->num_recs ) continue;
+    bool bounded = false;
+    for( size_t i = 0; i < fields.size(); i++ ){
+      if( fields[i] == index->getFieldId() && ( comps[i] == EQUAL ||
+            comps[i] == LESS || comps[i] == LESS_EQUAL ||
+            comps[i] == GREATER || comps[i] == GREATER_EQUAL ) ){
+        bounded = true;
+      }
+    }
+    if( !bounded ) continue;
+    double range_sel = this->_rangeSelectivity(index, fields, comps, values);
+    double rows = n * range_sel;
+    double leaves = ceil(rows * ( index->getField().size + sizeof(RecordId) )
+        / PAGE_SIZE);
+    double cost = index->getHeight() + leaves + rows + 
+      rows * CPU_RECORD_COST;
+    if( cost < best.cost ){
+      best.path = RangeIndexP;
+      best.index_ids.clear();
+      best.ordered_index = index;
+      best.cost = cost;
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief Returns a one line description of a plan, for example
+ *    "IndexScan(index 7) rows=4 cost=5.2 (file scan 412.0)".
+ */
+std::string SelectPlanner::describe(const SelectPlan &plan) {
+  std::string desc;
+  switch(plan.path) {
+    case FileScanP: desc = "FileScan"; break;
+    case IndexScanP: desc = "IndexScan(index"; break;
+    case MultiIndexP: desc = "MultiIndexScan(indexes"; break;
+    case RangeIndexP: desc = "RangeIndexScan(field " + 
+      std::to_string(plan.ordered_index->getFieldId()) + ")"; break;
+  }
+  if( plan.path == IndexScanP || plan.path == MultiIndexP ){
+    for( FileId index_id : plan.index_ids ){
+      desc += " " + std::to_string(index_id);
+    }
+    desc += ")";
+  }
+  char numbers[96];
+  snprintf(numbers, sizeof(numbers), " rows=%.0f cost=%.1f (file scan %.1f)",
+      plan.est_rows, plan.cost, plan.file_scan_cost);
+  return desc + numbers;
+}
+
+/**
+ * @brief Estimates the fraction of records that pass one conjunct, from
+ *    the relation's statistics if it has been analyzed, and with fixed
+ *    estimates for equality, range and other comparisons otherwise.
+ */
+double SelectPlanner::_selectivity(FieldId fid, Comp comp, void *value) {
+  if( this->stats != nullptr && this->stats->getNumRecs() > 0 ){
+    return this->stats->estimateSelectivity(fid, comp, value);
+  }
+  switch(comp) {
+    case EQUAL: return EQUAL_SELECTIVITY;
+    case LESS: case LESS_EQUAL: case GREATER: case GREATER_EQUAL:
+      return RANGE_SELECTIVITY;
+    default: return OTHER_SELECTIVITY;
+  }
+}
+
+/**
+ * @brief Estimates the fraction of records in the range an ordered index
+ *    scans. The bounds on the index field are folded into one interval the
+ *    way RangeIndexScan folds them, since two bounds on one field are not
+ *    independent: with statistics the estimate is the fraction below the
+ *    upper bound less the fraction below the lower one, and without them
+ *    the fixed range estimate is used for the interval as a whole.
+ */
+double SelectPlanner::_rangeSelectivity(BTreeIndex *index,
+    const std::vector<FieldId> &fields, const std::vector<Comp> &comps,
+    const std::vector<void *> &values) {
+
+  const FieldLayout &field = index->getField();
+  void *lower = nullptr;
+  bool lower_inclusive = true;
+  void *upper = nullptr;
+  bool upper_inclusive = true;
+  for( size_t i = 0; i < fields.size(); i++ ){
+    if( fields[i] != field.fid ) continue;
+    bool is_lower = comps[i] == EQUAL || comps[i] == GREATER ||
+      comps[i] == GREATER_EQUAL;
+    bool is_upper = comps[i] == EQUAL || comps[i] == LESS ||
+      comps[i] == LESS_EQUAL;
+    bool inclusive = comps[i] != GREATER && comps[i] != LESS;
+    if( is_lower ){
+      int cmp = lower == nullptr ? 1 : RecordLayout::compareFieldValues(
+          field, (const char *)values[i], (const char *)lower);
+      if( cmp > 0 || ( cmp == 0 && !inclusive ) ){
+        lower = values[i];
+        lower_inclusive = inclusive;
+      }
+    }
+    if( is_upper ){
+      int cmp = upper == nullptr ? -1 : RecordLayout::compareFieldValues(
+          field, (const char *)values[i], (const char *)upper);
+      if( cmp < 0 || ( cmp == 0 && !inclusive ) ){
+        upper = values[i];
+        upper_inclusive = inclusive;
+      }
+    }
+  }
+
+  if( lower != nullptr && upper != nullptr ){
+    int cmp = RecordLayout::compareFieldValues(field, (const char *)lower,
+        (const char *)upper);
+    if( cmp > 0 || ( cmp == 0 && !( lower_inclusive && upper_inclusive ) ) ){
+      return 0;
+    }
+    if( cmp == 0 ){
+      return this->_selectivity(field.fid, EQUAL, lower);
+    }
+  }
+  if( this->stats == nullptr || this->stats->getNumRecs() == 0 ){
+    return RANGE_SELECTIVITY;
+  }
+  double below_upper = upper == nullptr ? 1 :
+    this->stats->estimateSelectivity(field.fid,
+        upper_inclusive ? LESS_EQUAL : LESS, upper);
+  double below_lower = lower == nullptr ? 0 :
+    1 - this->stats->estimateSelectivity(field.fid,
+        lower_inclusive ? GREATER_EQUAL : GREATER, lower);
+  return below_upper > below_lower ? below_upper - below_lower : 0;
+}
+
+/**
+ * @brief Estimates the number of distinct pages holding rows records spread
+ *    evenly over the relation (Cardenas' formula).
+ */
+double SelectPlanner::_pagesTouched(double rows) {
+  double pages = this->num_pages;
+  return pages * ( 1 - pow(1 - 1 / pages, rows) );
+}
+
+/**
+ * @brief Returns true if every key field of a hash index has an EQUAL
+ *    conjunct not already marked in is_key, marking the conjuncts used.
+ *    is_key is only changed if the index is covered.
+ */
+bool SelectPlanner::_covers(FileId index_id,
+    const std::vector<FieldId> &fields, const std::vector<Comp> &comps,
+    std::vector<bool> &is_key) {
+
+  HashIndexFile *index_file = (HashIndexFile *)this->catalog->getFile(
+      index_id);
+  std::vector<bool> marked = is_key;
+  for( FieldId key_fid : index_file->getKeyFormat()->getFieldList() ){
+    size_t i = 0;
+    while( i < fields.size() && 
+        ( marked[i] || fields[i] != key_fid || comps[i] != EQUAL ) ){
+      i++;
+    }
+    if( i == fields.size() ) return false;
+    marked[i] = true;
+  }
+  is_key = marked;
+  return true;
+}
@@ -0,0 +1,173 @@
+#ifndef _SWATDB_SELECTPLANNER_H_
+#define _SWATDB_SELECTPLANNER_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include "swatdb_types.h"
+
+class Catalog;
+class BTreeIndex;
+class TableStats;
+
+/**
+ * Access paths an automatic select can choose from
+ */
+enum SelectPath {FileScanP, IndexScanP, MultiIndexP, RangeIndexP};
+
+/**
+ * Struct describing the access path chosen for a select and what it was
+ * expected to cost.
+ */
+struct SelectPlan {
+  /**
+   * Access path used
+   */
+  SelectPath path;
+  /**
+   * Hash indexes probed, for IndexScanP (one) and MultiIndexP (several)
+   */
+  std::vector<FileId> index_ids;
+  /**
+   * Ordered index scanned, for RangeIndexP
+   */
+  BTreeIndex *ordered_index;
+  /**
+   * Estimated number of records in the result
+   */
+  double est_rows;
+  /**
+   * Estimated cost of the path, in units of one page read
+   */
+  double cost;
+  /**
+   * Estimated cost of a plain file scan, for comparison
+   */
+  double file_scan_cost;
+};
+
+/**
+ * SelectPlanner chooses the access path of a select with a simple I/O + CPU
+ * cost model. It is given the relation's size and the indexes that could
+ * be used, estimates the selectivity of each conjunct, and compares a file
+ * scan with a scan of each usable hash index, an intersection of all the
+ * usable hash indexes, and a range scan of each usable ordered index.
+ */
+class SelectPlanner {
+
+  public:
+
+    /**
+     * @brief Constructor for SelectPlanner.
+     *
+     * @param catalog. Catalog * for SwatDB.
+     * @param rel_id. FileId of the relation selected on.
+     * @param num_recs. Number of records in the relation.
+     * @param num_pages. Number of pages in the relation.
+     */
+    SelectPlanner(Catalog *catalog, FileId rel_id, std::uint64_t num_recs,
+        std::uint64_t num_pages);
+
+    /**
+     * @brief Destructor for SelectPlanner.
+     */
+    ~SelectPlanner();
+
+    /**
+     * @brief Adds a hash index that may be used. Indexes that do not exist
+     *    or are not on the relation are ignored.
+     *
+     * @param index_id. FileId of the hash index.
+     */
+    void addHashIndex(FileId index_id);
+
+    /**
+     * @brief Adds an ordered index on the relation that may be used.
+     *
+     * @param index. BTreeIndex * on one field of the relation.
+     */
+    void addOrderedIndex(BTreeIndex *index);
+
+    /**
+     * @brief Sets the statistics used to estimate selectivities. Without
+     *    them fixed estimates are used.
+     *
+     * @param stats. TableStats * of the relation, nullptr for none.
+     */
+    void setTableStats(TableStats *stats);
+
+    /**
+     * @brief Chooses the cheapest access path for a select.
+     *
+     * @param fields. Vector of field ids for the select operation.
+     * @param comps. Vector of Comps for the select operation.
+     * @param values. Vector of Void * for the select operation.
+     *
+     * @return SelectPlan of the chosen path.
+     */
+    SelectPlan plan(std::vector<FieldId> fields, std::vector<Comp> comps,
+        std::vector<void *> values);
+
+    /**
+     * @brief Returns a one line description of a plan, for example
+     *    "IndexScan(index 7) rows=4 cost=5.2 (file scan 412.0)".
+     */
+    static std::string describe(const SelectPlan &plan);
+
+  private:
+
+    /**
+     * @brief Estimates the fraction of records that pass one conjunct.
+     */
+    double _selectivity(FieldId fid, Comp comp, void *value);
+
+    /**
+     * @brief Estimates the fraction of records in the range an ordered
+     *    index scans, from the bounds on its field folded into one interval.
+     */
+    double _rangeSelectivity(BTreeIndex *index,
+        const std::vector<FieldId> &fields, const std::vector<Comp> &comps,
+        const std::vector<void *> &values);
+
+    /**
+     * @brief Estimates the number of distinct pages holding rows records
+     *    spread over the relation.
+     */
+    double _pagesTouched(double rows);
+
+    /**
+     * @brief Returns true if every key field of a hash index has an unused
+     *    EQUAL conjunct, marking the conjuncts used in is_key.
+     */
+    bool _covers(FileId index_id, const std::vector<FieldId> &fields,
+        const std::vector<Comp> &comps, std::vector<bool> &is_key);
+
+    /**
+     * Catalog and relation planned for
+     */
+    Catalog *catalog;
+    FileId rel_id;
+
+    /**
+     * Size of the relation
+     */
+    std::uint64_t num_recs;
+    std::uint64_t num_pages;
+
+    /**
+     * Indexes that may be used
+     */
+    std::vector<FileId> hash_indexes;
+    std::vector<BTreeIndex *> ordered_indexes;
+
+    /**
+     * Statistics of the relation, nullptr if it was never analyzed
+     */
+    TableStats *stats;
+
+};
+
+#endif
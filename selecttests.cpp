@@ -32,6 +32,21 @@
 #include "operation.h"
 #include "select.h"
 #include "filescan.h"
+#include "vectorfilescan.h"
+#include "parallelfilescan.h"
+#include "zonemap.h"
+#include "paxfile.h"
+#include "selectcursor.h"
+#include "btreeindex.h"
+#include "rangeindexscan.h"
+#include "inlistscan.h"
+#include "multiindexscan.h"
+#include "selectplanner.h"
+#include "tablestats.h"
+#include "pageprefetcher.h"
+#include "indexonlyscan.h"
+#include "preparedselect.h"
+#include "recordlayout.h"
 #include "join.h"
 #include "blockNLJ.h"
 #include "indexNLJ.h"
@@ -302,6 +317,357 @@ SUITE(FileScanMultiField) {
     CHECK_EQUAL(result->getNumRecords(), 2);
   }
 
+  /**
+   * A file scan select-project narrows matches in the scan loop, and must
+   * give the same records as a select followed by a project
+   */
+  TEST_FIXTURE(TestFixture, fusedProject) {
+
+    float gpa = 2.3;
+    std::vector<FieldId> fields = {4};
+    std::vector<Comp> comps = {LESS_EQUAL};
+    std::vector<void *> values = {&gpa};
+    std::vector<FieldId> proj_fields = {4, 0};
+
+    RelOpsManager *relops = this->swatdb->getRelOpsMgr();
+    HeapFile *result = relops->selectProject(FileScanT, undergrads_file_id,
+        fields, comps, values, proj_fields);
+    HeapFile *selected = relops->select(FileScanT, undergrads_file_id,
+        fields, comps, values);
+    HeapFile *expected = relops->project(selected->getFileId(), proj_fields);
+
+    CHECK(result->getNumRecords() > 0);
+    CHECK_EQUAL(result->getNumRecords(), expected->getNumRecords());
+    CHECK(relops->checkFilesEqual(expected->getFileId(),
+          result->getFileId()));
+  }
+
+  /**
+   * A file scan given the buffer manager reads records in place on pinned
+   * pages, and must match the same scan done with a HeapFileScanner
+   */
+  TEST_FIXTURE(TestFixture, pinnedPages) {
+
+    float gpa = 2.3;
+    std::vector<FieldId> fields = {4};
+    std::vector<Comp> comps = {LESS_EQUAL};
+    std::vector<void *> values = {&gpa};
+
+    RelOpsManager *relops = this->swatdb->getRelOpsMgr();
+    Schema *schema = this->swatdb->getCatalog()->getSchema(undergrads_file_id);
+    FileId pinned_id = relops->_createResultFile(schema);
+    FileId scanned_id = relops->_createResultFile(schema);
+
+    FileScan *pinned = new FileScan(undergrads_file_id, pinned_id, fields,
+        comps, values, this->swatdb->getCatalog());
+    pinned->setBufferManager(this->swatdb->getBufMgr());
+    pinned->runOperation();
+    FileScan *scanned = new FileScan(undergrads_file_id, scanned_id, fields,
+        comps, values, this->swatdb->getCatalog());
+    scanned->runOperation();
+
+    CHECK(pinned->getNumMatches() > 0);
+    CHECK_EQUAL(pinned->getNumMatches(), scanned->getNumMatches());
+    CHECK(relops->checkFilesEqual(pinned_id, scanned_id));
+    delete pinned;
+    delete scanned;
+  }
+
+}
+
+/**
+ * Tests that select operators reorder their conjuncts by observed
+ * selectivity while they run
+ */
+SUITE(ConjunctReordering) {
+
+  /**
+   * The first conjunct passes most records and the second very few, so the
+   * file scan should move the second one to the front
+   */
+  TEST_FIXTURE(TestFixture, selectiveLast) {
+
+    float gpa = 3.5;
+    char stud_name[6] = {'H','e','n','r','y','\0'};
+    std::vector<FieldId> fields = {4, 1}; 
+    std::vector<Comp> comps = {LESS_EQUAL, EQUAL};
+    std::vector<void *> values = {&gpa, &stud_name};
+
+    FileId res_id = this->swatdb->getRelOpsMgr()->_createResultFile(
+        this->swatdb->getCatalog()->getSchema(undergrads_file_id));
+    FileScan *fscan = new FileScan(undergrads_file_id, res_id, fields, comps,
+        values, this->swatdb->getCatalog());
+    fscan->runOperation();
+
+    std::vector<std::uint32_t> order = fscan->getConjunctOrder();
+    const std::vector<ConjunctStats> &stats = fscan->getConjunctStats();
+    std::cout << "Conjunct Reordering Test - order after scan: " 
+      << order[0] << ", " << order[1] << std::endl;
+    CHECK_EQUAL(order.size(), 2);
+    CHECK_EQUAL(order[0], 1);
+    CHECK(stats[1].evals > stats[0].evals);
+    CHECK_EQUAL(((HeapFile *)this->swatdb->getCatalog()->getFile(res_id))
+        ->getNumRecords(), 2);
+    delete fscan;
+  }
+
+}
+
+/**
+ * Tests the vectorized file scan against the same queries as FileScanT
+ */
+SUITE(VectorFileScan) {
+
+  /**
+   * Vectorized Select Test on one int field, equal operator
+   */
+  TEST_FIXTURE(TestFixture, inttest){
+
+    int cs_dept_id = 2;
+    std::vector<FieldId> fields = {3};
+    std::vector<Comp> comps = {EQUAL};
+    std::vector<void *> values = {&cs_dept_id};
+
+    HeapFile *result = this->swatdb->getRelOpsMgr()->select(VectorFileScanT, 
+                        profs_file_id, fields, comps,values);
+    std::cout << 
+      "Vector Scan Int Select Test - SELECT * FROM professors WHERE"
+      << " dept_id = 2" << std::endl;
+    this->swatdb->getFileMgr()->printFile(result->getFileId());
+    CHECK_EQUAL(result->getNumRecords(), 3);
+  }
+
+  /**
+   * Vectorized Select Test on one float field, not equal operator, checked
+   * against the tuple at a time file scan
+   */
+  TEST_FIXTURE(TestFixture, notequaltest){
+
+    float gpa = 2.3;
+    std::vector<FieldId> fields = {4};
+    std::vector<Comp> comps = {NOTEQUAL};
+    std::vector<void *> values = {&gpa};
+
+    HeapFile *expected = this->swatdb->getRelOpsMgr()->select(FileScanT, 
+                        undergrads_file_id, fields, comps,values);
+    HeapFile *result = this->swatdb->getRelOpsMgr()->select(VectorFileScanT, 
+                        undergrads_file_id, fields, comps,values);
+    std::cout << 
+      "Vector Scan Not Equal Select Test - SELECT * FROM undergrads"
+      << " WHERE gpa != 2.3" << std::endl;
+    CHECK(this->swatdb->getRelOpsMgr()->checkFilesEqual(
+          expected->getFileId(), result->getFileId()));
+  }
+
+  /**
+   * Vectorized Select Test on one float field using range comparison
+   */
+  TEST_FIXTURE(TestFixture, floattest){
+
+    float gpa = 2.3;
+    std::vector<FieldId> fields = {4};
+    std::vector<Comp> comps = {LESS_EQUAL};
+    std::vector<void *> values = {&gpa};
+
+    HeapFile *result = this->swatdb->getRelOpsMgr()->select(VectorFileScanT, 
+                        undergrads_file_id, fields, comps,values);
+    std::cout << 
+      "Vector Scan Float Range Select Test - SELECT * FROM undergrads"
+      << " WHERE gpa <= 2.3" << std::endl;
+    CHECK_EQUAL(result->getNumRecords(), 6000);
+  }
+
+  /**
+   * Vectorized Select Test on a string and a float field, checked against
+   * the result of the tuple at a time file scan
+   */
+  TEST_FIXTURE(TestFixture, multifield) {
+    
+    float gpa = 3.5;
+    char stud_name[6] = {'H','e','n','r','y','\0'};
+    std::vector<FieldId> fields = {4, 1}; 
+    std::vector<Comp> comps = {LESS_EQUAL, EQUAL};
+    std::vector<void *> values = {&gpa, &stud_name};
+
+    HeapFile *expected = this->swatdb->getRelOpsMgr()->select(FileScanT, 
+                        undergrads_file_id, fields, comps,values);
+    HeapFile *result = this->swatdb->getRelOpsMgr()->select(VectorFileScanT, 
+                        undergrads_file_id, fields, comps,values);
+
+    std::cout << 
+      "Vector Scan Multi Field Select Test - SELECT * FROM undergrads"
+      << " WHERE gpa <= 3.5 and name = Henry" << std::endl;
+    this->swatdb->getFileMgr()->printFile(result->getFileId());
+    CHECK_EQUAL(result->getNumRecords(), 2);
+    CHECK(this->swatdb->getRelOpsMgr()->checkFilesEqual(
+          expected->getFileId(), result->getFileId()));
+  }
+
+  /**
+   * Vectorized Select Test over the columnar copy of the relation, run
+   * directly on a VectorFileScan so the columnar pages it read can be
+   * checked, and checked against the tuple at a time file scan
+   */
+  TEST_FIXTURE(TestFixture, paxScan) {
+
+    float gpa = 3.5;
+    char stud_name[6] = {'H','e','n','r','y','\0'};
+    std::vector<FieldId> fields = {4, 1}; 
+    std::vector<Comp> comps = {LESS_EQUAL, EQUAL};
+    std::vector<void *> values = {&gpa, &stud_name};
+
+    this->swatdb->getRelOpsMgr()->buildPaxFile(undergrads_file_id);
+    PaxFile *pax_file = this->swatdb->getRelOpsMgr()->getPaxFile(
+        undergrads_file_id);
+    CHECK(pax_file != nullptr);
+
+    HeapFile *expected = this->swatdb->getRelOpsMgr()->select(FileScanT, 
+                        undergrads_file_id, fields, comps,values);
+    FileId res_id = this->swatdb->getRelOpsMgr()->_createResultFile(
+        this->swatdb->getCatalog()->getSchema(undergrads_file_id));
+    VectorFileScan *vscan = new VectorFileScan(undergrads_file_id, res_id,
+        fields, comps, values, this->swatdb->getCatalog());
+    vscan->setPaxFile(pax_file);
+    vscan->runOperation();
+
+    std::cout << "Vector Scan PAX Select Test - columnar pages read: "
+      << vscan->getNumColumnPages() << std::endl;
+    CHECK_EQUAL(vscan->getNumColumnPages(), pax_file->getNumPages());
+    CHECK(this->swatdb->getRelOpsMgr()->checkFilesEqual(
+          expected->getFileId(), res_id));
+    delete vscan;
+  }
+
+  /**
+   * Select with columnar results on: the result gets a columnar copy that
+   * a vectorized select on the result then scans
+   */
+  TEST_FIXTURE(TestFixture, columnarResults) {
+
+    float gpa = 2.3;
+    float low_gpa = 1.5;
+    std::vector<FieldId> fields = {4};
+    std::vector<Comp> comps = {LESS_EQUAL};
+    std::vector<void *> values = {&gpa};
+
+    this->swatdb->getRelOpsMgr()->setColumnarResults(true);
+    HeapFile *result = this->swatdb->getRelOpsMgr()->select(FileScanT, 
+                        undergrads_file_id, fields, comps,values);
+    // the copy is saved and dropped from memory, then loaded on demand
+    CHECK_EQUAL(this->swatdb->getRelOpsMgr()->pax_files.count(
+          result->getFileId()), 0);
+    PaxFile *pax_file = this->swatdb->getRelOpsMgr()->getPaxFile(
+        result->getFileId());
+    CHECK(pax_file != nullptr);
+    CHECK_EQUAL(pax_file->getNumRecs(), 6000);
+
+    this->swatdb->getRelOpsMgr()->setColumnarResults(false);
+    std::vector<Comp> low_comps = {GREATER_EQUAL};
+    std::vector<void *> low_values = {&low_gpa};
+    HeapFile *expected = this->swatdb->getRelOpsMgr()->select(FileScanT, 
+        result->getFileId(), fields, low_comps, low_values);
+    HeapFile *pax_result = this->swatdb->getRelOpsMgr()->select(
+        VectorFileScanT, result->getFileId(), fields, low_comps, low_values);
+    std::cout << "Vector Scan Columnar Result Test - SELECT * FROM (SELECT"
+      << " * FROM undergrads WHERE gpa <= 2.3) WHERE gpa >= 1.5: "
+      << pax_result->getNumRecords() << std::endl;
+    CHECK(this->swatdb->getRelOpsMgr()->checkFilesEqual(
+          expected->getFileId(), pax_result->getFileId()));
+  }
+
+  /**
+   * Vector Select Test on a relation with a columnar copy that is then
+   * modified: an insert is appended to the copy, a delete drops it
+   */
+  TEST_FIXTURE(TestFixture, modifiedRelation){
+
+    float gpa = 2.3;
+    std::vector<FieldId> fields = {4};
+    std::vector<Comp> comps = {LESS_EQUAL};
+    std::vector<void *> values = {&gpa};
+
+    RelOpsManager *relops = this->swatdb->getRelOpsMgr();
+    HeapFile *copy = relops->select(FileScanT, undergrads_file_id, fields,
+        comps, values);
+    FileId copy_id = copy->getFileId();
+    relops->buildPaxFile(copy_id);
+
+    Record *rec = new Record(this->swatdb->getCatalog()->getSchema(copy_id));
+    HeapFileScanner *scanner = new HeapFileScanner(copy);
+    RecordId rid = scanner->getNext(rec);
+    delete scanner;
+    CHECK(rid != INVALID_RECORD_ID);
+
+    RecordId new_rid = relops->insertRecord(copy_id, *rec);
+    PaxFile *pax_file = relops->getPaxFile(copy_id);
+    CHECK(pax_file != nullptr);
+    CHECK_EQUAL(pax_file->getNumRecs(), 6001);
+    HeapFile *result = relops->select(VectorFileScanT, copy_id, fields,
+        comps, values);
+    std::cout << "Vector Scan Modified Relation Test - after insert: "
+      << result->getNumRecords() << std::endl;
+    CHECK_EQUAL(result->getNumRecords(), 6001);
+
+    relops->deleteRecord(copy_id, new_rid);
+    CHECK(relops->getPaxFile(copy_id) == nullptr);
+    result = relops->select(VectorFileScanT, copy_id, fields, comps, values);
+    std::cout << "Vector Scan Modified Relation Test - after delete: "
+      << result->getNumRecords() << std::endl;
+    CHECK_EQUAL(result->getNumRecords(), 6000);
+    delete rec;
+  }
+
+}
+
+/**
+ * Tests the parallel file scan against the same queries as FileScanT
+ */
+SUITE(ParallelFileScan) {
+
+  /**
+   * Parallel Select Test on one float field using range comparison
+   */
+  TEST_FIXTURE(TestFixture, floattest){
+
+    float gpa = 2.3;
+    std::vector<FieldId> fields = {4};
+    std::vector<Comp> comps = {LESS_EQUAL};
+    std::vector<void *> values = {&gpa};
+
+    HeapFile *result = this->swatdb->getRelOpsMgr()->select(
+        ParallelFileScanT, undergrads_file_id, fields, comps, values,
+        INVALID_FILE_ID, 4);
+    std::cout << 
+      "Parallel Scan Float Range Select Test - SELECT * FROM undergrads"
+      << " WHERE gpa <= 2.3" << std::endl;
+    CHECK_EQUAL(result->getNumRecords(), 6000);
+  }
+
+  /**
+   * Parallel Select Test with more threads than pages, checked against the
+   * result of the tuple at a time file scan
+   */
+  TEST_FIXTURE(TestFixture, manythreads) {
+
+    int cs_dept_id = 3;
+    std::vector<FieldId> fields = {3};
+    std::vector<Comp> comps = {GREATER_EQUAL};
+    std::vector<void *> values = {&cs_dept_id};
+
+    HeapFile *expected = this->swatdb->getRelOpsMgr()->select(FileScanT, 
+        profs_file_id, fields, comps, values);
+    HeapFile *result = this->swatdb->getRelOpsMgr()->select(
+        ParallelFileScanT, profs_file_id, fields, comps, values,
+        INVALID_FILE_ID, 16);
+    std::cout << 
+      "Parallel Scan Int Range Select Test - SELECT * FROM professors"
+      << " WHERE dept_id >= 3" << std::endl;
+    this->swatdb->getFileMgr()->printFile(result->getFileId());
+    CHECK_EQUAL(result->getNumRecords(), 6);
+    CHECK(this->swatdb->getRelOpsMgr()->checkFilesEqual(
+          expected->getFileId(), result->getFileId()));
+  }
+
 }
 
 /**
@@ -378,6 +744,1047 @@ SUITE(IndexSelectTests) {
     CHECK_EQUAL(result->getNumRecords(), 3);
   }
 
+  /**
+   * Runs the string select with a RecordId batch size of 1, so the index
+   * has more matches than one batch and the scan uses a bitmap heap scan
+   */
+  TEST_FIXTURE(TestFixture, bitmapIndexSelect){
+
+    char name[5] = {'J','a','c','k','\0'};
+    std::vector<FieldId> fields = {1};
+    std::vector<Comp> comps = {EQUAL};
+    std::vector<void *> values = {name};
+
+    FileId ind_id = this->swatdb->getCatalog()->getFileId(
+        this->name_index_file_name);
+    FileId res_id = this->swatdb->getRelOpsMgr()->_createResultFile(
+        this->swatdb->getCatalog()->getSchema(undergrads_file_id));
+    IndexScan *iscan = new IndexScan(undergrads_file_id, ind_id, res_id,
+        fields, comps, values, this->swatdb->getCatalog());
+    iscan->setRidBatchSize(1);
+    iscan->runOperation();
+
+    CHECK(iscan->isBitmapScan());
+    CHECK_EQUAL(iscan->getNumMatches(), 3);
+    CHECK_EQUAL(((HeapFile *)this->swatdb->getCatalog()->getFile(
+            res_id))->getNumRecords(), 3);
+    delete iscan;
+  }
+
+  /**
+   * Pulls the matches of the same select one at a time with a batch size
+   * of 0 (taken as 1). The index is read a batch at a time instead of being
+   * drained into a bitmap, and every match is still found.
+   */
+  TEST_FIXTURE(TestFixture, pulledIndexSelect){
+
+    char name[5] = {'J','a','c','k','\0'};
+    std::vector<FieldId> fields = {1};
+    std::vector<Comp> comps = {EQUAL};
+    std::vector<void *> values = {name};
+
+    FileId ind_id = this->swatdb->getCatalog()->getFileId(
+        this->name_index_file_name);
+    IndexScan *iscan = new IndexScan(undergrads_file_id, ind_id,
+        INVALID_FILE_ID, fields, comps, values, this->swatdb->getCatalog());
+    iscan->setRidBatchSize(0);
+    iscan->open();
+    std::uint64_t matches = 0;
+    while( iscan->getNextMatch() != INVALID_RECORD_ID ){
+      CHECK(!iscan->isBitmapScan());
+      matches++;
+    }
+    iscan->close();
+    CHECK_EQUAL(matches, 3);
+    delete iscan;
+  }
+
+  /**
+   * Selects with the index key conjuncts out of order plus a residual
+   * conjunct. Only the residual conjunct is checked on the fetched records.
+   */
+  TEST_FIXTURE(TestFixture, residualIndexSelect){
+
+    float gpa = 4.0;
+    int major_id = 3;
+    std::vector<FieldId> fields = {4, 3, 3};
+    std::vector<Comp> comps = {EQUAL, EQUAL, GREATER_EQUAL};
+    std::vector<void *> values = {&gpa, &major_id, &major_id};
+
+    FileId ind_id = this->swatdb->getCatalog()->getFileId(
+                        this->gpa_index_file_name);
+    FileId res_id = this->swatdb->getRelOpsMgr()->_createResultFile(
+        this->swatdb->getCatalog()->getSchema(phds_file_id));
+    IndexScan *iscan = new IndexScan(phds_file_id, ind_id, res_id,
+        fields, comps, values, this->swatdb->getCatalog());
+    iscan->runOperation();
+
+    CHECK_EQUAL(iscan->getNumMatches(), 4);
+    CHECK_EQUAL(iscan->getConjunctStats()[0].evals, 0);
+    CHECK_EQUAL(iscan->getConjunctStats()[1].evals, 0);
+    CHECK_EQUAL(iscan->getConjunctStats()[2].evals, 4);
+    delete iscan;
+  }
+
+  /**
+   * Index select that prefetches its heap pages. Each page fetched from is
+   * counted once, as a hit or a miss, and every page read is released.
+   */
+  TEST_FIXTURE(TestFixture, prefetchIndexSelect){
+
+    char name[5] = {'J','a','c','k','\0'};
+    std::vector<FieldId> fields = {1};
+    std::vector<Comp> comps = {EQUAL};
+    std::vector<void *> values = {name};
+
+    FileId ind_id = this->swatdb->getCatalog()->getFileId(
+        this->name_index_file_name);
+    FileId res_id = this->swatdb->getRelOpsMgr()->_createResultFile(
+        this->swatdb->getCatalog()->getSchema(undergrads_file_id));
+    PagePrefetcher *prefetcher = new PagePrefetcher(
+        this->swatdb->getBufMgr());
+    IndexScan *iscan = new IndexScan(undergrads_file_id, ind_id, res_id,
+        fields, comps, values, this->swatdb->getCatalog());
+    iscan->setPrefetcher(prefetcher, 8);
+    iscan->runOperation();
+
+    std::cout << "Prefetch Index Select Test - hits: " 
+      << iscan->getNumPrefetchHits() << " misses: " 
+      << iscan->getNumPrefetchMisses() << std::endl;
+    CHECK_EQUAL(iscan->getNumMatches(), 3);
+    std::uint64_t pages_read = iscan->getNumPrefetchHits() + 
+      iscan->getNumPrefetchMisses();
+    CHECK(pages_read >= 1 && pages_read <= 3);
+    CHECK_EQUAL(prefetcher->getNumIssued(), pages_read);
+    delete iscan;
+    delete prefetcher;
+
+    // through the RelOpsManager, with the shared prefetcher
+    HeapFile *result = this->swatdb->getRelOpsMgr()->select(IndexT,
+        undergrads_file_id, fields, comps, values, ind_id, 8);
+    CHECK_EQUAL(result->getNumRecords(), 3);
+    CHECK(this->swatdb->getRelOpsMgr()->getPrefetcher() != nullptr);
+    CHECK(this->swatdb->getRelOpsMgr()->getPrefetcher()->getNumIssued() > 0);
+  }
+
+  /**
+   * Select and project on the index key only, answered from the index
+   */
+  TEST_FIXTURE(TestFixture, indexOnlySelect){
+
+    char name[5] = {'J','a','c','k','\0'};
+    std::vector<FieldId> fields = {1};
+    std::vector<Comp> comps = {EQUAL};
+    std::vector<void *> values = {name};
+    std::vector<FieldId> proj_fields = {1};
+
+    FileId ind_id = this->swatdb->getCatalog()->getFileId(
+        this->name_index_file_name);
+    HashIndexFile *index_file = 
+      (HashIndexFile *)this->swatdb->getCatalog()->getFile(ind_id);
+    CHECK(IndexOnlyScan::isCovered(index_file, fields, comps, proj_fields));
+    CHECK(!IndexOnlyScan::isCovered(index_file, fields, comps, {1, 4}));
+
+    HeapFile *result = this->swatdb->getRelOpsMgr()->selectProject(IndexT,
+        undergrads_file_id, fields, comps, values, proj_fields, ind_id);
+    CHECK_EQUAL(result->getNumRecords(), 3);
+    Record *rec = new Record(
+        this->swatdb->getCatalog()->getSchema(result->getFileId()));
+    HeapFileScanner *scanner = new HeapFileScanner(result);
+    while( scanner->getNext(rec) != INVALID_RECORD_ID ){
+      CHECK(rec->compareFieldToValue(0, name, EQUAL));
+    }
+    delete scanner;
+    delete rec;
+
+    // a projection the index does not cover reads the relation
+    result = this->swatdb->getRelOpsMgr()->selectProject(IndexT,
+        undergrads_file_id, fields, comps, values, {1, 4}, ind_id);
+    CHECK_EQUAL(result->getNumRecords(), 3);
+
+    // a conjunct on the key that the probe values fail matches nothing
+    FileId res_id = this->swatdb->getRelOpsMgr()->_createProjectRes(
+        this->swatdb->getCatalog()->getSchema(undergrads_file_id),
+        proj_fields);
+    IndexOnlyScan *oscan = new IndexOnlyScan(undergrads_file_id, ind_id,
+        res_id, {1, 1}, {EQUAL, GREATER}, {name, name}, proj_fields,
+        this->swatdb->getCatalog());
+    oscan->runOperation();
+    CHECK_EQUAL(oscan->getNumMatches(), 0);
+    delete oscan;
+  }
+
+}
+
+/**
+ * Tests file scan selects on relations with a zone map
+ */
+SUITE(ZoneMapTests) {
+
+  /**
+   * Int range select using the zone map, must match the plain file scan
+   */
+  TEST_FIXTURE(TestFixture, intRange){
+
+    int stud_id = 5;
+    std::vector<FieldId> fields = {0};
+    std::vector<Comp> comps = {LESS_EQUAL};
+    std::vector<void *> values = {&stud_id};
+
+    this->swatdb->getRelOpsMgr()->buildZoneMap(taking_file_id);
+    HeapFile *result = this->swatdb->getRelOpsMgr()->select(FileScanT, 
+                        taking_file_id, fields, comps,values);
+    std::cout << 
+      "Zone Map Int Select Test - SELECT * FROM is_taking WHERE stud_id "
+      " <= 5" << std::endl;
+    this->swatdb->getFileMgr()->printFile(result->getFileId());
+    CHECK_EQUAL(result->getNumRecords(), 20);
+  }
+
+  /**
+   * Float range select run directly on a FileScan over undergrads sorted
+   * by gpa, so pages hold narrow gpa ranges and most of them must be
+   * skipped
+   */
+  TEST_FIXTURE(TestFixture, floatRange){
+
+    float gpa = 2.3;
+    std::vector<FieldId> fields = {4};
+    std::vector<Comp> comps = {LESS_EQUAL};
+    std::vector<void *> values = {&gpa};
+
+    RelOpsManager *relops = this->swatdb->getRelOpsMgr();
+    HeapFile *sorted = relops->sort(undergrads_file_id, {4});
+    Schema *schema = this->swatdb->getCatalog()->getSchema(
+        sorted->getFileId());
+    ZoneMap *zone_map = new ZoneMap(schema);
+    zone_map->build(sorted);
+    FileId res_id = relops->_createResultFile(schema);
+    FileScan *fscan = new FileScan(sorted->getFileId(), res_id, fields,
+        comps, values, this->swatdb->getCatalog());
+    fscan->setBufferManager(this->swatdb->getBufMgr());
+    fscan->setZoneMap(zone_map);
+    fscan->runOperation();
+
+    std::cout << "Zone Map Float Select Test - pages skipped: " 
+      << fscan->getNumPagesSkipped() << " of " 
+      << zone_map->getPages().size() << std::endl;
+    CHECK(fscan->getNumPagesSkipped() > zone_map->getPages().size() / 2);
+    CHECK_EQUAL(fscan->getNumMatches(), 6000);
+    delete fscan;
+    delete zone_map;
+  }
+
+  /**
+   * Updating, deleting and inserting through RelOpsManager keeps the zone
+   * map in step, so a record moved into the selected range on a page the
+   * zone map would have skipped is still found, including after a delete
+   * and an insert that leave the record count unchanged
+   */
+  TEST_FIXTURE(TestFixture, modifiedRelation){
+
+    float gpa = 2.3;
+    float low_gpa = 1.0;
+    std::vector<FieldId> fields = {4};
+    std::vector<Comp> comps = {LESS_EQUAL};
+    std::vector<void *> values = {&gpa};
+
+    RelOpsManager *relops = this->swatdb->getRelOpsMgr();
+    HeapFile *sorted = relops->sort(undergrads_file_id, {4});
+    FileId sorted_id = sorted->getFileId();
+    relops->buildZoneMap(sorted_id);
+
+    // find a record well above the range, on a page the zone map skips
+    Schema *schema = this->swatdb->getCatalog()->getSchema(sorted_id);
+    RecordLayout layout(schema);
+    std::uint32_t gpa_offset = layout.getField(4).offset;
+    Record *rec = new Record(schema);
+    HeapFileScanner *scanner = new HeapFileScanner(sorted);
+    RecordId rid;
+    float rec_gpa = 0;
+    while( ( rid = scanner->getNext(rec) ) != INVALID_RECORD_ID ){
+      memcpy(&rec_gpa, RecordLayout::getBytes(rec) + gpa_offset,
+          sizeof(float));
+      if( rec_gpa > 3.5 ) break;
+    }
+    delete scanner;
+    CHECK(rid != INVALID_RECORD_ID);
+
+    memcpy(RecordLayout::getBytes(rec) + gpa_offset, &low_gpa,
+        sizeof(float));
+    relops->updateRecord(sorted_id, rid, *rec);
+    HeapFile *result = relops->select(FileScanT, sorted_id, fields, comps,
+        values);
+    std::cout << "Zone Map Modified Relation Test - after update: "
+      << result->getNumRecords() << std::endl;
+    CHECK_EQUAL(result->getNumRecords(), 6001);
+
+    relops->deleteRecord(sorted_id, rid);
+    relops->insertRecord(sorted_id, *rec);
+    result = relops->select(FileScanT, sorted_id, fields, comps, values);
+    std::cout << "Zone Map Modified Relation Test - after delete and"
+      << " insert: " << result->getNumRecords() << std::endl;
+    CHECK_EQUAL(result->getNumRecords(), 6001);
+    delete rec;
+  }
+
+}
+
+/**
+ * Tests the count and exists selects, which create no result file
+ */
+SUITE(CountExistsTests) {
+
+  TEST_FIXTURE(TestFixture, fileScanCount){
+
+    int cs_dept_id = 2;
+    std::vector<FieldId> fields = {3};
+    std::vector<Comp> comps = {EQUAL};
+    std::vector<void *> values = {&cs_dept_id};
+
+    std::uint64_t count = this->swatdb->getRelOpsMgr()->selectCount(
+        FileScanT, profs_file_id, fields, comps, values);
+    std::cout << "File Scan Count Test - SELECT COUNT(*) FROM professors"
+      << " WHERE dept_id = 2: " << count << std::endl;
+    CHECK_EQUAL(count, 3);
+  }
+
+  TEST_FIXTURE(TestFixture, fileScanNotEqualCount){
+
+    int cs_dept_id = 2;
+    std::vector<FieldId> fields = {3};
+    std::vector<Comp> comps = {NOTEQUAL};
+    std::vector<void *> values = {&cs_dept_id};
+
+    HeapFile *profs = (HeapFile *)this->swatdb->getCatalog()->getFile(
+        profs_file_id);
+    std::uint64_t count = this->swatdb->getRelOpsMgr()->selectCount(
+        FileScanT, profs_file_id, fields, comps, values);
+    std::cout << "File Scan Not Equal Count Test - SELECT COUNT(*) FROM "
+      << "professors WHERE dept_id != 2: " << count << std::endl;
+    CHECK_EQUAL(count, profs->getNumRecords() - 3);
+  }
+
+  TEST_FIXTURE(TestFixture, indexCount){
+
+    float gpa = 4.0;
+    int major_id = 3;
+    std::vector<FieldId> fields = {3, 4};
+    std::vector<Comp> comps = {EQUAL, EQUAL};
+    std::vector<void *> values = {&major_id, &gpa};
+
+    FileId ind_id = this->swatdb->getCatalog()->getFileId(
+                        this->gpa_index_file_name);
+
+    std::uint64_t count = this->swatdb->getRelOpsMgr()->selectCount(IndexT,
+        phds_file_id, fields, comps, values, ind_id);
+    CHECK_EQUAL(count, 4);
+  }
+
+  TEST_FIXTURE(TestFixture, exists){
+
+    float gpa = 3.9;
+    int no_dept_id = 1000;
+    std::vector<FieldId> fields = {4};
+    std::vector<Comp> comps = {EQUAL};
+    std::vector<void *> values = {&gpa};
+
+    CHECK(this->swatdb->getRelOpsMgr()->selectExists(FileScanT,
+          undergrads_file_id, fields, comps, values));
+
+    fields = {3};
+    values = {&no_dept_id};
+    CHECK(!this->swatdb->getRelOpsMgr()->selectExists(FileScanT,
+          profs_file_id, fields, comps, values));
+  }
+
+}
+
+/**
+ * Tests range selects on ordered (B+-tree) indexes
+ */
+SUITE(RangeIndexTests) {
+
+  /**
+   * Walks a bulk built index from its first entry: every record is in it,
+   * in key order
+   */
+  TEST_FIXTURE(TestFixture, buildOrdered){
+
+    BTreeIndex *index = new BTreeIndex(
+        this->swatdb->getCatalog()->getSchema(undergrads_file_id), 4);
+    index->build((HeapFile *)this->swatdb->getCatalog()->getFile(
+          undergrads_file_id));
+    CHECK_EQUAL(index->getNumRecs(), 50000);
+    CHECK(index->getHeight() > 1);
+
+    std::uint64_t count = 0;
+    float prev = -1;
+    for( BTreePos pos = index->begin(); !index->isEnd(pos); 
+        index->next(pos) ){
+      float gpa;
+      memcpy(&gpa, index->getKey(pos), sizeof(gpa));
+      CHECK(prev <= gpa);
+      prev = gpa;
+      count++;
+    }
+    CHECK_EQUAL(count, 50000);
+
+    // once saved, the same walk reads the nodes back from the file
+    index->save(this->swatdb->getRelOpsMgr()->_orderedIndexPath(
+          undergrads_file_id, 4));
+    CHECK(index->pages.empty());
+    count = 0;
+    prev = -1;
+    for( BTreePos pos = index->begin(); !index->isEnd(pos); 
+        index->next(pos) ){
+      float gpa;
+      memcpy(&gpa, index->getKey(pos), sizeof(gpa));
+      CHECK(prev <= gpa);
+      prev = gpa;
+      count++;
+    }
+    CHECK_EQUAL(count, 50000);
+    delete index;
+  }
+
+  TEST_FIXTURE(TestFixture, floatRange){
+
+    float gpa = 2.3;
+    std::vector<FieldId> fields = {4};
+    std::vector<Comp> comps = {LESS_EQUAL};
+    std::vector<void *> values = {&gpa};
+
+    this->swatdb->getRelOpsMgr()->buildOrderedIndex(undergrads_file_id, 4);
+    HeapFile *result = this->swatdb->getRelOpsMgr()->select(RangeIndexScanT,
+        undergrads_file_id, fields, comps, values);
+    std::cout << "Range Index Scan Float Select Test - SELECT * FROM "
+      << "undergrads WHERE gpa <= 2.3: " << result->getNumRecords()
+      << std::endl;
+    CHECK_EQUAL(result->getNumRecords(), 6000);
+
+    gpa = 3.9;
+    comps = {EQUAL};
+    result = this->swatdb->getRelOpsMgr()->select(RangeIndexScanT,
+        undergrads_file_id, fields, comps, values);
+    CHECK_EQUAL(result->getNumRecords(), 2000);
+  }
+
+  TEST_FIXTURE(TestFixture, intRange){
+
+    int dept_id = 3;
+    std::vector<FieldId> fields = {3};
+    std::vector<Comp> comps = {GREATER_EQUAL};
+    std::vector<void *> values = {&dept_id};
+
+    this->swatdb->getRelOpsMgr()->buildOrderedIndex(profs_file_id, 3);
+    HeapFile *result = this->swatdb->getRelOpsMgr()->select(RangeIndexScanT,
+        profs_file_id, fields, comps, values);
+    this->swatdb->getFileMgr()->printFile(result->getFileId());
+    CHECK_EQUAL(result->getNumRecords(), 6);
+  }
+
+  /**
+   * The name conjunct is a residual checked on the records fetched for the
+   * gpa range
+   */
+  TEST_FIXTURE(TestFixture, residualRange){
+
+    float gpa = 3.5;
+    char name[6] = {'H','e','n','r','y','\0'};
+    std::vector<FieldId> fields = {4, 1};
+    std::vector<Comp> comps = {LESS_EQUAL, EQUAL};
+    std::vector<void *> values = {&gpa, name};
+
+    BTreeIndex *index = new BTreeIndex(
+        this->swatdb->getCatalog()->getSchema(undergrads_file_id), 4);
+    index->build((HeapFile *)this->swatdb->getCatalog()->getFile(
+          undergrads_file_id));
+    FileId res_id = this->swatdb->getRelOpsMgr()->_createResultFile(
+        this->swatdb->getCatalog()->getSchema(undergrads_file_id));
+    RangeIndexScan *rscan = new RangeIndexScan(undergrads_file_id, res_id,
+        fields, comps, values, index, this->swatdb->getCatalog());
+    rscan->runOperation();
+
+    CHECK_EQUAL(rscan->getNumMatches(), 2);
+    CHECK_EQUAL(rscan->getConjunctStats()[0].evals, 0);
+    CHECK_EQUAL(rscan->getConjunctStats()[1].evals,
+        rscan->getNumEntriesRead());
+    delete rscan;
+    delete index;
+  }
+
+  TEST_FIXTURE(TestFixture, noOrderedIndex){
+
+    int stud_id = 5;
+    std::vector<FieldId> fields = {0};
+    std::vector<Comp> comps = {LESS_EQUAL};
+    std::vector<void *> values = {&stud_id};
+
+    CHECK_THROW(this->swatdb->getRelOpsMgr()->select(RangeIndexScanT,
+          taking_file_id, fields, comps, values),
+        MismatchingFieldsRelOpsManager);
+  }
+
+  /**
+   * Updating a record through RelOpsManager drops the relation's ordered
+   * indexes, so the updated value is never missed by a stale index whose
+   * entry count still matches
+   */
+  TEST_FIXTURE(TestFixture, modifiedRelation){
+
+    float gpa = 2.3;
+    float new_gpa = 9.5;
+    float high_gpa = 9.0;
+    std::vector<FieldId> fields = {4};
+    std::vector<Comp> comps = {LESS_EQUAL};
+    std::vector<void *> values = {&gpa};
+
+    RelOpsManager *relops = this->swatdb->getRelOpsMgr();
+    HeapFile *copy = relops->select(FileScanT, undergrads_file_id, fields,
+        comps, values);
+    FileId copy_id = copy->getFileId();
+    relops->buildOrderedIndex(copy_id, 4);
+
+    Schema *schema = this->swatdb->getCatalog()->getSchema(copy_id);
+    RecordLayout layout(schema);
+    Record *rec = new Record(schema);
+    HeapFileScanner *scanner = new HeapFileScanner(copy);
+    RecordId rid = scanner->getNext(rec);
+    delete scanner;
+    memcpy(RecordLayout::getBytes(rec) + layout.getField(4).offset,
+        &new_gpa, sizeof(float));
+    relops->updateRecord(copy_id, rid, *rec);
+    delete rec;
+
+    std::vector<Comp> high_comps = {GREATER_EQUAL};
+    std::vector<void *> high_values = {&high_gpa};
+    CHECK_THROW(relops->select(RangeIndexScanT, copy_id, fields, high_comps,
+          high_values), MismatchingFieldsRelOpsManager);
+    HeapFile *result = relops->selectAuto(copy_id, fields, high_comps,
+        high_values);
+    CHECK(relops->getLastSelectPlan().path != RangeIndexP);
+    CHECK_EQUAL(result->getNumRecords(), 1);
+
+    relops->buildOrderedIndex(copy_id, 4);
+    result = relops->select(RangeIndexScanT, copy_id, fields, high_comps,
+        high_values);
+    std::cout << "Range Index Modified Relation Test - gpa >= 9.0 after"
+      << " rebuild: " << result->getNumRecords() << std::endl;
+    CHECK_EQUAL(result->getNumRecords(), 1);
+  }
+
+}
+
+/**
+ * Tests IN-list selects, with and without a hash index
+ */
+SUITE(InListTests) {
+
+  TEST_FIXTURE(TestFixture, fileScanIn){
+
+    int dept_1 = 2;
+    int dept_2 = 1000;
+    std::vector<void *> in_values = {&dept_1, &dept_2, &dept_1};
+
+    HeapFile *result = this->swatdb->getRelOpsMgr()->selectIn(FileScanT,
+        profs_file_id, 3, in_values);
+    std::cout << "File Scan IN Select Test - SELECT * FROM professors WHERE"
+      << " dept_id IN (2, 1000, 2)" << std::endl;
+    this->swatdb->getFileMgr()->printFile(result->getFileId());
+    CHECK_EQUAL(result->getNumRecords(), 3);
+  }
+
+  /**
+   * A value listed twice is probed once, and its records are in the
+   * result once
+   */
+  TEST_FIXTURE(TestFixture, indexIn){
+
+    char jack[5] = {'J','a','c','k','\0'};
+    char jack_again[5] = {'J','a','c','k','\0'};
+    std::vector<void *> in_values = {jack, jack_again};
+
+    FileId ind_id = this->swatdb->getCatalog()->getFileId(
+        this->name_index_file_name);
+    FileId res_id = this->swatdb->getRelOpsMgr()->_createResultFile(
+        this->swatdb->getCatalog()->getSchema(undergrads_file_id));
+    InListScan *lscan = new InListScan(undergrads_file_id, ind_id, res_id,
+        1, in_values, this->swatdb->getCatalog());
+    lscan->runOperation();
+    CHECK_EQUAL(lscan->getNumProbes(), 1);
+    CHECK_EQUAL(lscan->getNumMatches(), 3);
+    delete lscan;
+  }
+
+  /**
+   * The index and file scan versions of the same IN-list select produce
+   * the same records
+   */
+  TEST_FIXTURE(TestFixture, indexMatchesFileScan){
+
+    char jack[5] = {'J','a','c','k','\0'};
+    char henry[6] = {'H','e','n','r','y','\0'};
+    std::vector<void *> in_values = {jack, henry};
+
+    FileId ind_id = this->swatdb->getCatalog()->getFileId(
+        this->name_index_file_name);
+    HeapFile *index_result = this->swatdb->getRelOpsMgr()->selectIn(IndexT,
+        undergrads_file_id, 1, in_values, ind_id);
+    HeapFile *scan_result = this->swatdb->getRelOpsMgr()->selectIn(
+        FileScanT, undergrads_file_id, 1, in_values);
+    CHECK(index_result->getNumRecords() >= 3);
+    CHECK(this->swatdb->getRelOpsMgr()->checkFilesEqual(
+          index_result->getFileId(), scan_result->getFileId()));
+  }
+
+}
+
+/**
+ * Tests selects that combine the RecordIds of several index probes. The
+ * name index is used once for each name conjunct.
+ */
+SUITE(MultiIndexTests) {
+
+  TEST_FIXTURE(TestFixture, intersect){
+
+    char jack[5] = {'J','a','c','k','\0'};
+    char henry[6] = {'H','e','n','r','y','\0'};
+    std::vector<FieldId> fields = {1, 1};
+    std::vector<Comp> comps = {EQUAL, EQUAL};
+    std::vector<void *> values = {jack, henry};
+
+    FileId ind_id = this->swatdb->getCatalog()->getFileId(
+        this->name_index_file_name);
+    FileId res_id = this->swatdb->getRelOpsMgr()->_createResultFile(
+        this->swatdb->getCatalog()->getSchema(undergrads_file_id));
+    MultiIndexScan *mscan = new MultiIndexScan(undergrads_file_id,
+        {ind_id, ind_id}, res_id, fields, comps, values, RidAndT,
+        this->swatdb->getCatalog());
+    mscan->runOperation();
+    // no record is named both, so nothing is fetched
+    CHECK_EQUAL(mscan->getNumCandidates(), 0);
+    CHECK_EQUAL(mscan->getNumMatches(), 0);
+    delete mscan;
+
+    values = {jack, jack};
+    HeapFile *result = this->swatdb->getRelOpsMgr()->selectMultiIndex(
+        undergrads_file_id, fields, comps, values, {ind_id, ind_id});
+    CHECK_EQUAL(result->getNumRecords(), 3);
+  }
+
+  TEST_FIXTURE(TestFixture, unite){
+
+    char jack[5] = {'J','a','c','k','\0'};
+    char henry[6] = {'H','e','n','r','y','\0'};
+    std::vector<FieldId> fields = {1, 1};
+    std::vector<Comp> comps = {EQUAL, EQUAL};
+    std::vector<void *> values = {jack, henry};
+
+    FileId ind_id = this->swatdb->getCatalog()->getFileId(
+        this->name_index_file_name);
+    HeapFile *result = this->swatdb->getRelOpsMgr()->selectMultiIndex(
+        undergrads_file_id, fields, comps, values, {ind_id, ind_id}, RidOrT);
+    HeapFile *expected = this->swatdb->getRelOpsMgr()->selectIn(FileScanT,
+        undergrads_file_id, 1, values);
+    CHECK(this->swatdb->getRelOpsMgr()->checkFilesEqual(
+          result->getFileId(), expected->getFileId()));
+  }
+
+}
+
+/**
+ * Tests selects that choose their own access path
+ */
+SUITE(AutoSelectTests) {
+
+  /**
+   * With no index the only path is a file scan
+   */
+  TEST_FIXTURE(TestFixture, noIndex){
+
+    float gpa = 2.3;
+    std::vector<FieldId> fields = {4};
+    std::vector<Comp> comps = {LESS_EQUAL};
+    std::vector<void *> values = {&gpa};
+
+    HeapFile *result = this->swatdb->getRelOpsMgr()->selectAuto(
+        undergrads_file_id, fields, comps, values);
+    const SelectPlan &plan = 
+      this->swatdb->getRelOpsMgr()->getLastSelectPlan();
+    std::cout << "Auto Select Test - gpa <= 2.3: " 
+      << SelectPlanner::describe(plan) << std::endl;
+    CHECK_EQUAL(plan.path, FileScanP);
+    CHECK_EQUAL(result->getNumRecords(), 6000);
+  }
+
+  /**
+   * An equality select covered by a hash index on a large relation uses
+   * the index
+   */
+  TEST_FIXTURE(TestFixture, hashIndex){
+
+    char name[5] = {'J','a','c','k','\0'};
+    std::vector<FieldId> fields = {1};
+    std::vector<Comp> comps = {EQUAL};
+    std::vector<void *> values = {name};
+
+    FileId ind_id = this->swatdb->getCatalog()->getFileId(
+        this->name_index_file_name);
+    FileId gpa_ind_id = this->swatdb->getCatalog()->getFileId(
+        this->gpa_index_file_name);
+    HeapFile *result = this->swatdb->getRelOpsMgr()->select(AutoSelectT,
+        undergrads_file_id, fields, comps, values, ind_id);
+    const SelectPlan &plan = 
+      this->swatdb->getRelOpsMgr()->getLastSelectPlan();
+    std::cout << "Auto Select Test - name = Jack: " 
+      << SelectPlanner::describe(plan) << std::endl;
+    CHECK_EQUAL(plan.path, IndexScanP);
+    CHECK(plan.cost < plan.file_scan_cost);
+    CHECK_EQUAL(result->getNumRecords(), 3);
+
+    // an index on another relation is not a candidate
+    result = this->swatdb->getRelOpsMgr()->selectAuto(undergrads_file_id,
+        fields, comps, values, {gpa_ind_id});
+    CHECK_EQUAL(this->swatdb->getRelOpsMgr()->getLastSelectPlan().path,
+        FileScanP);
+    CHECK_EQUAL(result->getNumRecords(), 3);
+  }
+
+}
+
+/**
+ * Tests the statistics collected by analyze and the estimates made from
+ * them
+ */
+SUITE(AnalyzeTests) {
+
+  /**
+   * Full analyze: min and max, distinct counts, and a range estimate close
+   * to the 6000 records with gpa <= 2.3
+   */
+  TEST_FIXTURE(TestFixture, fullAnalyze){
+
+    float gpa = 2.3;
+    float high_gpa = 100;
+    RelOpsManager *relops = this->swatdb->getRelOpsMgr();
+    HeapFile *file = (HeapFile *)this->swatdb->getCatalog()->getFile(
+        undergrads_file_id);
+    relops->analyze(undergrads_file_id);
+    TableStats *stats = relops->getTableStats(undergrads_file_id);
+    CHECK(stats != nullptr);
+    CHECK_EQUAL(stats->getNumRecs(), file->getNumRecords());
+
+    const FieldStats &gpa_stats = stats->getFieldStats(4);
+    float min_gpa, max_gpa;
+    memcpy(&min_gpa, gpa_stats.min.data(), sizeof(float));
+    memcpy(&max_gpa, gpa_stats.max.data(), sizeof(float));
+    CHECK(min_gpa <= gpa && gpa <= max_gpa);
+    CHECK_EQUAL(gpa_stats.null_count, 0);
+    CHECK(stats->estimateDistinct(1) > 0);
+    CHECK(stats->estimateDistinct(1) <= stats->getNumRecs());
+
+    double sel = stats->estimateSelectivity(4, LESS_EQUAL, &gpa);
+    std::cout << "Analyze Test - gpa <= 2.3 estimated " 
+      << sel * stats->getNumRecs() << " rows" << std::endl;
+    CHECK(sel > 0.09 && sel < 0.15);
+    CHECK_CLOSE(stats->estimateSelectivity(4, GREATER, &gpa), 1 - sel, 
+        0.001);
+    CHECK_EQUAL(stats->estimateSelectivity(4, EQUAL, &high_gpa), 0);
+    CHECK_EQUAL(stats->estimateSelectivity(4, LESS, &high_gpa), 1);
+  }
+
+  /**
+   * The planner folds the bounds on an ordered index's field into one
+   * interval rather than multiplying their selectivities
+   */
+  TEST_FIXTURE(TestFixture, rangeSelectivity){
+
+    float gpa = 2.3;
+    float mid_gpa = 3.5;
+    float low_gpa = 1.0;
+    RelOpsManager *relops = this->swatdb->getRelOpsMgr();
+    HeapFile *file = (HeapFile *)this->swatdb->getCatalog()->getFile(
+        undergrads_file_id);
+    relops->analyze(undergrads_file_id);
+    TableStats *stats = relops->getTableStats(undergrads_file_id);
+    BTreeIndex *index = new BTreeIndex(
+        this->swatdb->getCatalog()->getSchema(undergrads_file_id), 4);
+    index->build(file);
+    SelectPlanner planner(this->swatdb->getCatalog(), undergrads_file_id,
+        file->getNumRecords(), 1);
+    planner.setTableStats(stats);
+
+    std::vector<FieldId> fields = {4, 4};
+    std::vector<Comp> comps = {LESS_EQUAL, LESS_EQUAL};
+    std::vector<void *> values = {&gpa, &mid_gpa};
+    double sel = stats->estimateSelectivity(4, LESS_EQUAL, &gpa);
+    CHECK_CLOSE(planner._rangeSelectivity(index, fields, comps, values),
+        sel, 0.001);
+
+    comps = {GREATER, LESS_EQUAL};
+    values = {&low_gpa, &gpa};
+    CHECK_CLOSE(planner._rangeSelectivity(index, fields, comps, values),
+        sel - stats->estimateSelectivity(4, LESS_EQUAL, &low_gpa), 0.001);
+
+    comps = {GREATER, LESS};
+    values = {&mid_gpa, &gpa};
+    CHECK_EQUAL(planner._rangeSelectivity(index, fields, comps, values), 0);
+    delete index;
+  }
+
+  /**
+   * A sampled analyze scales its counts up to the whole relation
+   */
+  TEST_FIXTURE(TestFixture, sampledAnalyze){
+
+    float gpa = 2.3;
+    RelOpsManager *relops = this->swatdb->getRelOpsMgr();
+    HeapFile *file = (HeapFile *)this->swatdb->getCatalog()->getFile(
+        undergrads_file_id);
+    relops->analyze(undergrads_file_id, 0.25);
+    TableStats *stats = relops->getTableStats(undergrads_file_id);
+    CHECK_EQUAL(stats->getNumRecs(), file->getNumRecords());
+    double sel = stats->estimateSelectivity(4, LESS_EQUAL, &gpa);
+    std::cout << "Analyze Test - sampled gpa <= 2.3 estimated " 
+      << sel * stats->getNumRecs() << " rows" << std::endl;
+    CHECK(sel > 0.06 && sel < 0.18);
+  }
+
+  /**
+   * A sampled analyze scales distinct counts up from the sample, so they
+   * stay close to those of a full analyze rather than to the quarter of
+   * the records it read
+   */
+  TEST_FIXTURE(TestFixture, sampledDistinct){
+
+    RelOpsManager *relops = this->swatdb->getRelOpsMgr();
+    relops->analyze(undergrads_file_id);
+    TableStats *stats = relops->getTableStats(undergrads_file_id);
+    double full_distinct = stats->estimateDistinct(0);
+
+    relops->analyze(undergrads_file_id, 0.25);
+    double sampled_distinct = stats->estimateDistinct(0);
+    std::cout << "Analyze Test - distinct values of field 0: full "
+      << full_distinct << ", sampled " << sampled_distinct << std::endl;
+    CHECK(sampled_distinct > 0.4 * full_distinct);
+    CHECK(sampled_distinct <= stats->getNumRecs());
+  }
+
+  /**
+   * Records added after analyze are folded in by updateStats
+   */
+  TEST_FIXTURE(TestFixture, incrementalStats){
+
+    float gpa = 2.3;
+    float new_gpa = 9.5;
+    std::vector<FieldId> fields = {4};
+    std::vector<Comp> comps = {LESS_EQUAL};
+    std::vector<void *> values = {&gpa};
+
+    RelOpsManager *relops = this->swatdb->getRelOpsMgr();
+    HeapFile *result = relops->select(FileScanT, undergrads_file_id, fields,
+        comps, values);
+    FileId res_id = result->getFileId();
+    relops->analyze(res_id);
+    TableStats *stats = relops->getTableStats(res_id);
+    CHECK_EQUAL(stats->getNumRecs(), 6000);
+    CHECK_EQUAL(stats->estimateSelectivity(4, GREATER, &gpa), 0);
+
+    // append a copy of the first record with a higher gpa
+    Schema *schema = this->swatdb->getCatalog()->getSchema(res_id);
+    RecordLayout layout(schema);
+    Record *rec = new Record(schema);
+    HeapFileScanner *scanner = new HeapFileScanner(result);
+    scanner->getNext(rec);
+    delete scanner;
+    memcpy(RecordLayout::getBytes(rec) + layout.getField(4).offset, 
+        &new_gpa, sizeof(float));
+    RecordId rid = result->insertRecord(*rec);
+    delete rec;
+
+    relops->updateStats(res_id, {rid});
+    CHECK_EQUAL(stats->getNumRecs(), 6001);
+    float max_gpa;
+    memcpy(&max_gpa, stats->getFieldStats(4).max.data(), sizeof(float));
+    CHECK_EQUAL(max_gpa, new_gpa);
+    CHECK(stats->estimateSelectivity(4, GREATER, &gpa) > 0);
+  }
+
+  /**
+   * Records inserted and deleted through the RelOpsManager are added to
+   * and taken out of the statistics without updateStats
+   */
+  TEST_FIXTURE(TestFixture, modifiedStats){
+
+    float gpa = 2.3;
+    float new_gpa = 9.5;
+    std::vector<FieldId> fields = {4};
+    std::vector<Comp> comps = {LESS_EQUAL};
+    std::vector<void *> values = {&gpa};
+
+    RelOpsManager *relops = this->swatdb->getRelOpsMgr();
+    HeapFile *result = relops->select(FileScanT, undergrads_file_id, fields,
+        comps, values);
+    FileId res_id = result->getFileId();
+    relops->analyze(res_id);
+    TableStats *stats = relops->getTableStats(res_id);
+
+    Schema *schema = this->swatdb->getCatalog()->getSchema(res_id);
+    RecordLayout layout(schema);
+    Record *rec = new Record(schema);
+    HeapFileScanner *scanner = new HeapFileScanner(result);
+    scanner->getNext(rec);
+    delete scanner;
+    memcpy(RecordLayout::getBytes(rec) + layout.getField(4).offset, 
+        &new_gpa, sizeof(float));
+    RecordId rid = relops->insertRecord(res_id, *rec);
+    delete rec;
+
+    CHECK_EQUAL(stats->getNumRecs(), 6001);
+    CHECK(stats->estimateSelectivity(4, GREATER, &gpa) > 0);
+    relops->deleteRecord(res_id, rid);
+    CHECK_EQUAL(stats->getNumRecs(), 6000);
+  }
+
+}
+
+/**
+ * Tests prepared selects, built once and run for several values
+ */
+SUITE(PreparedSelectTests) {
+
+  /**
+   * Point lookups through a prepared index select match one-off selects
+   */
+  TEST_FIXTURE(TestFixture, preparedIndexLookup){
+
+    char name[5] = {'J','a','c','k','\0'};
+    char other_name[6] = {'H','e','n','r','y','\0'};
+    std::vector<FieldId> fields = {1};
+    std::vector<Comp> comps = {EQUAL};
+
+    FileId ind_id = this->swatdb->getCatalog()->getFileId(
+        this->name_index_file_name);
+    PreparedSelect *prepared = this->swatdb->getRelOpsMgr()->prepareSelect(
+        IndexT, undergrads_file_id, fields, comps, {name}, ind_id);
+
+    HeapFile *expected = this->swatdb->getRelOpsMgr()->select(IndexT,
+        undergrads_file_id, fields, comps, {other_name}, ind_id);
+    CHECK_EQUAL(prepared->count({name}), 3);
+    CHECK_EQUAL(prepared->count({other_name}), expected->getNumRecords());
+    CHECK_EQUAL(prepared->count({name}), 3);
+
+    // a run left unfinished is ended by the next one
+    Record *rec = new Record(
+        this->swatdb->getCatalog()->getSchema(undergrads_file_id));
+    prepared->execute({name});
+    CHECK(prepared->getNext(rec) != INVALID_RECORD_ID);
+    CHECK(rec->compareFieldToValue(1, name, EQUAL));
+    CHECK_EQUAL(prepared->count({name}), 3);
+    CHECK_EQUAL(prepared->getNumExecutions(), 5);
+    delete rec;
+    delete prepared;
+  }
+
+  /**
+   * A prepared file scan rebinds the values of its compiled conjuncts
+   */
+  TEST_FIXTURE(TestFixture, preparedFileScan){
+
+    float gpa = 2.3;
+    float high_gpa = 3.9;
+    std::vector<FieldId> fields = {4};
+    std::vector<Comp> comps = {LESS_EQUAL};
+
+    PreparedSelect *prepared = this->swatdb->getRelOpsMgr()->prepareSelect(
+        FileScanT, undergrads_file_id, fields, comps, {&gpa});
+    HeapFile *expected = this->swatdb->getRelOpsMgr()->select(FileScanT,
+        undergrads_file_id, fields, comps, {&high_gpa});
+    CHECK_EQUAL(prepared->count({&gpa}), 6000);
+    CHECK_EQUAL(prepared->count({&high_gpa}), expected->getNumRecords());
+    CHECK_THROW(prepared->execute({&gpa, &gpa}),
+        MismatchingFieldsRelOpsManager);
+    delete prepared;
+  }
+
+}
+
+/**
+ * Tests the cursor select, which returns matches one at a time
+ */
+SUITE(SelectCursorTests) {
+
+  TEST_FIXTURE(TestFixture, fileScanCursor){
+
+    int cs_dept_id = 2;
+    std::vector<FieldId> fields = {3};
+    std::vector<Comp> comps = {EQUAL};
+    std::vector<void *> values = {&cs_dept_id};
+
+    SelectCursor *cursor = this->swatdb->getRelOpsMgr()->selectCursor(
+        FileScanT, profs_file_id, fields, comps, values);
+    Record *rec = new Record(
+        this->swatdb->getCatalog()->getSchema(profs_file_id));
+    int count = 0;
+    while( cursor->getNext(rec) != INVALID_RECORD_ID ){
+      CHECK(rec->compareFieldToValue(3, &cs_dept_id, EQUAL));
+      count++;
+    }
+    CHECK_EQUAL(count, 3);
+    CHECK_EQUAL(cursor->getNumReturned(), 3);
+    delete rec;
+    delete cursor;
+  }
+
+  /**
+   * 2000 undergrads match, but a cursor with a limit of 1 stops at the
+   * first
+   */
+  TEST_FIXTURE(TestFixture, fileScanLimit){
+
+    float gpa = 3.9;
+    std::vector<FieldId> fields = {4};
+    std::vector<Comp> comps = {EQUAL};
+    std::vector<void *> values = {&gpa};
+
+    SelectCursor *cursor = this->swatdb->getRelOpsMgr()->selectCursor(
+        FileScanT, undergrads_file_id, fields, comps, values,
+        INVALID_FILE_ID, 1);
+    Record *rec = new Record(
+        this->swatdb->getCatalog()->getSchema(undergrads_file_id));
+    CHECK(cursor->getNext(rec) != INVALID_RECORD_ID);
+    CHECK(rec->compareFieldToValue(4, &gpa, EQUAL));
+    CHECK(cursor->getNext(rec) == INVALID_RECORD_ID);
+    CHECK_EQUAL(cursor->getNumReturned(), 1);
+    delete rec;
+    delete cursor;
+  }
+
+  TEST_FIXTURE(TestFixture, indexCursor){
+
+    float gpa = 4.0;
+    int major_id = 3;
+    std::vector<FieldId> fields = {3, 4};
+    std::vector<Comp> comps = {EQUAL, EQUAL};
+    std::vector<void *> values = {&major_id, &gpa};
+
+    FileId ind_id = this->swatdb->getCatalog()->getFileId(
+                        this->gpa_index_file_name);
+
+    SelectCursor *cursor = this->swatdb->getRelOpsMgr()->selectCursor(IndexT,
+        phds_file_id, fields, comps, values, ind_id, 10);
+    Record *rec = new Record(
+        this->swatdb->getCatalog()->getSchema(phds_file_id));
+    int count = 0;
+    while( cursor->getNext(rec) != INVALID_RECORD_ID ){
+      count++;
+    }
+    CHECK_EQUAL(count, 4);
+    delete rec;
+    delete cursor;
+  }
+
 }
 
 SUITE(ExceptionTests) {
@@ -424,7 +1831,7 @@ SUITE(ExceptionTests) {
     int major_id = 3;
     int stud_id = 20;
     std::vector<FieldId> fields = {0, 3, 4};
-    std::vector<Comp> comps = {EQUAL, EQUAL, EQUAL};
+    std::vector<Comp> comps = {EQUAL, EQUAL, LESS_EQUAL};
     std::vector<void *> values = {&stud_id, &major_id, &gpa};
 
     FileId ind_id = this->swatdb->getCatalog()->getFileId(
@@ -459,7 +1866,12 @@ SUITE(ExceptionTests) {
 void usage(){
   std::cout << "Usage: ./selecttests -s <suite_name> -h help\n";
   std::cout << "Available Suites: FileScanOneFieldEqual, " 
-    << "FileScanOneFieldRange, FileScanMultiField, IndexSelectTests,"
+    << "FileScanOneFieldRange, FileScanMultiField, ConjunctReordering, "
+    << "VectorFileScan, "
+    << "ParallelFileScan, "
+    << "ZoneMapTests, IndexSelectTests, CountExistsTests, "
+    << "RangeIndexTests, InListTests, MultiIndexTests, AutoSelectTests, "
+    << "AnalyzeTests, SelectCursorTests, PreparedSelectTests, "
     << "ExceptionTests" << std::endl;
 }
 
@@ -0,0 +1,577 @@
+#include <string>
+#include <cstring>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <math.h>
+#include "swatdb_types.h"
+#include "tablestats.h"
+#include "recordlayout.h"
+#include "pinnedpagescan.h"
+#include "schema.h"
+#include "record.h"
+#include "data.h"
+#include "heapfile.h"
+#include "heapfilescanner.h"
+
+/*
+ * Number of equi-depth histogram buckets built per field
+ */
+static const std::uint32_t NUM_BUCKETS = 32;
+
+/*
+ * HyperLogLog precision: 2^HLL_BITS registers, selected by the top
+ * HLL_BITS bits of a value's hash
+ */
+static const std::uint32_t HLL_BITS = 10;
+static const std::uint32_t HLL_REGISTERS = 1 << HLL_BITS;
+
+/*
+ * Number of records kept in the reservoir sample the histograms are cut
+ * from, which bounds analyze's memory whatever the relation's size
+ */
+static const std::uint64_t RESERVOIR_ROWS = 16384;
+
+/*
+ * Seed of the generator that picks sampled pages and reservoir slots, fixed so analyzing the
+ * same relation twice gives the same statistics
+ */
+static const std::uint32_t SAMPLE_SEED = 0x5eed;
+
+/*
+ * 64-bit hash of a normalized value: FNV-1a over its bytes, then the
+ * splitmix64 finalizer so the top bits are well mixed.
+ */
+static std::uint64_t hashValue(const std::string &val) {
+  std::uint64_t h = 14695981039346656037ULL;
+  for( unsigned char c : val ){
+    h = ( h ^ c ) * 1099511628211ULL;
+  }
+  h = ( h ^ ( h >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+  h = ( h ^ ( h >> 27 ) ) * 0x94d049bb133111ebULL;
+  return h ^ ( h >> 31 );
+}
+
+/*
+ * Adds a normalized value to a HyperLogLog sketch: the top HLL_BITS bits of
+ * its hash pick the register, which keeps the largest position of the
+ * first 1 bit seen in the rest.
+ */
+static void addToSketch(std::vector<std::uint8_t> &hll,
+    const std::string &val) {
+  std::uint64_t h = hashValue(val);
+  std::uint32_t reg = h >> ( 64 - HLL_BITS );
+  std::uint64_t rest = h << HLL_BITS;
+  std::uint8_t rank = rest == 0 ? 64 - HLL_BITS + 1 : 
+    __builtin_clzll(rest) + 1;
+  hll[reg] = std::max(hll[reg], rank);
+}
+
+/*
+ * Returns a numeric field value as a double, for interpolating within a
+ * histogram bucket.
+ */
+static double toNumber(const FieldLayout &field, const char *val) {
+  if( field.type == INT ){
+    std::int32_t x;
+    memcpy(&x, val, sizeof(x));
+    return x;
+  }
+  float x;
+  memcpy(&x, val, sizeof(x));
+  return x;
+}
+
+/*
+ * Widens a field's min and max to include a value.
+ */
+static void widenRange(FieldStats &stats, const FieldLayout &field,
+    const char *val) {
+  if( stats.min.empty() ){
+    stats.min.assign(val, val + field.size);
+    stats.max.assign(val, val + field.size);
+  }
+  else if( RecordLayout::compareFieldValues(field, val, 
+        stats.min.data()) < 0 ){
+    stats.min.assign(val, val + field.size);
+  }
+  else if( RecordLayout::compareFieldValues(field, val,
+        stats.max.data()) > 0 ){
+    stats.max.assign(val, val + field.size);
+  }
+}
+
+/**
+ * @brief Constructor for empty TableStats.
+ *
+ * @param schema. Schema * of the relation.
+ */
+TableStats::TableStats(Schema *schema) {
+  this->schema = schema;
+  this->layout = new RecordLayout(schema);
+  this->fields.resize(this->layout->getNumFields());
+  this->_reset();
+}
+
+/**
+ * @brief Destructor for TableStats.
+ */
+TableStats::~TableStats() {
+  delete this->layout;
+}
+
+/**
+ * @brief Builds the statistics from scratch in one streaming pass. With a
+ *    buffer manager and a sample fraction below 1, that fraction of the
+ *    relation's pages is picked at random by page id, and only those pages
+ *    are pinned and read; otherwise the relation is scanned. Each record
+ *    read widens min and max and goes into the distinct count sketch as it
+ *    is read, and a bounded reservoir sample of the records is kept, so the
+ *    memory used does not grow with the relation. The reservoir is sorted
+ *    per field to cut the equi-depth buckets, whose counts are then scaled
+ *    up to the relation's size. If only a sample of the pages was read,
+ *    distinct counts are scaled up with the GEE estimator over the
+ *    reservoir, sqrt(N / n) * f1 + (values seen more than once), where N
+ *    is the relation's size, n the reservoir's and f1 the number of values
+ *    seen exactly once: values seen several times are likely common, and
+ *    those seen once stand for the many the sample missed.
+ *
+ * @param file. HeapFile * of the relation.
+ * @param buf_mgr. BufferManager * pages are pinned in, nullptr to scan the
+ *    whole relation.
+ * @param sample_fraction. Fraction of the pages to read, in (0, 1].
+ */
+void TableStats::analyze(HeapFile *file, BufferManager *buf_mgr,
+    double sample_fraction) {
+
+  this->_reset();
+  std::uint32_t rsize = this->layout->getRecordSize();
+  std::mt19937 rng(SAMPLE_SEED);
+
+  // fold each record read into min, max and the sketches, and keep a
+  // reservoir sample of them (Algorithm R) for the histograms
+  std::vector<char> reservoir;
+  std::uint64_t read = 0;
+  auto take = [&](const char *bytes){
+    for( FieldId fid = 0; fid < this->fields.size(); fid++ ){
+      const FieldLayout &field = this->layout->getField(fid);
+      const char *val = bytes + field.offset;
+      widenRange(this->fields[fid], field, val);
+      RecordLayout::normalizeValue(field, val, this->scratch);
+      addToSketch(this->fields[fid].hll, this->scratch);
+    }
+    read++;
+    if( read <= RESERVOIR_ROWS ){
+      reservoir.insert(reservoir.end(), bytes, bytes + rsize);
+      return;
+    }
+    std::uint64_t pos = std::uniform_int_distribution<std::uint64_t>(0,
+        read - 1)(rng);
+    if( pos < RESERVOIR_ROWS ){
+      memcpy(&reservoir[pos * rsize], bytes, rsize);
+    }
+  };
+
+  std::uint64_t total = 0;
+  if( buf_mgr != nullptr && sample_fraction > 0 && sample_fraction < 1 ){
+    std::vector<PageId> pages = PinnedPageScan::listPages(file);
+    std::size_t num_sampled = std::max<std::size_t>(1,
+        (std::size_t)ceil(pages.size() * sample_fraction));
+    std::vector<PageId> sample;
+    std::sample(pages.begin(), pages.end(), std::back_inserter(sample),
+        num_sampled, rng);
+
+    PinnedPageScan page_scan(buf_mgr);
+    for( PageId page_id : sample ){
+      page_scan.pin(page_id);
+      SlotId slot_id;
+      const char *bytes;
+      while( ( bytes = page_scan.next(&slot_id) ) != nullptr ){
+        take(bytes);
+      }
+      page_scan.release();
+    }
+    total = file->getNumRecs();
+  }
+  else {
+    HeapFileScanner* scanner = new HeapFileScanner(file);
+    Record *record = new Record(this->schema);
+    const char *bytes = RecordLayout::getBytes(record);
+    while( scanner->getNext(record) != INVALID_RECORD_ID ){
+      take(bytes);
+    }
+    delete record->getRecordData();
+    delete record;
+    delete scanner;
+    total = read;
+  }
+
+  std::uint64_t kept = reservoir.size() / rsize;
+  if( kept == 0 ) return;
+  double scale = (double)total / kept;
+  this->num_recs = total;
+
+  std::vector<std::size_t> perm(kept);
+  for( FieldId fid = 0; fid < this->fields.size(); fid++ ){
+    const FieldLayout &field = this->layout->getField(fid);
+    FieldStats &stats = this->fields[fid];
+
+    for( std::size_t r = 0; r < kept; r++ ){
+      perm[r] = r;
+    }
+    std::sort(perm.begin(), perm.end(),
+        [&](std::size_t a, std::size_t b){
+          return RecordLayout::compareFieldValues(field,
+              &reservoir[a * rsize + field.offset],
+              &reservoir[b * rsize + field.offset]) < 0;
+        });
+
+    // count the reservoir's values seen once and those seen more often
+    if( read < total ){
+      std::uint64_t once = 0;
+      std::uint64_t repeated = 0;
+      std::uint64_t run_start = 0;
+      for( std::uint64_t r = 1; r <= kept; r++ ){
+        if( r < kept && RecordLayout::compareFieldValues(field,
+              &reservoir[perm[r - 1] * rsize + field.offset],
+              &reservoir[perm[r] * rsize + field.offset]) == 0 ){
+          continue;
+        }
+        if( r - run_start == 1 ) once++;
+        else repeated++;
+        run_start = r;
+      }
+      double estimate = sqrt(scale) * once + repeated;
+      stats.distinct_scale = std::max(1.0,
+          estimate / this->_sketchEstimate(fid));
+    }
+
+    // cut equi-depth buckets, moving each bound past the copies of its
+    // value so no value is split between two buckets
+    std::uint64_t start = 0;
+    for( std::uint32_t b = 0; b < NUM_BUCKETS && start < kept; b++ ){
+      std::uint64_t end = std::max<std::uint64_t>(start + 1,
+          ( b + 1 ) * kept / NUM_BUCKETS);
+      const char *bound = &reservoir[perm[end - 1] * rsize + field.offset];
+      while( end < kept && RecordLayout::compareFieldValues(field, bound,
+            &reservoir[perm[end] * rsize + field.offset]) == 0 ){
+        end++;
+      }
+      stats.upper_bounds.insert(stats.upper_bounds.end(), bound,
+          bound + field.size);
+      stats.bucket_counts.push_back(( end - start ) * scale);
+      start = end;
+    }
+  }
+}
+
+/**
+ * @brief Adds one record to the statistics: widens min and max, counts it
+ *    in the bucket it falls in (widening the last bucket for values above
+ *    the maximum), and adds it to the distinct count sketch.
+ *
+ * @param bytes. Raw bytes of the record.
+ */
+void TableStats::addRecord(const char *bytes) {
+
+  for( FieldId fid = 0; fid < this->fields.size(); fid++ ){
+    const FieldLayout &field = this->layout->getField(fid);
+    FieldStats &stats = this->fields[fid];
+    const char *val = bytes + field.offset;
+    widenRange(stats, field, val);
+
+    std::uint32_t b = this->_findBucket(fid, val);
+    if( b == stats.bucket_counts.size() ){
+      if( b == 0 ){
+        stats.bucket_counts.push_back(0);
+        stats.upper_bounds.insert(stats.upper_bounds.end(), val,
+            val + field.size);
+      }
+      else {
+        b--;
+        memcpy(&stats.upper_bounds[b * field.size], val, field.size);
+      }
+    }
+    stats.bucket_counts[b]++;
+
+    RecordLayout::normalizeValue(field, val, this->scratch);
+    addToSketch(stats.hll, this->scratch);
+  }
+  this->num_recs++;
+}
+
+/**
+ * @brief Takes one record out of the statistics: uncounts it from the
+ *    bucket it falls in, if that bucket still counts a record. Min and max
+ *    are left as bounds that may be wider than the remaining values, and
+ *    the distinct count sketch, which can not forget a value, is left too;
+ *    the estimate is capped at the record count.
+ *
+ * @param bytes. Raw bytes of the record.
+ */
+void TableStats::removeRecord(const char *bytes) {
+
+  for( FieldId fid = 0; fid < this->fields.size(); fid++ ){
+    const FieldLayout &field = this->layout->getField(fid);
+    FieldStats &stats = this->fields[fid];
+    std::uint32_t b = this->_findBucket(fid, bytes + field.offset);
+    if( b < stats.bucket_counts.size() && stats.bucket_counts[b] >= 1 ){
+      stats.bucket_counts[b]--;
+    }
+  }
+  if( this->num_recs > 0 ) this->num_recs--;
+}
+
+/**
+ * @brief Returns the number of records the statistics describe.
+ */
+std::uint64_t TableStats::getNumRecs() {
+  return this->num_recs;
+}
+
+/**
+ * @brief Returns the statistics of one field.
+ *
+ * @param fid. FieldId of the field.
+ */
+const FieldStats &TableStats::getFieldStats(FieldId fid) {
+  return this->fields[fid];
+}
+
+/**
+ * @brief Returns the estimated number of distinct values of a field: the
+ *    sketch's estimate scaled from the sample analyze read up to the
+ *    relation and capped at the number of records.
+ *
+ * @param fid. FieldId of the field.
+ */
+double TableStats::estimateDistinct(FieldId fid) {
+  return std::min(this->_sketchEstimate(fid) *
+      this->fields[fid].distinct_scale, (double)this->num_recs);
+}
+
+/**
+ * @brief Returns the HyperLogLog estimate of the number of distinct values
+ *    of a field among the records added to its sketch, with linear
+ *    counting for small cardinalities.
+ *
+ * @param fid. FieldId of the field.
+ */
+double TableStats::_sketchEstimate(FieldId fid) {
+
+  const std::vector<std::uint8_t> &hll = this->fields[fid].hll;
+  double m = HLL_REGISTERS;
+  double sum = 0;
+  std::uint32_t zeros = 0;
+  for( std::uint8_t reg : hll ){
+    sum += ldexp(1.0, -reg);
+    if( reg == 0 ) zeros++;
+  }
+  double estimate = 0.7213 / ( 1 + 1.079 / m ) * m * m / sum;
+  if( estimate <= 2.5 * m && zeros > 0 ){
+    estimate = m * log(m / zeros);
+  }
+  return estimate;
+}
+
+/**
+ * @brief Returns the estimated fraction of records that pass the conjunct
+ *    "field comp value". Equality is one over the distinct count (0 outside
+ *    min and max), and ranges are read from the histogram.
+ *
+ * @param fid. FieldId of the field.
+ * @param comp. Comp of the conjunct.
+ * @param value. void * to the value compared against.
+ */
+double TableStats::estimateSelectivity(FieldId fid, Comp comp, void *value) {
+
+  const FieldStats &stats = this->fields[fid];
+  if( this->num_recs == 0 || stats.min.empty() ) return 0;
+  const FieldLayout &field = this->layout->getField(fid);
+  const char *val = (const char *)value;
+
+  double eq = 1 / std::max(1.0, this->estimateDistinct(fid));
+  if( RecordLayout::compareFieldValues(field, val, stats.min.data()) < 0 ||
+      RecordLayout::compareFieldValues(field, val, stats.max.data()) > 0 ){
+    eq = 0;
+  }
+  switch(comp) {
+    case EQUAL: return eq;
+    case NOTEQUAL: return 1 - eq;
+    case LESS: return this->_fractionBelow(fid, val, false);
+    case LESS_EQUAL: return this->_fractionBelow(fid, val, true);
+    case GREATER: return 1 - this->_fractionBelow(fid, val, true);
+    case GREATER_EQUAL: return 1 - this->_fractionBelow(fid, val, false);
+    default: return 1;
+  }
+}
+
+/**
+ * @brief Writes the statistics to a file: the field count, the record
+ *    count, then for each field its size, min, max, null count, bucket
+ *    count, bucket bounds and counts, registers and distinct scale.
+ *
+ * @param path. Path of the side file.
+ */
+void TableStats::save(std::string path) {
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  std::uint32_t num_fields = this->fields.size();
+  out.write((const char *)&num_fields, sizeof(num_fields));
+  out.write((const char *)&this->num_recs, sizeof(this->num_recs));
+  for( FieldId fid = 0; fid < num_fields; fid++ ){
+    const FieldStats &stats = this->fields[fid];
+    std::uint32_t size = this->layout->getField(fid).size;
+    std::uint32_t num_buckets = stats.bucket_counts.size();
+    std::uint32_t has_values = !stats.min.empty();
+    out.write((const char *)&size, sizeof(size));
+    out.write((const char *)&has_values, sizeof(has_values));
+    if( has_values ){
+      out.write(stats.min.data(), size);
+      out.write(stats.max.data(), size);
+    }
+    out.write((const char *)&stats.null_count, sizeof(stats.null_count));
+    out.write((const char *)&num_buckets, sizeof(num_buckets));
+    out.write(stats.upper_bounds.data(), stats.upper_bounds.size());
+    out.write((const char *)stats.bucket_counts.data(),
+        num_buckets * sizeof(double));
+    out.write((const char *)stats.hll.data(), stats.hll.size());
+    out.write((const char *)&stats.distinct_scale,
+        sizeof(stats.distinct_scale));
+  }
+}
+
+/**
+ * @brief Reads statistics from a file written by save, replacing the
+ *    current contents.
+ *
+ * @param path. Path of the side file.
+ *
+ * @return False if the file does not exist or was written for a different
+ *    schema, True if the statistics were loaded.
+ */
+bool TableStats::load(std::string path) {
+
+  std::ifstream in(path, std::ios::binary);
+  std::uint32_t num_fields;
+  if( !in.read((char *)&num_fields, sizeof(num_fields)) ) return false;
+  if( num_fields != this->fields.size() ) return false;
+  this->_reset();
+  in.read((char *)&this->num_recs, sizeof(this->num_recs));
+  for( FieldId fid = 0; fid < num_fields; fid++ ){
+    FieldStats &stats = this->fields[fid];
+    std::uint32_t size, has_values, num_buckets;
+    in.read((char *)&size, sizeof(size));
+    if( size != this->layout->getField(fid).size ) return false;
+    in.read((char *)&has_values, sizeof(has_values));
+    if( has_values ){
+      stats.min.resize(size);
+      stats.max.resize(size);
+      in.read(stats.min.data(), size);
+      in.read(stats.max.data(), size);
+    }
+    in.read((char *)&stats.null_count, sizeof(stats.null_count));
+    in.read((char *)&num_buckets, sizeof(num_buckets));
+    stats.upper_bounds.resize(num_buckets * size);
+    stats.bucket_counts.resize(num_buckets);
+    in.read(stats.upper_bounds.data(), stats.upper_bounds.size());
+    in.read((char *)stats.bucket_counts.data(), 
+        num_buckets * sizeof(double));
+    in.read((char *)stats.hll.data(), stats.hll.size());
+    in.read((char *)&stats.distinct_scale, sizeof(stats.distinct_scale));
+  }
+  return (bool)in;
+}
+
+/**
+ * @brief Resets every field's statistics to those of no records.
+ */
+void TableStats::_reset() {
+  this->num_recs = 0;
+  for( FieldStats &stats : this->fields ){
+    stats.min.clear();
+    stats.max.clear();
+    stats.null_count = 0;
+    stats.upper_bounds.clear();
+    stats.bucket_counts.clear();
+    stats.hll.assign(HLL_REGISTERS, 0);
+    stats.distinct_scale = 1;
+  }
+}
+
+/**
+ * @brief Returns the estimated fraction of records whose value of a field
+ *    is below value (or at most value if inclusive). The buckets below the
+ *    one value falls in count in full; within that bucket numeric values
+ *    are interpolated between its bounds and character values take half.
+ *    Copies of value itself count one over the distinct count of the
+ *    relation's records, up to what is left of the bucket.
+ */
+double TableStats::_fractionBelow(FieldId fid, const char *value,
+    bool inclusive) {
+
+  const FieldStats &stats = this->fields[fid];
+  const FieldLayout &field = this->layout->getField(fid);
+  std::uint32_t b = this->_findBucket(fid, value);
+  if( b == stats.bucket_counts.size() ) return 1;
+
+  double below = 0;
+  for( std::uint32_t i = 0; i < b; i++ ){
+    below += stats.bucket_counts[i];
+  }
+  double count = stats.bucket_counts[b];
+  double eq_rows = std::min(count, 
+      this->num_recs / std::max(1.0, this->estimateDistinct(fid)));
+  const char *lo = b == 0 ? stats.min.data() :
+    &stats.upper_bounds[( b - 1 ) * field.size];
+  const char *hi = &stats.upper_bounds[b * field.size];
+
+  double part;
+  if( RecordLayout::compareFieldValues(field, value, hi) == 0 ){
+    part = count - ( inclusive ? 0 : eq_rows );
+  }
+  else if( b == 0 && 
+      RecordLayout::compareFieldValues(field, value, lo) < 0 ){
+    part = 0;
+  }
+  else {
+    double frac = 0.5;
+    if( field.type == INT || field.type == FLOAT ){
+      double x = toNumber(field, value);
+      double l = toNumber(field, lo);
+      double h = toNumber(field, hi);
+      frac = h > l ? ( x - l ) / ( h - l ) : 0;
+    }
+    part = frac * count;
+    if( inclusive ) part = std::min(count, part + eq_rows);
+  }
+  double total = 0;
+  for( double c : stats.bucket_counts ) total += c;
+  return total > 0 ? std::min(1.0, ( below + part ) / total) : 0;
+}
+
+/**
+ * @brief Returns the number of the first histogram bucket whose upper bound
+ *    is at least value, or the number of buckets if value is above them
+ *    all.
+ */
+std::uint32_t TableStats::_findBucket(FieldId fid, const char *value) {
+
+  const FieldStats &stats = this->fields[fid];
+  const FieldLayout &field = this->layout->getField(fid);
+  std::uint32_t lo = 0;
+  std::uint32_t hi = stats.bucket_counts.size();
+  while( lo < hi ){
+    std::uint32_t mid = ( lo + hi ) / 2;
+    if( RecordLayout::compareFieldValues(field,
+          &stats.upper_bounds[mid * field.size], value) < 0 ){
+      lo = mid + 1;
+    }
+    else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
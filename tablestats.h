@@ -0,0 +1,202 @@
+#ifndef _SWATDB_TABLESTATS_H_
+#define _SWATDB_TABLESTATS_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include "swatdb_types.h"
+#include "recordlayout.h"
+
+class Schema;
+class HeapFile;
+class BufferManager;
+
+/**
+ * Struct of the statistics kept for one field of a relation.
+ */
+struct FieldStats {
+  /**
+   * Smallest and largest value of the field (field size bytes each, empty
+   * if no record has been seen)
+   */
+  std::vector<char> min;
+  std::vector<char> max;
+  /**
+   * Number of NULL values. SwatDB records have no NULLs, so this stays 0;
+   * it is kept so the format does not change if they are added.
+   */
+  std::uint64_t null_count;
+  /**
+   * Equi-depth histogram: bucket i holds the values greater than the upper
+   * bound of bucket i - 1 (or min) and at most its own upper bound, and
+   * counts how many records fall in it. Upper bounds are field size bytes
+   * each, back to back.
+   */
+  std::vector<char> upper_bounds;
+  std::vector<double> bucket_counts;
+  /**
+   * HyperLogLog registers for the distinct count estimate
+   */
+  std::vector<std::uint8_t> hll;
+  /**
+   * Ratio of the relation's estimated distinct count to the distinct
+   * count of the records analyze read. The registers only see the sample,
+   * so their estimate is scaled by it; 1 if every record was read.
+   */
+  double distinct_scale;
+};
+
+/**
+ * TableStats holds per-field statistics of a relation: min and max, null
+ * counts, an equi-depth histogram and a HyperLogLog distinct count sketch.
+ * They are built by analyze, which streams the relation once (or a sample
+ * of its pages), are kept up to date as records are added and removed with
+ * addRecord and removeRecord, and
+ * are saved in a side file next to the relation. They give selectivity
+ * estimates for select conjuncts.
+ */
+class TableStats {
+
+  public:
+
+    /**
+     * @brief Constructor for empty TableStats.
+     *
+     * @param schema. Schema * of the relation.
+     */
+    TableStats(Schema *schema);
+
+    /**
+     * @brief Destructor for TableStats.
+     */
+    ~TableStats();
+
+    /**
+     * @brief Builds the statistics from scratch in one pass, keeping only
+     *    a bounded sample of the records for the histograms. With a buffer
+     *    manager and a sample fraction below 1, only a random sample of
+     *    the pages is pinned and read; otherwise every record is read.
+     *
+     * @param file. HeapFile * of the relation.
+     * @param buf_mgr. BufferManager * pages are pinned in, nullptr to scan
+     *    the whole relation.
+     * @param sample_fraction. Fraction of the pages to read, in (0, 1].
+     */
+    void analyze(HeapFile *file, BufferManager *buf_mgr,
+        double sample_fraction);
+
+    /**
+     * @brief Adds one record to the statistics: widens min and max, counts
+     *    it in its histogram bucket and adds it to the distinct count.
+     *
+     * @param bytes. Raw bytes of the record.
+     */
+    void addRecord(const char *bytes);
+
+    /**
+     * @brief Takes one record out of the statistics: uncounts it from its
+     *    histogram bucket. Min, max and the distinct count sketch can not
+     *    be narrowed and stay as they are.
+     *
+     * @param bytes. Raw bytes of the record.
+     */
+    void removeRecord(const char *bytes);
+
+    /**
+     * @brief Returns the number of records the statistics describe.
+     */
+    std::uint64_t getNumRecs();
+
+    /**
+     * @brief Returns the statistics of one field.
+     *
+     * @param fid. FieldId of the field.
+     */
+    const FieldStats &getFieldStats(FieldId fid);
+
+    /**
+     * @brief Returns the estimated number of distinct values of a field.
+     *
+     * @param fid. FieldId of the field.
+     */
+    double estimateDistinct(FieldId fid);
+
+    /**
+     * @brief Returns the estimated fraction of records that pass the
+     *    conjunct "field comp value".
+     *
+     * @param fid. FieldId of the field.
+     * @param comp. Comp of the conjunct.
+     * @param value. void * to the value compared against.
+     */
+    double estimateSelectivity(FieldId fid, Comp comp, void *value);
+
+    /**
+     * @brief Writes the statistics to a file.
+     *
+     * @param path. Path of the side file.
+     */
+    void save(std::string path);
+
+    /**
+     * @brief Reads statistics from a file written by save, replacing the
+     *    current contents.
+     *
+     * @param path. Path of the side file.
+     *
+     * @return False if the file does not exist or was written for a
+     *    different schema, True if the statistics were loaded.
+     */
+    bool load(std::string path);
+
+  private:
+
+    /**
+     * @brief Resets every field's statistics to those of no records.
+     */
+    void _reset();
+
+    /**
+     * @brief Returns the sketch's estimate of the number of distinct values
+     *    of a field, before scaling.
+     */
+    double _sketchEstimate(FieldId fid);
+
+    /**
+     * @brief Returns the estimated fraction of records whose value of a
+     *    field is below value (or at most value if inclusive).
+     */
+    double _fractionBelow(FieldId fid, const char *value, bool inclusive);
+
+    /**
+     * @brief Returns the number of the histogram bucket a value falls in.
+     */
+    std::uint32_t _findBucket(FieldId fid, const char *value);
+
+    /**
+     * Schema and byte layout of the relation's records
+     */
+    Schema *schema;
+    RecordLayout *layout;
+
+    /**
+     * Statistics of each field, indexed by FieldId
+     */
+    std::vector<FieldStats> fields;
+
+    /**
+     * Number of records described
+     */
+    std::uint64_t num_recs;
+
+    /**
+     * Reused buffer for normalized values
+     */
+    std::string scratch;
+
+};
+
+#endif
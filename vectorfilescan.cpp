@@ -0,0 +1,184 @@
+#include <string>
+#include <cstring>
+#include <vector>
+#include "swatdb_types.h"
+#include "vectorfilescan.h"
+#include "recordlayout.h"
+#include "recordbatch.h"
+#include "record.h"
+#include "heapfile.h"
+#include "heapfilescanner.h"
+#include "catalog.h"
+#include "resultwriter.h"
+#include "paxfile.h"
+
+
+/**
+ * @brief Constructor for VectorFileScan select operation. The batch is
+ *    sized to hold every record that fits on one page.
+ *
+ * @param rel_id. File id of the relation file. 
+ * @param result_id. File id of the result file. 
+ * @param fields. Vector of field ids for the select operation. 
+ * @param comps. Vector of Comps for the select operation.
+ * @param values. Vector of Void * for the select operation. 
+ * @param catalog. Catalog * for SwatDB.
+ */
+VectorFileScan::VectorFileScan(FileId rel_id, FileId result_id,
+    std::vector<FieldId> fields, std::vector<Comp> comps,
+    std::vector<void *> values, Catalog *catalog) : Select(rel_id, result_id,
+    fields, comps, values, catalog) {
+
+  std::uint32_t capacity = PAGE_SIZE / this->layout->getRecordSize();
+  if( capacity == 0 ) capacity = 1;
+  this->batch = new RecordBatch(this->layout, this->fields, capacity);
+  this->pax_file = nullptr;
+  this->num_column_pages = 0;
+}
+
+/**
+ * @brief Destructor for VectorFileScan select operation.
+ *
+ * @post Batch is cleaned up
+ */
+VectorFileScan::~VectorFileScan(){
+  delete this->batch;
+}
+
+/**
+ * @brief Performs the vectorized file scan select operation. The scanner
+ *    returns records in page order, so a batch is evaluated whenever the
+ *    page id of the next record changes (or the batch fills up). The
+ *    relation's columnar copy, if it has one, is scanned instead.
+ *
+ * @pre Valid files and parameters have been passed to the contructor.      
+ * @post Result file has been populated with records that meet the criteria 
+ *    of the operation.                                                     
+ */
+void VectorFileScan::runOperation() {
+  HeapFile* file = (HeapFile *)this->file_state.file;
+  this->num_column_pages = 0;
+  // the RelOpsManager keeps the copy in step with the relation or drops it;
+  // the count only guards against changes made through the HeapFile
+  if( this->pax_file != nullptr &&
+      this->pax_file->getNumRecs() == file->getNumRecs() ){
+    this->_runPax();
+    return;
+  }
+
+  HeapFileScanner* scanner = new HeapFileScanner(file);
+  Record *record = this->file_state.rec;
+  PageNum cur_page = 0;
+
+  while( true ){
+    RecordId rid = scanner->getNext(record);
+    if( rid == INVALID_RECORD_ID ) break;
+    // start a new batch at each page boundary
+    if( this->batch->getNumRows() > 0 &&
+        ( rid.page_id.page_num != cur_page || this->batch->isFull() ) ){
+      this->_runBatch();
+    }
+    cur_page = rid.page_id.page_num;
+    this->batch->appendRow(RecordLayout::getBytes(record));
+  }
+  if( this->batch->getNumRows() > 0 ){
+    this->_runBatch();
+  }
+
+  delete scanner;
+}
+
+/**
+ * @brief Evaluates every conjunct over the current batch, adds the
+ *    selected rows to the result file and empties the batch. If there is a
+ *    projection, each selected row is built with the copy plan straight
+ *    into space reserved by the result writer.
+ */
+void VectorFileScan::_runBatch() {
+
+  for( size_t i = 0; i < fields.size(); i++ ){
+    this->batch->filter(fields[i], comps[i], values[i], this->file_state.rec);
+  }
+
+  for( std::uint32_t row : this->batch->getSelection() ){
+    const char *src = this->batch->getRow(row);
+    if( this->result_layout == nullptr ){
+      this->result_writer->append(src);
+      continue;
+    }
+    char *dest = this->result_writer->reserve();
+    for( const CopyRun &run : this->copy_plan ){
+      memcpy(dest + run.dst_offset, src + run.src_offset, run.length);
+    }
+    this->result_writer->commit();
+  }
+  this->batch->clear();
+}
+
+/**
+ * @brief Sets a columnar copy of the relation to scan instead of the
+ *    relation itself.
+ *
+ * @param pax_file. PaxFile * of the relation, nullptr for none.
+ */
+void VectorFileScan::setPaxFile(PaxFile *pax_file) {
+  this->pax_file = pax_file;
+}
+
+/**
+ * @brief Returns the number of columnar pages the last run scanned.
+ */
+std::uint32_t VectorFileScan::getNumColumnPages() {
+  return this->num_column_pages;
+}
+
+/**
+ * @brief Runs the select over every page of the columnar copy. Each
+ *    conjunct's kernel reads the field's minipage in place, so no row is
+ *    touched until it has passed every conjunct; a comparison with no
+ *    kernel rebuilds the still selected rows into the scratch record and
+ *    checks them one by one. Passing rows are rebuilt straight into space
+ *    reserved by the result writer, or through the scratch record and the
+ *    copy plan if there is a projection.
+ */
+void VectorFileScan::_runPax() {
+
+  Record *scratch = this->file_state.rec;
+  char *scratch_bytes = RecordLayout::getBytes(scratch);
+
+  for( std::uint32_t p = 0; p < this->pax_file->getNumPages(); p++ ){
+    std::uint32_t n = this->pax_file->getPageRecs(p);
+    this->mask.assign(n, 1);
+    for( size_t i = 0; i < this->fields.size(); i++ ){
+      const FieldLayout &field = this->layout->getField(this->fields[i]);
+      const char *col = this->pax_file->getColumn(p, this->fields[i]);
+      if( RecordBatch::filterColumn(field, col, n, this->comps[i],
+            this->values[i], this->mask.data()) ){
+        continue;
+      }
+      for( std::uint32_t r = 0; r < n; r++ ){
+        if( !this->mask[r] ) continue;
+        this->pax_file->getRow(p, r, scratch_bytes);
+        this->mask[r] = scratch->compareFieldToValue(this->fields[i],
+            this->values[i], this->comps[i]);
+      }
+    }
+
+    for( std::uint32_t r = 0; r < n; r++ ){
+      if( !this->mask[r] ) continue;
+      if( this->result_layout == nullptr ){
+        this->pax_file->getRow(p, r, this->result_writer->reserve());
+        this->result_writer->commit();
+        continue;
+      }
+      this->pax_file->getRow(p, r, scratch_bytes);
+      char *dest = this->result_writer->reserve();
+      for( const CopyRun &run : this->copy_plan ){
+        memcpy(dest + run.dst_offset, scratch_bytes + run.src_offset,
+            run.length);
+      }
+      this->result_writer->commit();
+    }
+    this->num_column_pages++;
+  }
+}
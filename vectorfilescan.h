@@ -0,0 +1,115 @@
+#ifndef _SWATDB_VECTORFILESCAN_H_
+#define  _SWATDB_VECTORFILESCAN_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include "swatdb_types.h"
+#include "select.h"
+
+class Catalog;
+class HeapFile;
+class HeapFileScanner;
+class Record;
+class RecordLayout;
+class RecordBatch;
+class PaxFile;
+
+/**
+ * VectorFileScan is a file scan select that evaluates its conjuncts a page
+ * at a time. The records of each page are gathered into a column oriented
+ * RecordBatch, every conjunct is run over the whole batch, and the rows in
+ * the resulting selection vector are added to the result file. If the
+ * relation has an up to date columnar (PAX) copy, the conjuncts are run
+ * straight over its column minipages instead, and only the rows that pass
+ * are rebuilt.
+ */
+class VectorFileScan : public Select {
+
+  public:
+
+    /**
+     * @brief Constructor for VectorFileScan select operation.
+     *
+     * @param rel_id. File id for the relation file. 
+     * @param result_id. File id for the result file
+     * @param fields. Vector of field ids for the select operation. 
+     * @param comps. Vector of Comps for the select operation.
+     * @param values. Vector of Void * for the select operation. 
+     * @param catalog. Catalog * for SwatDB.
+     */
+    VectorFileScan(FileId rel_id, FileId result_id,
+        std::vector<FieldId> fields, std::vector<Comp> comps,
+        std::vector<void *> values, Catalog *catalog);
+
+    /**
+     * @brief Destructor for VectorFileScan. Deletes dynamic member variables.
+     */
+    ~VectorFileScan();
+
+    /**
+     * @brief Runs the vectorized filescan operation. Tuples of the relation
+     *    are read into a batch one page at a time, and each full batch is
+     *    checked against the value and comparison conditions. Every tuple
+     *    that passes them is added to the result file.
+     *
+     * @pre Valid files and parameters have been passed to the contructor.
+     * @post Result file has been populated with records that meet the
+     *    criteria of the operation.
+     */
+    void runOperation();
+
+    /**
+     * @brief Sets a columnar copy of the relation to scan instead of the
+     *    relation itself. It is only used if it holds every record of the
+     *    relation.
+     *
+     * @param pax_file. PaxFile * of the relation, nullptr for none.
+     */
+    void setPaxFile(PaxFile *pax_file);
+
+    /**
+     * @brief Returns the number of columnar pages the last run scanned, 0 if
+     *    it scanned the relation's own pages.
+     */
+    std::uint32_t getNumColumnPages();
+
+  private:
+
+    /**
+     * @brief Evaluates every conjunct over the current batch, inserts the
+     *    selected rows into the result file and empties the batch.
+     */
+    void _runBatch();
+
+    /**
+     * @brief Runs the select over every page of the columnar copy.
+     */
+    void _runPax();
+
+    /**
+     * Batch of records from the current page
+     */
+    RecordBatch *batch;
+
+    /**
+     * Columnar copy of the relation, nullptr for none
+     */
+    PaxFile *pax_file;
+
+    /**
+     * Selection mask of the current columnar page
+     */
+    std::vector<std::uint8_t> mask;
+
+    /**
+     * Number of columnar pages scanned by the last run
+     */
+    std::uint32_t num_column_pages;
+
+};
+
+#endif
@@ -0,0 +1,223 @@
+#include <string>
+#include <cstring>
+#include <vector>
+#include <fstream>
+#include <unordered_map>
+#include "swatdb_types.h"
+#include "zonemap.h"
+#include "recordlayout.h"
+#include "predicate.h"
+#include "record.h"
+#include "data.h"
+#include "heapfile.h"
+#include "heapfilescanner.h"
+
+/**
+ * @brief Constructor for an empty ZoneMap.
+ *
+ * @param schema. Schema * of the relation.
+ */
+ZoneMap::ZoneMap(Schema *schema) {
+  this->schema = schema;
+  this->layout = new RecordLayout(schema);
+  this->num_recs = 0;
+}
+
+/**
+ * @brief Destructor for ZoneMap.
+ */
+ZoneMap::~ZoneMap() {
+  delete this->layout;
+}
+
+/**
+ * @brief Builds the zone map from scratch with a scan of the relation.
+ *
+ * @param file. HeapFile * of the relation.
+ */
+void ZoneMap::build(HeapFile *file) {
+
+  this->pages.clear();
+  this->page_pos.clear();
+  this->num_recs = 0;
+
+  HeapFileScanner* scanner = new HeapFileScanner(file);
+  Record *record = new Record(this->schema);
+  const char *bytes = RecordLayout::getBytes(record);
+  while( true ){
+    RecordId rid = scanner->getNext(record);
+    if( rid == INVALID_RECORD_ID ) break;
+    this->addRecord(rid, bytes);
+  }
+  delete record->getRecordData();
+  delete record;
+  delete scanner;
+}
+
+/**
+ * @brief Adds a record to the synopsis of its page, widening the page's min
+ *    and max of every field to include it.
+ *
+ * @param rid. RecordId of the record in the relation.
+ * @param bytes. Raw bytes of the record.
+ */
+void ZoneMap::addRecord(RecordId rid, const char *bytes) {
+  this->num_recs++;
+  this->_widen(rid, bytes);
+}
+
+/**
+ * @brief Widens the synopsis of a record's page to include the record's new
+ *    values after it was updated in place. The record count does not
+ *    change.
+ *
+ * @param rid. RecordId of the record in the relation.
+ * @param bytes. Raw bytes of the updated record.
+ */
+void ZoneMap::updateRecord(RecordId rid, const char *bytes) {
+  this->_widen(rid, bytes);
+}
+
+/**
+ * @brief Counts a record as deleted. Its page's min and max are left as
+ *    they are, which still bounds the records left on it.
+ */
+void ZoneMap::removeRecord() {
+  this->num_recs--;
+}
+
+/**
+ * @brief Widens the min and max of every field of a record's page to
+ *    include the record. The first record of a page starts both min and
+ *    max out as a copy of itself.
+ *
+ * @param rid. RecordId of the record in the relation.
+ * @param bytes. Raw bytes of the record.
+ */
+void ZoneMap::_widen(RecordId rid, const char *bytes) {
+
+  std::uint32_t rsize = this->layout->getRecordSize();
+  auto found = this->page_pos.find(rid.page_id.page_num);
+  if( found == this->page_pos.end() ){
+    ZonePage page;
+    page.page_id = rid.page_id;
+    page.min.assign(bytes, bytes + rsize);
+    page.max.assign(bytes, bytes + rsize);
+    this->page_pos[rid.page_id.page_num] = this->pages.size();
+    this->pages.push_back(page);
+    return;
+  }
+
+  ZonePage &page = this->pages[found->second];
+  for( FieldId fid = 0; fid < this->layout->getNumFields(); fid++ ){
+    const FieldLayout &field = this->layout->getField(fid);
+    const char *val = bytes + field.offset;
+    if( RecordLayout::compareFieldValues(field, val,
+          &page.min[field.offset]) < 0 ){
+      memcpy(&page.min[field.offset], val, field.size);
+    }
+    if( RecordLayout::compareFieldValues(field, val,
+          &page.max[field.offset]) > 0 ){
+      memcpy(&page.max[field.offset], val, field.size);
+    }
+  }
+}
+
+/**
+ * @brief Returns the number of records added to the zone map.
+ */
+std::uint64_t ZoneMap::getNumRecs() {
+  return this->num_recs;
+}
+
+/**
+ * @brief Returns the synopses of the relation's pages.
+ */
+const std::vector<ZonePage> &ZoneMap::getPages() {
+  return this->pages;
+}
+
+/**
+ * @brief Returns the synopsis of a page.
+ *
+ * @param page_id. PageId of a page of the relation.
+ *
+ * @return ZonePage * of the page, nullptr if no record of the page was
+ *    added.
+ */
+const ZonePage *ZoneMap::findPage(PageId page_id) {
+  auto found = this->page_pos.find(page_id.page_num);
+  if( found == this->page_pos.end() ) return nullptr;
+  return &this->pages[found->second];
+}
+
+/**
+ * @brief Checks if a page may hold records that satisfy every conjunct.
+ *
+ * @param page. ZonePage of the page.
+ * @param preds. The select's compiled conjuncts.
+ *
+ * @return False if the page can be skipped, True otherwise.
+ */
+bool ZoneMap::mayMatch(const ZonePage &page,
+    const std::vector<Predicate> &preds) {
+
+  for( const Predicate &pred : preds ){
+    if( !pred.mayMatch(page.min.data(), page.max.data()) ) return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Writes the zone map to a file: the record size and count, then
+ *    for each page its PageId, min and max images.
+ *
+ * @param path. Path of the side file.
+ */
+void ZoneMap::save(std::string path) {
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  std::uint32_t rsize = this->layout->getRecordSize();
+  std::uint32_t num_pages = this->pages.size();
+  out.write((const char *)&rsize, sizeof(rsize));
+  out.write((const char *)&this->num_recs, sizeof(this->num_recs));
+  out.write((const char *)&num_pages, sizeof(num_pages));
+  for( const ZonePage &page : this->pages ){
+    out.write((const char *)&page.page_id, sizeof(page.page_id));
+    out.write(page.min.data(), rsize);
+    out.write(page.max.data(), rsize);
+  }
+}
+
+/**
+ * @brief Reads a zone map from a file written by save, replacing the
+ *    current contents.
+ *
+ * @param path. Path of the side file.
+ *
+ * @return False if the file does not exist or was written for records of a
+ *    different size, True if the zone map was loaded.
+ */
+bool ZoneMap::load(std::string path) {
+
+  std::ifstream in(path, std::ios::binary);
+  std::uint32_t rsize, num_pages;
+  if( !in.read((char *)&rsize, sizeof(rsize)) ) return false;
+  if( rsize != this->layout->getRecordSize() ) return false;
+  in.read((char *)&this->num_recs, sizeof(this->num_recs));
+  in.read((char *)&num_pages, sizeof(num_pages));
+
+  this->pages.clear();
+  this->page_pos.clear();
+  for( std::uint32_t i = 0; i < num_pages && in; i++ ){
+    ZonePage page;
+    in.read((char *)&page.page_id, sizeof(page.page_id));
+    page.min.resize(rsize);
+    page.max.resize(rsize);
+    in.read(page.min.data(), rsize);
+    in.read(page.max.data(), rsize);
+    this->page_pos[page.page_id.page_num] = this->pages.size();
+    this->pages.push_back(page);
+  }
+  return (bool)in;
+}
@@ -0,0 +1,174 @@
+#ifndef _SWATDB_ZONEMAP_H_
+#define _SWATDB_ZONEMAP_H_
+
+/**
+ * \file
+ */
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "swatdb_types.h"
+
+class Schema;
+class HeapFile;
+class RecordLayout;
+class Predicate;
+
+/**
+ * Struct for the synopsis of one page of a relation in a ZoneMap.
+ */
+struct ZonePage {
+  /**
+   * PageId of the page
+   */
+  PageId page_id;
+  /**
+   * Record images holding the smallest and largest value of every field
+   * over the records on the page
+   */
+  std::vector<char> min;
+  std::vector<char> max;
+};
+
+/**
+ * ZoneMap is a per-page min/max synopsis of a relation. It is built by
+ * adding every record of the relation with its RecordId, kept up to date as
+ * records are inserted, updated and deleted, and saved in a side file next
+ * to the relation. Only each page's min and max are kept, so a FileScan
+ * still reads the relation's page list and uses the zone map to skip the
+ * pages whose ranges can not satisfy the select's conjuncts. Updates and
+ * deletes only ever widen a page's range, so it stays a safe bound.
+ */
+class ZoneMap {
+
+  public:
+
+    /**
+     * @brief Constructor for an empty ZoneMap.
+     *
+     * @param schema. Schema * of the relation.
+     */
+    ZoneMap(Schema *schema);
+
+    /**
+     * @brief Destructor for ZoneMap.
+     */
+    ~ZoneMap();
+
+    /**
+     * @brief Builds the zone map from scratch with a scan of the relation.
+     *
+     * @param file. HeapFile * of the relation.
+     */
+    void build(HeapFile *file);
+
+    /**
+     * @brief Adds a record to the synopsis of its page, widening the page's
+     *    min and max of every field to include it.
+     *
+     * @param rid. RecordId of the record in the relation.
+     * @param bytes. Raw bytes of the record.
+     */
+    void addRecord(RecordId rid, const char *bytes);
+
+    /**
+     * @brief Widens the synopsis of a record's page to include the
+     *    record's new values after it was updated in place.
+     *
+     * @param rid. RecordId of the record in the relation.
+     * @param bytes. Raw bytes of the updated record.
+     */
+    void updateRecord(RecordId rid, const char *bytes);
+
+    /**
+     * @brief Counts a record as deleted. Its page's min and max are left
+     *    as they are, which still bounds the records left on it.
+     */
+    void removeRecord();
+
+    /**
+     * @brief Returns the number of records the zone map describes. If it
+     *    differs from the relation's record count, records were added or
+     *    removed behind the zone map's back and it is stale.
+     */
+    std::uint64_t getNumRecs();
+
+    /**
+     * @brief Returns the synopses of the relation's pages.
+     */
+    const std::vector<ZonePage> &getPages();
+
+    /**
+     * @brief Returns the synopsis of a page.
+     *
+     * @param page_id. PageId of a page of the relation.
+     *
+     * @return ZonePage * of the page, nullptr if no record of the page was
+     *    added.
+     */
+    const ZonePage *findPage(PageId page_id);
+
+    /**
+     * @brief Checks if a page may hold records that satisfy every conjunct.
+     *
+     * @param page. ZonePage of the page.
+     * @param preds. The select's compiled conjuncts.
+     *
+     * @return False if the page can be skipped, True otherwise.
+     */
+    bool mayMatch(const ZonePage &page, const std::vector<Predicate> &preds);
+
+    /**
+     * @brief Writes the zone map to a file.
+     *
+     * @param path. Path of the side file.
+     */
+    void save(std::string path);
+
+    /**
+     * @brief Reads a zone map from a file written by save.
+     *
+     * @param path. Path of the side file.
+     *
+     * @return False if the file does not exist or was written for records
+     *    of a different size, True if the zone map was loaded.
+     */
+    bool load(std::string path);
+
+  private:
+
+    /**
+     * Schema of the relation
+     */
+    Schema *schema;
+
+    /**
+     * Byte layout of the relation's records
+     */
+    RecordLayout *layout;
+
+    /**
+     * Page synopses, in the order the pages were first seen
+     */
+    std::vector<ZonePage> pages;
+
+    /**
+     * Position in pages of each page number
+     */
+    std::unordered_map<PageNum, std::uint32_t> page_pos;
+
+    /**
+     * @brief Widens the min and max of every field of a record's page to
+     *    include the record, adding the page if it is new.
+     */
+    void _widen(RecordId rid, const char *bytes);
+
+    /**
+     * Number of records described
+     */
+    std::uint64_t num_recs;
+
+};
+
+#endif